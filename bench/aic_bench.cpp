@@ -0,0 +1,514 @@
+// Benchmark for the processing hot path: Processor::process_planar, process_interleaved and
+// process_sequential.
+//
+// Sweeps sample rates, frame counts (the model's optimal count and others), channel counts and
+// allow_variable_frames, and reports the duration of each process call (mean, p50, p99, max)
+// together with the real-time factor: mean call duration divided by the audio duration of one
+// block. An RTF of 0.1 means a block of audio takes a tenth of its playback time to process.
+//
+// Usage: aic-bench <model_path> [--rates LIST] [--frames LIST] [--channels LIST]
+//                  [--variable LIST] [--iterations N] [--warmup N] [--cpu N]
+//                  [--format table|csv|json] [--output FILE]
+//
+// Lists are comma separated. --rates accepts "opt" for the model's optimal sample rate and
+// --frames accepts "opt" for the model's optimal frame count at each rate; --variable takes
+// 0 and 1. The license key is read from the AIC_SDK_LICENSE environment variable.
+//
+// --cpu pins the benchmark thread to one core (Linux and Windows) so that scheduler migrations
+// do not show up in the tail percentiles. Keep --format json output of each SDK release and diff
+// the results to catch regressions before rollout.
+
+#include "aic.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+
+enum class Layout
+{
+    Planar,
+    Interleaved,
+    Sequential
+};
+
+const char* layout_name(Layout layout)
+{
+    switch (layout)
+    {
+    case Layout::Planar:
+        return "planar";
+    case Layout::Interleaved:
+        return "interleaved";
+    case Layout::Sequential:
+        return "sequential";
+    }
+    return "unknown";
+}
+
+struct Options
+{
+    std::string model_path;
+    std::string rates      = "opt,16000,48000";
+    std::string frames     = "opt,128,1024";
+    std::string channels   = "1,2";
+    std::string variable   = "0,1";
+    int         iterations = 2000;
+    int         warmup     = 200;
+    int         cpu        = -1;
+    std::string format     = "table";
+    std::string output;
+};
+
+struct Row
+{
+    Layout   layout;
+    uint32_t sample_rate;
+    uint16_t num_channels;
+    size_t   num_frames;
+    bool     optimal_frames;
+    bool     variable_frames;
+    size_t   output_delay;
+    double   mean_ns;
+    double   p50_ns;
+    double   p99_ns;
+    double   max_ns;
+    double   rtf;
+};
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream        stream(list);
+    std::string              item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+bool pin_to_cpu(int cpu)
+{
+#if defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8))
+    {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    // macOS only offers affinity hints, which would not give repeatable numbers.
+    (void) cpu;
+    return false;
+#endif
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Times every call separately. The input is restored before each call, outside the timed
+// region, so every call sees the same signal rather than the output of the previous one.
+aic::ErrorCode measure(aic::Processor& processor, Layout layout, const std::vector<float>& source,
+                       uint16_t num_channels, size_t num_frames, const Options& options,
+                       std::vector<double>& durations)
+{
+    typedef std::chrono::steady_clock clock;
+
+    std::vector<float>  buffer(source.size());
+    std::vector<float*> planar(num_channels);
+    for (uint16_t ch = 0; ch < num_channels; ++ch)
+    {
+        planar[ch] = buffer.data() + ch * num_frames;
+    }
+
+    durations.clear();
+    const int calls = options.warmup + options.iterations;
+    for (int i = 0; i < calls; ++i)
+    {
+        std::copy(source.begin(), source.end(), buffer.begin());
+
+        aic::ErrorCode          rc    = aic::ErrorCode::Success;
+        const clock::time_point start = clock::now();
+        switch (layout)
+        {
+        case Layout::Planar:
+            rc = processor.process_planar(planar.data(), num_channels, num_frames);
+            break;
+        case Layout::Interleaved:
+            rc = processor.process_interleaved(buffer.data(), num_channels, num_frames);
+            break;
+        case Layout::Sequential:
+            rc = processor.process_sequential(buffer.data(), num_channels, num_frames);
+            break;
+        }
+        const clock::time_point end = clock::now();
+
+        if (rc != aic::ErrorCode::Success)
+        {
+            return rc;
+        }
+        if (i >= options.warmup)
+        {
+            durations.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+    }
+    return aic::ErrorCode::Success;
+}
+
+void write_table(std::ostream& out, const std::vector<Row>& rows)
+{
+    out << std::left << std::setw(13) << "layout" << std::setw(8) << "rate" << std::setw(4)
+        << "ch" << std::setw(11) << "frames" << std::setw(5) << "var" << std::right
+        << std::setw(8) << "delay" << std::setw(12) << "mean us" << std::setw(12) << "p50 us"
+        << std::setw(12) << "p99 us" << std::setw(12) << "max us" << std::setw(9) << "rtf"
+        << "\n";
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const Row&  row = rows[i];
+        std::string frames =
+            std::to_string(row.num_frames) + (row.optimal_frames ? " (opt)" : "");
+        out << std::left << std::setw(13) << layout_name(row.layout) << std::setw(8)
+            << row.sample_rate << std::setw(4) << row.num_channels << std::setw(11) << frames
+            << std::setw(5) << (row.variable_frames ? "on" : "off") << std::right << std::fixed
+            << std::setw(8) << row.output_delay << std::setprecision(2) << std::setw(12)
+            << row.mean_ns / 1000.0 << std::setw(12) << row.p50_ns / 1000.0 << std::setw(12)
+            << row.p99_ns / 1000.0 << std::setw(12) << row.max_ns / 1000.0
+            << std::setprecision(4) << std::setw(9) << row.rtf << "\n";
+    }
+}
+
+void write_csv(std::ostream& out, const std::vector<Row>& rows)
+{
+    out << "layout,sample_rate,num_channels,num_frames,optimal_frames,variable_frames,"
+           "output_delay,mean_ns,p50_ns,p99_ns,max_ns,rtf\n";
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const Row& row = rows[i];
+        out << layout_name(row.layout) << "," << row.sample_rate << "," << row.num_channels
+            << "," << row.num_frames << "," << row.optimal_frames << "," << row.variable_frames
+            << "," << row.output_delay << "," << std::fixed << std::setprecision(1)
+            << row.mean_ns << "," << row.p50_ns << "," << row.p99_ns << "," << row.max_ns << ","
+            << std::setprecision(6) << row.rtf << "\n";
+    }
+}
+
+// Model ids and version strings are plain identifiers, so quotes are the only escaping needed.
+std::string json_string(const std::string& value)
+{
+    std::string escaped = "\"";
+    for (size_t i = 0; i < value.size(); ++i)
+    {
+        if (value[i] == '"' || value[i] == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += value[i];
+    }
+    return escaped + "\"";
+}
+
+void write_json(std::ostream& out, const std::vector<Row>& rows, const std::string& model_id,
+                const Options& options)
+{
+    out << "{\n"
+        << "  \"sdk_version\": " << json_string(aic::get_sdk_version()) << ",\n"
+        << "  \"model_id\": " << json_string(model_id) << ",\n"
+        << "  \"iterations\": " << options.iterations << ",\n"
+        << "  \"warmup\": " << options.warmup << ",\n"
+        << "  \"cpu\": " << options.cpu << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const Row& row = rows[i];
+        out << "    {\"layout\": \"" << layout_name(row.layout)
+            << "\", \"sample_rate\": " << row.sample_rate
+            << ", \"num_channels\": " << row.num_channels
+            << ", \"num_frames\": " << row.num_frames
+            << ", \"optimal_frames\": " << (row.optimal_frames ? "true" : "false")
+            << ", \"variable_frames\": " << (row.variable_frames ? "true" : "false")
+            << ", \"output_delay\": " << row.output_delay << std::fixed << std::setprecision(1)
+            << ", \"mean_ns\": " << row.mean_ns << ", \"p50_ns\": " << row.p50_ns
+            << ", \"p99_ns\": " << row.p99_ns << ", \"max_ns\": " << row.max_ns
+            << std::setprecision(6) << ", \"rtf\": " << row.rtf << "}"
+            << (i + 1 < rows.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-bench <model_path> [--rates LIST] [--frames LIST] [--channels LIST]\n"
+                 "                 [--variable LIST] [--iterations N] [--warmup N] [--cpu N]\n"
+                 "                 [--format table|csv|json] [--output FILE]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--rates" && i + 1 < argc)
+        {
+            options.rates = argv[++i];
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.frames = argv[++i];
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.channels = argv[++i];
+        }
+        else if (arg == "--variable" && i + 1 < argc)
+        {
+            options.variable = argv[++i];
+        }
+        else if (arg == "--iterations" && i + 1 < argc)
+        {
+            options.iterations = std::atoi(argv[++i]);
+        }
+        else if (arg == "--warmup" && i + 1 < argc)
+        {
+            options.warmup = std::atoi(argv[++i]);
+        }
+        else if (arg == "--cpu" && i + 1 < argc)
+        {
+            options.cpu = std::atoi(argv[++i]);
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            options.format = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            options.output = argv[++i];
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (options.model_path.empty() || options.iterations <= 0 || options.warmup < 0 ||
+        (options.format != "table" && options.format != "csv" && options.format != "json"))
+    {
+        return usage();
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    if (options.cpu >= 0 && !pin_to_cpu(options.cpu))
+    {
+        std::cerr << "Could not pin to CPU " << options.cpu << ", running unpinned\n";
+        options.cpu = -1;
+    }
+
+    auto model_result = aic::Model::create_from_file(options.model_path);
+    if (!model_result.ok())
+    {
+        std::cerr << "Model loading failed with error code: "
+                  << static_cast<int>(model_result.error) << "\n";
+        return 1;
+    }
+    aic::Model model = model_result.take();
+
+    auto processor_result = aic::Processor::create(model, license);
+    if (!processor_result.ok())
+    {
+        std::cerr << "Processor creation failed with error code: "
+                  << static_cast<int>(processor_result.error) << "\n";
+        return 1;
+    }
+    aic::Processor processor = processor_result.take();
+
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        std::cerr << "Context creation failed with error code: "
+                  << static_cast<int>(context_result.error) << "\n";
+        return 1;
+    }
+    aic::ProcessorContext context = context_result.take();
+
+    std::vector<uint32_t> rates;
+    for (const std::string& item : split(options.rates))
+    {
+        uint32_t rate = item == "opt"
+                            ? model.get_optimal_sample_rate()
+                            : static_cast<uint32_t>(std::strtoul(item.c_str(), nullptr, 10));
+        if (std::find(rates.begin(), rates.end(), rate) == rates.end())
+        {
+            rates.push_back(rate);
+        }
+    }
+
+    const Layout        layouts[] = {Layout::Planar, Layout::Interleaved, Layout::Sequential};
+    std::vector<Row>    rows;
+    std::vector<double> durations;
+
+    for (uint32_t sample_rate : rates)
+    {
+        const size_t optimal = model.get_optimal_num_frames(sample_rate);
+
+        std::vector<size_t> frame_counts;
+        for (const std::string& item : split(options.frames))
+        {
+            size_t frames = item == "opt" ? optimal : std::strtoull(item.c_str(), nullptr, 10);
+            if (std::find(frame_counts.begin(), frame_counts.end(), frames) == frame_counts.end())
+            {
+                frame_counts.push_back(frames);
+            }
+        }
+
+        for (size_t num_frames : frame_counts)
+        {
+            for (const std::string& channel_item : split(options.channels))
+            {
+                const uint16_t num_channels =
+                    static_cast<uint16_t>(std::atoi(channel_item.c_str()));
+
+                // Deterministic noise at about -20 dBFS.
+                std::vector<float> source(num_frames * num_channels);
+                uint32_t           seed = 1;
+                for (size_t i = 0; i < source.size(); ++i)
+                {
+                    seed      = seed * 1664525u + 1013904223u;
+                    source[i] = (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.2f;
+                }
+
+                for (const std::string& variable_item : split(options.variable))
+                {
+                    const bool variable_frames = variable_item != "0";
+
+                    aic::ErrorCode rc = processor.initialize(sample_rate, num_channels,
+                                                             num_frames, variable_frames);
+                    if (rc != aic::ErrorCode::Success)
+                    {
+                        std::cerr << "Skipping " << sample_rate << " Hz, " << num_channels
+                                  << " ch, " << num_frames << " frames: initialize failed with "
+                                  << "error code: " << static_cast<int>(rc) << "\n";
+                        continue;
+                    }
+
+                    for (Layout layout : layouts)
+                    {
+                        rc = measure(processor, layout, source, num_channels, num_frames,
+                                     options, durations);
+                        if (rc != aic::ErrorCode::Success)
+                        {
+                            std::cerr << "Skipping " << layout_name(layout)
+                                      << ": processing failed with error code: "
+                                      << static_cast<int>(rc) << "\n";
+                            continue;
+                        }
+                        context.reset();
+
+                        std::sort(durations.begin(), durations.end());
+                        double total = 0.0;
+                        for (double ns : durations)
+                        {
+                            total += ns;
+                        }
+
+                        const double block_ns = 1e9 * static_cast<double>(num_frames) /
+                                                static_cast<double>(sample_rate);
+
+                        Row row;
+                        row.layout          = layout;
+                        row.sample_rate     = sample_rate;
+                        row.num_channels    = num_channels;
+                        row.num_frames      = num_frames;
+                        row.optimal_frames  = num_frames == optimal;
+                        row.variable_frames = variable_frames;
+                        row.output_delay    = context.get_output_delay();
+                        row.mean_ns         = total / static_cast<double>(durations.size());
+                        row.p50_ns          = percentile(durations, 0.50);
+                        row.p99_ns          = percentile(durations, 0.99);
+                        row.max_ns          = durations.back();
+                        row.rtf             = row.mean_ns / block_ns;
+                        rows.push_back(row);
+                    }
+                }
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!options.output.empty())
+    {
+        file.open(options.output.c_str());
+        if (!file)
+        {
+            std::cerr << "Cannot write " << options.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    if (options.format == "json")
+    {
+        write_json(out, rows, model.get_id(), options);
+    }
+    else if (options.format == "csv")
+    {
+        write_csv(out, rows);
+    }
+    else
+    {
+        out << "SDK " << aic::get_sdk_version() << ", model " << model.get_id() << ", "
+            << options.iterations << " calls after " << options.warmup << " warm-up calls"
+            << (options.cpu >= 0 ? ", pinned to CPU " + std::to_string(options.cpu) : "")
+            << "\n";
+        write_table(out, rows);
+    }
+    return 0;
+}
@@ -0,0 +1,387 @@
+// Chunked processing benchmark: how much faster is aic::process_chunked than one continuous
+// pass, and how far does its output drift from that pass at the chunk seams?
+//
+// A synthetic recording (--seconds long, tones with a slow amplitude envelope over low-level
+// noise) is enhanced once in a single continuous pass, which is the reference, and then with
+// process_chunked for every combination of thread count, chunk length and warm-up overlap. Each
+// row reports the wall time, the speedup over the reference, and the difference to the
+// reference around the seams: the largest absolute sample difference and the ratio of reference
+// power to difference power (in dB) within --seam-ms of every chunk boundary. Chunk interiors
+// match the reference once the warm-up covers the model's memory, so "seam_snr_db" rising with the
+// overlap shows how much warm-up the model needs.
+//
+// Usage: aic-bench-chunked <model_path> [--threads LIST] [--chunk-seconds LIST]
+//                          [--overlap-seconds LIST] [--crossfade-ms MS] [--seam-ms MS]
+//                          [--seconds S] [--rate HZ] [--channels N] [--format table|json]
+//
+// Lists are comma separated; --threads accepts "max" for std::thread::hardware_concurrency and
+// --rate accepts "opt" for the model's optimal sample rate. The license key is read from the
+// AIC_SDK_LICENSE environment variable.
+
+#include "aic.hpp"
+#include "aic_chunked.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Options
+{
+    std::string model_path;
+    std::string threads         = "1,2,4,max";
+    std::string chunk_seconds   = "30";
+    std::string overlap_seconds = "0,0.5,1,2";
+    double      crossfade_ms    = 10.0;
+    double      seam_ms         = 50.0;
+    double      seconds         = 600.0;
+    std::string rate            = "opt";
+    uint16_t    channels        = 1;
+    std::string format          = "table";
+};
+
+struct Row
+{
+    size_t threads;
+    double chunk_seconds;
+    double overlap_seconds;
+    double wall_s;
+    double speedup;
+    double seam_max_abs;
+    double seam_snr_db;
+};
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream        stream(list);
+    std::string              item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Deterministic test signal: a few tones whose loudness changes every few hundred
+// milliseconds, over noise, so the model has both speech-like energy and pauses to react to.
+std::vector<float> make_signal(uint32_t sample_rate, uint16_t channels, uint64_t frames)
+{
+    std::vector<float> audio(static_cast<size_t>(frames) * channels);
+    uint64_t           seed = 0x9E3779B97F4A7C15ull;
+    const double       pi   = 3.14159265358979323846;
+    for (uint64_t i = 0; i < frames; ++i)
+    {
+        const double t        = static_cast<double>(i) / sample_rate;
+        const double envelope = 0.5 + 0.5 * std::sin(2.0 * pi * 1.7 * t) * std::sin(pi * 0.3 * t);
+        const double tones    = 0.2 * std::sin(2.0 * pi * 220.0 * t) +
+                             0.1 * std::sin(2.0 * pi * 660.0 * t) +
+                             0.05 * std::sin(2.0 * pi * 1870.0 * t);
+        for (uint16_t c = 0; c < channels; ++c)
+        {
+            seed               = seed * 6364136223846793005ull + 1442695040888963407ull;
+            const double noise = (static_cast<double>(seed >> 40) / 16777216.0 - 0.5) * 0.05;
+            audio[static_cast<size_t>(i) * channels + c] =
+                static_cast<float>(envelope * tones + noise);
+        }
+    }
+    return audio;
+}
+
+// Runs process_chunked from and to memory and returns the wall time in seconds, or a negative
+// value after printing the error.
+double run(const aic::Model& model, const std::string& license, const aic::ChunkedConfig& config,
+           const std::vector<float>& input, std::vector<float>& output)
+{
+    const size_t channels = config.num_channels;
+    size_t       written  = 0;
+    output.assign(input.size(), 0.0f);
+
+    auto source = [&input, channels](uint64_t first_frame, float* audio, size_t frames)
+    {
+        std::memcpy(audio, input.data() + first_frame * channels,
+                    frames * channels * sizeof(float));
+        return aic::ErrorCode::Success;
+    };
+    auto sink = [&output, &written, channels](const float* audio, size_t frames)
+    {
+        std::memcpy(output.data() + written * channels, audio, frames * channels * sizeof(float));
+        written += frames;
+        return aic::ErrorCode::Success;
+    };
+
+    auto           start = std::chrono::steady_clock::now();
+    aic::ErrorCode err   = aic::process_chunked(model, license, config, source, sink);
+    auto           end   = std::chrono::steady_clock::now();
+    if (err != aic::ErrorCode::Success)
+    {
+        std::cerr << "Chunked processing failed with error code: " << static_cast<int>(err)
+                  << "\n";
+        return -1.0;
+    }
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Compares the output to the reference within `window` frames on both sides of every seam.
+void compare_seams(const std::vector<float>& reference, const std::vector<float>& output,
+                   uint16_t channels, uint64_t total_frames, size_t chunk_frames, size_t window,
+                   Row& row)
+{
+    double max_abs   = 0.0;
+    double ref_power = 0.0;
+    double err_power = 0.0;
+    for (uint64_t seam = chunk_frames; seam < total_frames; seam += chunk_frames)
+    {
+        const uint64_t first = seam > window ? seam - window : 0;
+        const uint64_t last  = std::min<uint64_t>(seam + window, total_frames);
+        for (size_t i = static_cast<size_t>(first * channels);
+             i < static_cast<size_t>(last * channels); ++i)
+        {
+            const double diff = static_cast<double>(output[i]) - reference[i];
+            max_abs           = std::max(max_abs, std::fabs(diff));
+            ref_power += static_cast<double>(reference[i]) * reference[i];
+            err_power += diff * diff;
+        }
+    }
+    row.seam_max_abs = max_abs;
+    // Bit-identical seams (or a single chunk) are reported as infinity
+    row.seam_snr_db = err_power > 0.0 ? 10.0 * std::log10(ref_power / err_power) : INFINITY;
+}
+
+std::string format_snr(double snr_db)
+{
+    std::ostringstream text;
+    if (std::isinf(snr_db))
+    {
+        text << "exact";
+    }
+    else
+    {
+        text << std::fixed << std::setprecision(1) << snr_db;
+    }
+    return text.str();
+}
+
+void print_table(const std::vector<Row>& rows, double reference_s, double audio_s)
+{
+    std::cout << "Reference: one continuous pass, " << std::fixed << std::setprecision(3)
+              << reference_s << " s for " << std::setprecision(1) << audio_s << " s of audio\n";
+    std::cout << std::right << std::setw(8) << "threads" << std::setw(10) << "chunk_s"
+              << std::setw(11) << "overlap_s" << std::setw(10) << "wall_s" << std::setw(10)
+              << "speedup" << std::setw(14) << "seam_max_abs" << std::setw(14) << "seam_snr_db"
+              << "\n";
+    for (const Row& row : rows)
+    {
+        std::cout << std::setw(8) << row.threads << std::fixed << std::setprecision(1)
+                  << std::setw(10) << row.chunk_seconds << std::setprecision(2) << std::setw(11)
+                  << row.overlap_seconds << std::setprecision(3) << std::setw(10) << row.wall_s
+                  << std::setprecision(2) << std::setw(10) << row.speedup << std::scientific
+                  << std::setprecision(2) << std::setw(14) << row.seam_max_abs << std::setw(14)
+                  << format_snr(row.seam_snr_db) << std::fixed << "\n";
+    }
+}
+
+void print_json(const std::vector<Row>& rows, const Options& options,
+                const aic::ChunkedConfig& config, double reference_s)
+{
+    std::cout << "{\n"
+              << "  \"sdk_version\": \"" << aic::get_sdk_version() << "\",\n"
+              << "  \"seconds\": " << options.seconds << ",\n"
+              << "  \"sample_rate\": " << config.sample_rate << ",\n"
+              << "  \"num_channels\": " << config.num_channels << ",\n"
+              << "  \"crossfade_ms\": " << options.crossfade_ms << ",\n"
+              << "  \"seam_ms\": " << options.seam_ms << ",\n"
+              << "  \"reference_s\": " << reference_s << ",\n"
+              << "  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const Row& row = rows[i];
+        std::cout << "    {\"threads\": " << row.threads
+                  << ", \"chunk_seconds\": " << row.chunk_seconds
+                  << ", \"overlap_seconds\": " << row.overlap_seconds
+                  << ", \"wall_s\": " << row.wall_s << ", \"speedup\": " << row.speedup
+                  << ", \"seam_max_abs\": " << row.seam_max_abs << ", \"seam_snr_db\": ";
+        if (std::isinf(row.seam_snr_db))
+        {
+            std::cout << "null";
+        }
+        else
+        {
+            std::cout << row.seam_snr_db;
+        }
+        std::cout << "}" << (i + 1 < rows.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-bench-chunked <model_path> [--threads LIST] [--chunk-seconds LIST]\n"
+                 "                         [--overlap-seconds LIST] [--crossfade-ms MS] "
+                 "[--seam-ms MS]\n"
+                 "                         [--seconds S] [--rate HZ] [--channels N] "
+                 "[--format table|json]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            options.threads = argv[++i];
+        }
+        else if (arg == "--chunk-seconds" && i + 1 < argc)
+        {
+            options.chunk_seconds = argv[++i];
+        }
+        else if (arg == "--overlap-seconds" && i + 1 < argc)
+        {
+            options.overlap_seconds = argv[++i];
+        }
+        else if (arg == "--crossfade-ms" && i + 1 < argc)
+        {
+            options.crossfade_ms = std::atof(argv[++i]);
+        }
+        else if (arg == "--seam-ms" && i + 1 < argc)
+        {
+            options.seam_ms = std::atof(argv[++i]);
+        }
+        else if (arg == "--seconds" && i + 1 < argc)
+        {
+            options.seconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--rate" && i + 1 < argc)
+        {
+            options.rate = argv[++i];
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.channels = static_cast<uint16_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            options.format = argv[++i];
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (options.model_path.empty() || options.seconds <= 0.0 || options.channels == 0 ||
+        options.crossfade_ms < 0.0 || options.seam_ms < 0.0 ||
+        (options.format != "table" && options.format != "json"))
+    {
+        return usage();
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    auto model_result = aic::Model::create_from_file(options.model_path);
+    if (!model_result.ok())
+    {
+        std::cerr << "Model loading failed with error code: "
+                  << static_cast<int>(model_result.error) << "\n";
+        return 1;
+    }
+    aic::Model model = model_result.take();
+
+    const uint32_t sample_rate =
+        options.rate == "opt"
+            ? model.get_optimal_sample_rate()
+            : static_cast<uint32_t>(std::strtoul(options.rate.c_str(), nullptr, 10));
+    const uint64_t     total_frames = static_cast<uint64_t>(options.seconds * sample_rate);
+    const std::string  key          = license;
+    std::vector<float> input        = make_signal(sample_rate, options.channels, total_frames);
+
+    // A single chunk on one thread is exactly one continuous pass.
+    aic::ChunkedConfig reference_config(sample_rate, options.channels, total_frames);
+    reference_config.chunk_frames     = static_cast<size_t>(total_frames);
+    reference_config.crossfade_frames = 0;
+    reference_config.num_threads      = 1;
+
+    std::vector<float> reference;
+    const double       reference_s = run(model, key, reference_config, input, reference);
+    if (reference_s < 0.0)
+    {
+        return 1;
+    }
+
+    const size_t       window = static_cast<size_t>(options.seam_ms * sample_rate / 1000.0);
+    std::vector<Row>   rows;
+    std::vector<float> output;
+    for (const std::string& threads_item : split(options.threads))
+    {
+        const size_t threads =
+            threads_item == "max"
+                ? std::max<size_t>(1, std::thread::hardware_concurrency())
+                : static_cast<size_t>(std::strtoull(threads_item.c_str(), nullptr, 10));
+        for (const std::string& chunk_item : split(options.chunk_seconds))
+        {
+            for (const std::string& overlap_item : split(options.overlap_seconds))
+            {
+                Row row             = {};
+                row.threads         = std::max<size_t>(1, threads);
+                row.chunk_seconds   = std::atof(chunk_item.c_str());
+                row.overlap_seconds = std::atof(overlap_item.c_str());
+
+                aic::ChunkedConfig config(sample_rate, options.channels, total_frames);
+                config.chunk_frames     = std::max<size_t>(
+                    1, static_cast<size_t>(row.chunk_seconds * sample_rate));
+                config.overlap_frames   = static_cast<size_t>(row.overlap_seconds * sample_rate);
+                config.crossfade_frames = std::min(
+                    config.chunk_frames,
+                    static_cast<size_t>(options.crossfade_ms * sample_rate / 1000.0));
+                config.num_threads      = row.threads;
+
+                row.wall_s = run(model, key, config, input, output);
+                if (row.wall_s < 0.0)
+                {
+                    return 1;
+                }
+                row.speedup = reference_s / std::max(row.wall_s, 1e-9);
+                compare_seams(reference, output, options.channels, total_frames,
+                              config.chunk_frames, window, row);
+                rows.push_back(row);
+            }
+        }
+    }
+
+    if (options.format == "json")
+    {
+        print_json(rows, options, reference_config, reference_s);
+    }
+    else
+    {
+        print_table(rows, reference_s, options.seconds);
+    }
+    return 0;
+}
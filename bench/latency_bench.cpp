@@ -0,0 +1,181 @@
+// Overhead of the latency instrumentation in aic_latency.hpp.
+//
+// Measures the pieces InstrumentedProcessor adds to every process call: two steady_clock reads
+// and one LatencyHistogram::record. With a model path the benchmark also times
+// Processor::process_planar with and without the wrapper at the model's optimal configuration.
+// snapshot() is timed as well, since control threads call it periodically.
+//
+// Usage: aic-bench-latency [model_path] [--iterations N]
+//
+// The license key for the processor comparison is read from the AIC_SDK_LICENSE environment
+// variable.
+
+#include "aic_latency.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+template <typename Fn> double measure_ns(Fn fn, int iterations)
+{
+    // Warm up caches and the branch predictor.
+    for (int i = 0; i < 100; ++i)
+    {
+        fn();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+void print(const char* name, double ns)
+{
+    std::cout << std::left << std::setw(40) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << ns << " ns\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string model_path;
+    int         iterations = 1000000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = std::atoi(argv[++i]);
+        }
+        else if (arg[0] != '-' && model_path.empty())
+        {
+            model_path = arg;
+        }
+        else
+        {
+            std::cerr << "Usage: aic-bench-latency [model_path] [--iterations N]\n";
+            return 1;
+        }
+    }
+    if (iterations <= 0)
+    {
+        std::cerr << "Usage: aic-bench-latency [model_path] [--iterations N]\n";
+        return 1;
+    }
+
+    aic::LatencyHistogram histogram;
+    volatile int64_t      sink = 0;
+    uint64_t              seed = 1;
+
+    print("steady_clock::now() x2", measure_ns(
+                                         [&]()
+                                         {
+                                             auto a = std::chrono::steady_clock::now();
+                                             auto b = std::chrono::steady_clock::now();
+                                             sink   = sink + (b - a).count();
+                                         },
+                                         iterations));
+
+    // Spread the values over many buckets, like real call durations.
+    print("LatencyHistogram::record", measure_ns(
+                                          [&]()
+                                          {
+                                              seed = seed * 6364136223846793005ull + 1;
+                                              histogram.record(20000 + (seed >> 50));
+                                          },
+                                          iterations));
+
+    print("clock x2 + record", measure_ns(
+                                   [&]()
+                                   {
+                                       auto a = std::chrono::steady_clock::now();
+                                       auto b = std::chrono::steady_clock::now();
+                                       histogram.record(static_cast<uint64_t>(
+                                           std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               b - a)
+                                               .count()));
+                                   },
+                                   iterations));
+
+    print("LatencyHistogram::snapshot", measure_ns(
+                                            [&]()
+                                            {
+                                                aic::LatencySnapshot s = histogram.snapshot();
+                                                sink = sink + static_cast<int64_t>(s.count);
+                                            },
+                                            iterations / 100 + 1));
+
+    if (model_path.empty())
+    {
+        return 0;
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    auto model_result = aic::Model::create_from_file(model_path);
+    if (!model_result.ok())
+    {
+        std::cerr << "Model loading failed with error code: "
+                  << static_cast<int>(model_result.error) << "\n";
+        return 1;
+    }
+    aic::Model model = model_result.take();
+
+    auto processor_result = aic::Processor::create(model, license);
+    if (!processor_result.ok())
+    {
+        std::cerr << "Processor creation failed with error code: "
+                  << static_cast<int>(processor_result.error) << "\n";
+        return 1;
+    }
+    aic::Processor processor = processor_result.take();
+
+    const uint32_t sample_rate = model.get_optimal_sample_rate();
+    const size_t   num_frames  = model.get_optimal_num_frames(sample_rate);
+    if (processor.initialize(sample_rate, 1, num_frames, false) != aic::ErrorCode::Success)
+    {
+        std::cerr << "Processor initialization failed\n";
+        return 1;
+    }
+
+    std::vector<float>         audio(num_frames, 0.0f);
+    float*                     planar[] = {audio.data()};
+    aic::InstrumentedProcessor instrumented(processor);
+
+    // Model inference dominates, so fewer calls suffice; alternate to cancel drift.
+    const int calls      = iterations / 1000 + 100;
+    double    bare_ns    = 0.0;
+    double    wrapped_ns = 0.0;
+    for (int round = 0; round < 5; ++round)
+    {
+        bare_ns += measure_ns([&]() { processor.process_planar(planar, 1, num_frames); }, calls);
+        wrapped_ns +=
+            measure_ns([&]() { instrumented.process_planar(planar, 1, num_frames); }, calls);
+    }
+    print("Processor::process_planar", bare_ns / 5);
+    print("InstrumentedProcessor::process_planar", wrapped_ns / 5);
+
+    aic::LatencySnapshot snapshot = instrumented.snapshot();
+    std::cout << "p50 " << snapshot.get_percentile(0.5) << " ns, p99 "
+              << snapshot.get_percentile(0.99) << " ns, p99.9 " << snapshot.get_percentile(0.999)
+              << " ns over " << snapshot.count << " calls\n";
+    return 0;
+}
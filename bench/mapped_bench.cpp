@@ -0,0 +1,503 @@
+// Memory-mapped file benchmark: how much faster is aic::process_mapped_file than enhancing the
+// same file through WavReader and WavWriter (buffered read() and write() calls)?
+//
+// A synthetic 32-bit float WAV file of --size-gib GiB (tones over low-level noise; beyond 4 GiB
+// it is written as RF64) is created in --dir and enhanced --runs times by each path:
+//
+//   stdio   WavReader::read_interleaved, Processor::process_interleaved in blocks of the optimal
+//           frame count, WavWriter::write_interleaved
+//   mapped  MappedAudioFile::open_wav and process_mapped_file
+//
+// Both paths drop the output delay and produce bit-identical files, which is checked after the
+// last run. Every run starts with the input evicted from the page cache (Linux, posix_fadvise)
+// unless --warm is given; with --sync the output is flushed to disk (fsync) inside the measured
+// time. The table reports the median and fastest wall time, the throughput in MiB of input per
+// second and the real-time factor of the median run. The files are deleted at the end unless
+// --keep is given.
+//
+// Usage: aic-bench-mapped <model_path> [--size-gib G] [--dir PATH] [--runs N] [--rate HZ]
+//                         [--channels N] [--warm] [--sync] [--keep] [--format table|json]
+//
+// --rate accepts "opt" for the model's optimal sample rate. The license key is read from the
+// AIC_SDK_LICENSE environment variable.
+
+#include "aic.hpp"
+#include "aic_mapped_audio.hpp"
+#include "aic_wav.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options
+{
+    std::string model_path;
+    double      size_gib = 4.0;
+    std::string dir      = ".";
+    int         runs     = 3;
+    std::string rate     = "opt";
+    uint16_t    channels = 1;
+    bool        warm     = false;
+    bool        sync     = false;
+    bool        keep     = false;
+    std::string format   = "table";
+};
+
+struct Row
+{
+    std::string path;
+    double      median_s;
+    double      min_s;
+    double      mib_per_s;
+    double      rtf;
+};
+
+// Drops the file from the page cache. Only clean pages no other process maps are dropped.
+bool evict_from_page_cache(const std::string& path)
+{
+#if defined(__linux__)
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool evicted = fdatasync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return evicted;
+#else
+    (void) path;
+    return false;
+#endif
+}
+
+// Writes the file's dirty pages to disk.
+bool sync_file(const std::string& path)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    bool synced = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return synced;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+
+double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Writes the synthetic input file one second at a time.
+aic::ErrorCode write_input(const std::string& path, const aic::WavFormat& format,
+                           uint64_t total_frames)
+{
+    auto writer_result = aic::WavWriter::create(path, format);
+    if (!writer_result.ok())
+    {
+        return writer_result.error;
+    }
+    aic::WavWriter writer = writer_result.take();
+
+    const size_t       block    = format.sample_rate;
+    const uint16_t     channels = format.num_channels;
+    const double       pi       = 3.14159265358979323846;
+    uint64_t           seed     = 0x9E3779B97F4A7C15ull;
+    std::vector<float> audio(block * channels);
+    for (uint64_t first = 0; first < total_frames; first += block)
+    {
+        const size_t frames = static_cast<size_t>(std::min<uint64_t>(block, total_frames - first));
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const double t     = static_cast<double>(first + i) / format.sample_rate;
+            const double tones = 0.2 * std::sin(2.0 * pi * 220.0 * t) +
+                                 0.1 * std::sin(2.0 * pi * 660.0 * t);
+            for (uint16_t c = 0; c < channels; ++c)
+            {
+                seed               = seed * 6364136223846793005ull + 1442695040888963407ull;
+                const double noise = (static_cast<double>(seed >> 40) / 16777216.0 - 0.5) * 0.05;
+                audio[i * channels + c] = static_cast<float>(tones + noise);
+            }
+        }
+        aic::ErrorCode err = writer.write_interleaved(audio.data(), frames);
+        if (err != aic::ErrorCode::Success)
+        {
+            return err;
+        }
+    }
+    return writer.finish();
+}
+
+// Enhances the file through WavReader and WavWriter, one second of audio per read and write.
+aic::ErrorCode run_stdio(aic::Processor& processor, const aic::ProcessorContext& context,
+                         const std::string& input_path, const std::string& output_path)
+{
+    auto reader_result = aic::WavReader::create(input_path);
+    if (!reader_result.ok())
+    {
+        return reader_result.error;
+    }
+    aic::WavReader reader        = reader_result.take();
+    auto           writer_result = aic::WavWriter::create(output_path, reader.get_format());
+    if (!writer_result.ok())
+    {
+        return writer_result.error;
+    }
+    aic::WavWriter writer = writer_result.take();
+
+    const uint16_t channels     = reader.get_format().num_channels;
+    const size_t   num_frames   = processor.get_config().num_frames;
+    const size_t   chunk_frames = (reader.get_format().sample_rate + num_frames - 1) /
+                                num_frames * num_frames;
+    const uint64_t total        = reader.get_num_frames();
+    uint64_t       to_skip      = context.get_output_delay();
+
+    std::vector<float> buffer(chunk_frames * channels);
+
+    aic::ErrorCode err = context.reset();
+    while (err == aic::ErrorCode::Success && writer.get_num_frames() < total)
+    {
+        auto read = reader.read_interleaved(buffer.data(), chunk_frames);
+        if (!read.ok())
+        {
+            return read.error;
+        }
+        std::fill(buffer.begin() + read.value * channels, buffer.end(), 0.0f);
+        for (size_t offset = 0; offset < chunk_frames && err == aic::ErrorCode::Success;
+             offset += num_frames)
+        {
+            err = processor.process_interleaved(buffer.data() + offset * channels, channels,
+                                                num_frames);
+        }
+        const size_t skipped = static_cast<size_t>(std::min<uint64_t>(to_skip, chunk_frames));
+        const size_t count   = static_cast<size_t>(
+            std::min<uint64_t>(chunk_frames - skipped, total - writer.get_num_frames()));
+        to_skip -= skipped;
+        if (err == aic::ErrorCode::Success)
+        {
+            err = writer.write_interleaved(buffer.data() + skipped * channels, count);
+        }
+    }
+    if (err == aic::ErrorCode::Success)
+    {
+        err = writer.finish();
+    }
+    return err;
+}
+
+aic::ErrorCode run_mapped(aic::Processor& processor, const aic::ProcessorContext& context,
+                          const std::string& input_path, const std::string& output_path)
+{
+    auto input = aic::MappedAudioFile::open_wav(input_path);
+    if (!input.ok())
+    {
+        return input.error;
+    }
+    return aic::process_mapped_file(processor, context, input.value, output_path);
+}
+
+bool files_equal(const std::string& a, const std::string& b)
+{
+    std::FILE* file_a = std::fopen(a.c_str(), "rb");
+    std::FILE* file_b = std::fopen(b.c_str(), "rb");
+    bool       equal  = file_a && file_b;
+
+    std::vector<char> buffer_a(1 << 20);
+    std::vector<char> buffer_b(1 << 20);
+    while (equal)
+    {
+        const size_t read_a = std::fread(buffer_a.data(), 1, buffer_a.size(), file_a);
+        const size_t read_b = std::fread(buffer_b.data(), 1, buffer_b.size(), file_b);
+        equal = read_a == read_b && std::memcmp(buffer_a.data(), buffer_b.data(), read_a) == 0;
+        if (read_a == 0)
+        {
+            break;
+        }
+    }
+    if (file_a)
+    {
+        std::fclose(file_a);
+    }
+    if (file_b)
+    {
+        std::fclose(file_b);
+    }
+    return equal;
+}
+
+void print_table(const std::vector<Row>& rows, double gib, double audio_s, bool identical)
+{
+    std::cout << "Input: " << std::fixed << std::setprecision(2) << gib << " GiB, "
+              << std::setprecision(1) << audio_s << " s of audio; outputs "
+              << (identical ? "identical" : "DIFFER") << "\n";
+    std::cout << std::left << std::setw(8) << "path" << std::right << std::setw(12)
+              << "median_s" << std::setw(10) << "min_s" << std::setw(12) << "MiB/s"
+              << std::setw(10) << "rtf"
+              << "\n";
+    for (const Row& row : rows)
+    {
+        std::cout << std::left << std::setw(8) << row.path << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(12) << row.median_s << std::setw(10)
+                  << row.min_s << std::setprecision(1) << std::setw(12) << row.mib_per_s
+                  << std::setprecision(4) << std::setw(10) << row.rtf << "\n";
+    }
+}
+
+void print_json(const std::vector<Row>& rows, const Options& options, uint32_t sample_rate,
+                double gib, double audio_s, bool identical)
+{
+    std::cout << "{\n"
+              << "  \"sdk_version\": \"" << aic::get_sdk_version() << "\",\n"
+              << "  \"size_gib\": " << gib << ",\n"
+              << "  \"audio_seconds\": " << audio_s << ",\n"
+              << "  \"sample_rate\": " << sample_rate << ",\n"
+              << "  \"num_channels\": " << options.channels << ",\n"
+              << "  \"runs\": " << options.runs << ",\n"
+              << "  \"cold\": " << (options.warm ? "false" : "true") << ",\n"
+              << "  \"sync\": " << (options.sync ? "true" : "false") << ",\n"
+              << "  \"identical\": " << (identical ? "true" : "false") << ",\n"
+              << "  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const Row& row = rows[i];
+        std::cout << "    {\"path\": \"" << row.path << "\", \"median_s\": " << row.median_s
+                  << ", \"min_s\": " << row.min_s << ", \"mib_per_s\": " << row.mib_per_s
+                  << ", \"rtf\": " << row.rtf << "}" << (i + 1 < rows.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-bench-mapped <model_path> [--size-gib G] [--dir PATH] [--runs N] "
+                 "[--rate HZ]\n"
+                 "                        [--channels N] [--warm] [--sync] [--keep] "
+                 "[--format table|json]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--size-gib" && i + 1 < argc)
+        {
+            options.size_gib = std::atof(argv[++i]);
+        }
+        else if (arg == "--dir" && i + 1 < argc)
+        {
+            options.dir = argv[++i];
+        }
+        else if (arg == "--runs" && i + 1 < argc)
+        {
+            options.runs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--rate" && i + 1 < argc)
+        {
+            options.rate = argv[++i];
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.channels = static_cast<uint16_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--warm")
+        {
+            options.warm = true;
+        }
+        else if (arg == "--sync")
+        {
+            options.sync = true;
+        }
+        else if (arg == "--keep")
+        {
+            options.keep = true;
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            options.format = argv[++i];
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (options.model_path.empty() || options.size_gib <= 0.0 || options.runs < 1 ||
+        options.channels == 0 || (options.format != "table" && options.format != "json"))
+    {
+        return usage();
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    auto model_result = aic::Model::create_from_file(options.model_path);
+    if (!model_result.ok())
+    {
+        std::cerr << "Model loading failed with error code: "
+                  << static_cast<int>(model_result.error) << "\n";
+        return 1;
+    }
+    aic::Model model = model_result.take();
+
+    const uint32_t sample_rate =
+        options.rate == "opt"
+            ? model.get_optimal_sample_rate()
+            : static_cast<uint32_t>(std::strtoul(options.rate.c_str(), nullptr, 10));
+    const size_t num_frames = model.get_optimal_num_frames(sample_rate);
+
+    auto processor_result = aic::Processor::create(model, license);
+    if (!processor_result.ok())
+    {
+        std::cerr << "Processor creation failed with error code: "
+                  << static_cast<int>(processor_result.error) << "\n";
+        return 1;
+    }
+    aic::Processor processor = processor_result.take();
+
+    aic::ErrorCode err = processor.initialize(sample_rate, options.channels, num_frames, false);
+    if (err != aic::ErrorCode::Success)
+    {
+        std::cerr << "Processor initialization failed with error code: "
+                  << static_cast<int>(err) << "\n";
+        return 1;
+    }
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        std::cerr << "Context creation failed with error code: "
+                  << static_cast<int>(context_result.error) << "\n";
+        return 1;
+    }
+    aic::ProcessorContext context = context_result.take();
+
+    const aic::WavFormat format       = {sample_rate, options.channels,
+                                         aic::SampleFormat::Float32};
+    const double         bytes        = options.size_gib * 1024.0 * 1024.0 * 1024.0;
+    const uint64_t       total_frames = static_cast<uint64_t>(bytes / (options.channels * 4.0));
+    const double         audio_s      = static_cast<double>(total_frames) / sample_rate;
+    const double         mib          = static_cast<double>(total_frames) * options.channels *
+                           sizeof(float) / (1024.0 * 1024.0);
+
+    const std::string input_path  = options.dir + "/aic-bench-mapped-input.wav";
+    const std::string stdio_path  = options.dir + "/aic-bench-mapped-stdio.wav";
+    const std::string mapped_path = options.dir + "/aic-bench-mapped-mapped.wav";
+    err                           = write_input(input_path, format, total_frames);
+    if (err != aic::ErrorCode::Success)
+    {
+        std::cerr << "Writing " << input_path << " failed with error code: "
+                  << static_cast<int>(err) << "\n";
+        return 1;
+    }
+
+    typedef aic::ErrorCode (*RunFunction)(aic::Processor&, const aic::ProcessorContext&,
+                                          const std::string&, const std::string&);
+    const char*        names[]   = {"stdio", "mapped"};
+    const RunFunction  runners[] = {run_stdio, run_mapped};
+    const std::string* outputs[] = {&stdio_path, &mapped_path};
+
+    std::vector<Row> rows;
+    for (size_t p = 0; p < 2 && err == aic::ErrorCode::Success; ++p)
+    {
+        std::vector<double> times;
+        for (int run = 0; run < options.runs && err == aic::ErrorCode::Success; ++run)
+        {
+            if (!options.warm)
+            {
+                evict_from_page_cache(input_path);
+            }
+            const Clock::time_point start = Clock::now();
+            err = runners[p](processor, context, input_path, *outputs[p]);
+            if (err == aic::ErrorCode::Success && options.sync && !sync_file(*outputs[p]))
+            {
+                err = aic::ErrorCode::FileSystemError;
+            }
+            times.push_back(seconds_since(start));
+        }
+        if (err != aic::ErrorCode::Success)
+        {
+            std::cerr << "The " << names[p] << " path failed with error code: "
+                      << static_cast<int>(err) << "\n";
+            break;
+        }
+        std::sort(times.begin(), times.end());
+        Row row       = {};
+        row.path      = names[p];
+        row.median_s  = times[times.size() / 2];
+        row.min_s     = times.front();
+        row.mib_per_s = mib / std::max(row.median_s, 1e-9);
+        row.rtf       = row.median_s / audio_s;
+        rows.push_back(row);
+    }
+
+    const bool identical = err == aic::ErrorCode::Success && files_equal(stdio_path, mapped_path);
+    if (!options.keep)
+    {
+        std::remove(input_path.c_str());
+        std::remove(stdio_path.c_str());
+        std::remove(mapped_path.c_str());
+    }
+    if (err != aic::ErrorCode::Success)
+    {
+        return 1;
+    }
+
+    if (options.format == "json")
+    {
+        print_json(rows, options, sample_rate, mib / 1024.0, audio_s, identical);
+    }
+    else
+    {
+        print_table(rows, mib / 1024.0, audio_s, identical);
+    }
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+// Microbenchmark for the PCM conversion kernels in aic_pcm.hpp.
+//
+// Measures interleaved PCM -> planar float (deinterleave_to_float) and planar float ->
+// interleaved PCM (interleave_from_float) for every sample format, channel layout and SIMD
+// level available on this CPU. Throughput is reported in PCM bytes per cycle and GB/s.
+//
+// Usage: aic-bench-pcm [--frames N] [--iterations N] [--ghz F]
+//
+// On x86-64 cycles are read from the time-stamp counter (reference cycles). On other
+// architectures pass --ghz with the core clock to convert nanoseconds to cycles.
+
+#include "aic_pcm.hpp"
+#include "aic_simd.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define AIC_BENCH_HAS_TSC 1
+#else
+#define AIC_BENCH_HAS_TSC 0
+#endif
+
+namespace
+{
+
+struct Measurement
+{
+    double ns;
+    double cycles;
+};
+
+template <typename Fn> Measurement measure(Fn fn, int iterations)
+{
+    // Warm up caches and the branch predictor.
+    for (int i = 0; i < 3; ++i)
+    {
+        fn();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+#if AIC_BENCH_HAS_TSC
+    uint64_t tsc_start = __rdtsc();
+#endif
+    for (int i = 0; i < iterations; ++i)
+    {
+        fn();
+    }
+#if AIC_BENCH_HAS_TSC
+    uint64_t tsc_end = __rdtsc();
+#endif
+    auto end = std::chrono::steady_clock::now();
+
+    Measurement m;
+    m.ns     = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    m.cycles = 0.0;
+#if AIC_BENCH_HAS_TSC
+    m.cycles = static_cast<double>(tsc_end - tsc_start) / iterations;
+#endif
+    return m;
+}
+
+const char* format_name(aic::SampleFormat format)
+{
+    switch (format)
+    {
+    case aic::SampleFormat::Int16:
+        return "int16";
+    case aic::SampleFormat::Int24:
+        return "int24";
+    case aic::SampleFormat::Int32:
+        return "int32";
+    case aic::SampleFormat::Float32:
+        return "float32";
+    case aic::SampleFormat::Float64:
+        return "float64";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t num_frames = 4800;
+    int    iterations = 2000;
+    double ghz        = 0.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc)
+        {
+            num_frames = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = std::atoi(argv[++i]);
+        }
+        else if (arg == "--ghz" && i + 1 < argc)
+        {
+            ghz = std::atof(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Usage: aic-bench-pcm [--frames N] [--iterations N] [--ghz F]\n";
+            return 1;
+        }
+    }
+
+    const aic::SampleFormat formats[] = {aic::SampleFormat::Int16, aic::SampleFormat::Int24,
+                                         aic::SampleFormat::Int32, aic::SampleFormat::Float32,
+                                         aic::SampleFormat::Float64};
+    const uint16_t          channel_counts[] = {1, 2, 6};
+
+    std::vector<aic::SimdLevel> levels;
+    levels.push_back(aic::SimdLevel::Scalar);
+    const aic::SimdLevel candidates[] = {aic::SimdLevel::Sse2, aic::SimdLevel::Avx2,
+                                         aic::SimdLevel::Avx512, aic::SimdLevel::Neon};
+    for (aic::SimdLevel level : candidates)
+    {
+        if (aic::set_simd_level(level) == level)
+        {
+            levels.push_back(level);
+        }
+    }
+
+    std::cout << "frames per call: " << num_frames << ", iterations: " << iterations << "\n";
+#if AIC_BENCH_HAS_TSC
+    std::cout << "cycles: time-stamp counter\n";
+#else
+    if (ghz <= 0.0)
+    {
+        std::cout << "cycles: not available, pass --ghz to convert from nanoseconds\n";
+    }
+#endif
+    std::cout << std::left << std::setw(9) << "format" << std::setw(5) << "ch" << std::setw(8)
+              << "simd" << std::setw(13) << "direction" << std::right << std::setw(12)
+              << "bytes/cycle" << std::setw(10) << "GB/s" << "\n";
+
+    for (aic::SampleFormat format : formats)
+    {
+        for (uint16_t num_channels : channel_counts)
+        {
+            size_t samples = num_frames * num_channels;
+            size_t bytes   = samples * aic::get_sample_size(format);
+
+            std::vector<float> source(samples);
+            for (size_t i = 0; i < samples; ++i)
+            {
+                source[i] = static_cast<float>((i * 7919) % 2001) / 1000.0f - 1.0f;
+            }
+            std::vector<float*>       planar(num_channels);
+            std::vector<const float*> planar_const(num_channels);
+            for (uint16_t ch = 0; ch < num_channels; ++ch)
+            {
+                planar[ch]       = source.data() + ch * num_frames;
+                planar_const[ch] = planar[ch];
+            }
+            std::vector<uint8_t> pcm(bytes);
+            aic::interleave_from_float(planar_const.data(), pcm.data(), format, num_channels,
+                                       num_frames);
+
+            for (aic::SimdLevel level : levels)
+            {
+                aic::set_simd_level(level);
+
+                Measurement in = measure(
+                    [&]()
+                    {
+                        aic::deinterleave_to_float(pcm.data(), format, planar.data(),
+                                                   num_channels, num_frames);
+                    },
+                    iterations);
+                Measurement out = measure(
+                    [&]()
+                    {
+                        aic::interleave_from_float(planar_const.data(), pcm.data(), format,
+                                                   num_channels, num_frames);
+                    },
+                    iterations);
+
+                const Measurement results[]    = {in, out};
+                const char*       directions[] = {"to-planar", "from-planar"};
+                for (int d = 0; d < 2; ++d)
+                {
+                    double cycles =
+                        results[d].cycles > 0.0 ? results[d].cycles : results[d].ns * ghz;
+                    std::cout << std::left << std::setw(9) << format_name(format) << std::setw(5)
+                              << num_channels << std::setw(8) << aic::get_simd_level_name(level)
+                              << std::setw(13) << directions[d] << std::right << std::fixed
+                              << std::setprecision(2) << std::setw(12)
+                              << (cycles > 0.0 ? bytes / cycles : 0.0) << std::setw(10)
+                              << bytes / results[d].ns << "\n";
+                }
+            }
+        }
+    }
+
+    aic::set_simd_level(aic::get_supported_simd_level());
+    return 0;
+}
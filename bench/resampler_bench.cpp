@@ -0,0 +1,117 @@
+// Benchmark for PolyphaseResampler.
+//
+// Streams white noise through the resampler for every common host/model rate pair and SIMD
+// level, and reports the cost of resampling one second of one channel.
+//
+// Usage: aic-bench-resampler [--seconds N] [--block N]
+
+#include "aic_resampler.hpp"
+#include "aic_simd.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    double seconds = 10.0;
+    size_t block   = 480;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc)
+        {
+            seconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--block" && i + 1 < argc)
+        {
+            block = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "Usage: aic-bench-resampler [--seconds N] [--block N]\n";
+            return 1;
+        }
+    }
+
+    const uint32_t pairs[][2] = {{8000, 16000},  {16000, 8000},  {44100, 16000},
+                                 {16000, 44100}, {48000, 16000}, {16000, 48000}};
+
+    std::vector<aic::SimdLevel> levels;
+    levels.push_back(aic::SimdLevel::Scalar);
+    const aic::SimdLevel candidates[] = {aic::SimdLevel::Sse2, aic::SimdLevel::Avx2,
+                                         aic::SimdLevel::Avx512, aic::SimdLevel::Neon};
+    for (aic::SimdLevel level : candidates)
+    {
+        if (aic::set_simd_level(level) == level)
+        {
+            levels.push_back(level);
+        }
+    }
+
+    std::mt19937                          rng(42);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    std::vector<float>                    input(block);
+    for (float& sample : input)
+    {
+        sample = noise(rng);
+    }
+
+    std::cout << "block: " << block << " input frames, audio per run: " << seconds << " s\n";
+    std::cout << std::left << std::setw(8) << "in" << std::setw(8) << "out" << std::setw(8)
+              << "simd" << std::right << std::setw(14)
+              << "us/ch-second" << std::setw(12) << "x realtime" << "\n";
+
+    for (const auto& pair : pairs)
+    {
+        for (aic::SimdLevel level : levels)
+        {
+            aic::set_simd_level(level);
+
+            auto result = aic::PolyphaseResampler::create(pair[0], pair[1], 1, block);
+            if (!result.ok())
+            {
+                std::cerr << "Resampler creation failed with error code: "
+                          << static_cast<int>(result.error) << "\n";
+                return 1;
+            }
+            auto resampler = result.take();
+
+            std::vector<float> output(resampler.get_max_output_frames(block));
+            const float*       in_ptr  = input.data();
+            float*             out_ptr = output.data();
+
+            size_t total_blocks = static_cast<size_t>(seconds * pair[0] / block) + 1;
+
+            // Warm-up
+            for (size_t b = 0; b < 100; ++b)
+            {
+                resampler.process(&in_ptr, 1, block, &out_ptr);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t b = 0; b < total_blocks; ++b)
+            {
+                resampler.process(&in_ptr, 1, block, &out_ptr);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            double elapsed_us  = std::chrono::duration<double, std::micro>(end - start).count();
+            double audio_s     = static_cast<double>(total_blocks * block) / pair[0];
+            double us_per_ch_s = elapsed_us / audio_s;
+            std::cout << std::left << std::setw(8) << pair[0] << std::setw(8) << pair[1]
+                      << std::setw(8) << aic::get_simd_level_name(level) << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(14) << us_per_ch_s << std::setw(12)
+                      << std::setprecision(0) << 1e6 / us_per_ch_s << "\n";
+        }
+    }
+
+    aic::set_simd_level(aic::get_supported_simd_level());
+    return 0;
+}
@@ -0,0 +1,811 @@
+// Multi-core scaling benchmark: does throughput grow linearly with one Processor per core?
+//
+// For each thread count K, K threads each create and own a Processor, pin themselves to one CPU
+// of the chosen placement and call process_interleaved back to back for a fixed wall time. The
+// benchmark reports how many real-time streams the K threads sustain together (audio seconds
+// processed per wall second), the scaling efficiency relative to the smallest thread count
+// (usually one), the spread of the per-thread real-time factor and the tail latency of all
+// calls.
+//
+// Placements order the CPUs that threads are pinned to:
+//
+//   cores   one thread per physical core, filling NUMA node 0 first (default)
+//   smt     both SMT siblings of a core before moving on, filling node 0 first
+//   spread  one thread per physical core, round-robin across NUMA nodes
+//   none    no pinning; the scheduler decides
+//
+// Comparing "cores" and "smt" at the same K shows what SMT siblings cost; comparing "cores" and
+// "spread" shows the effect of crossing NUMA nodes. --cpus pins to an explicit list instead.
+//
+// Model modes decide where the weights live:
+//
+//   shared    one Model, loaded on the main thread, used by all processors
+//   per-node  one Model per NUMA node, loaded by a thread pinned to that node so its memory is
+//             allocated there (first touch); every processor uses the copy of its node
+//   both      runs the sweep in both modes
+//
+// Topology is read from /sys on Linux. Elsewhere every logical CPU counts as its own core on a
+// single node, and pinning is only available on Windows.
+//
+// Usage: aic-bench-scaling <model_path> [--threads LIST] [--placement cores|smt|spread|none]
+//                          [--cpus LIST] [--model-mode shared|per-node|both] [--seconds S]
+//                          [--rate HZ] [--frames N] [--channels N] [--format table|json]
+//
+// --threads is comma separated and accepts "max" for all CPUs of the placement; --cpus accepts
+// ranges ("0-3,8"). The license key is read from the AIC_SDK_LICENSE environment variable.
+
+#include "aic.hpp"
+#include "aic_latency.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+
+struct Options
+{
+    std::string model_path;
+    std::string threads      = "1,2,4,max";
+    std::string placement    = "cores";
+    std::string cpus;
+    std::string model_mode   = "shared";
+    double      seconds      = 5.0;
+    uint32_t    sample_rate  = 0;
+    size_t      num_frames   = 0;
+    uint16_t    num_channels = 1;
+    std::string format       = "table";
+};
+
+struct Cpu
+{
+    int cpu;
+    int node;
+    // Package and core id combined; SMT siblings share it.
+    int core;
+};
+
+struct Topology
+{
+    std::vector<Cpu> cpus;
+    int              num_nodes;
+    int              num_cores;
+};
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream        stream(list);
+    std::string              item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Parses a kernel CPU list such as "0-3,8,10-11".
+std::vector<int> parse_cpu_list(const std::string& list)
+{
+    std::vector<int> cpus;
+    for (const std::string& item : split(list))
+    {
+        size_t dash  = item.find('-');
+        int    first = std::atoi(item.substr(0, dash).c_str());
+        int    last  = dash == std::string::npos ? first : std::atoi(item.substr(dash + 1).c_str());
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+#if defined(__linux__)
+int read_int(const std::string& path, int fallback)
+{
+    std::ifstream file(path.c_str());
+    int           value = fallback;
+    file >> value;
+    return file ? value : fallback;
+}
+
+std::string read_line(const std::string& path)
+{
+    std::ifstream file(path.c_str());
+    std::string   line;
+    std::getline(file, line);
+    return line;
+}
+#endif
+
+Topology detect_topology()
+{
+    Topology topology;
+    topology.num_nodes = 1;
+
+#if defined(__linux__)
+    const std::string sys = "/sys/devices/system/";
+    std::map<int, int> node_of_cpu;
+    if (DIR* dir = opendir((sys + "node").c_str()))
+    {
+        while (dirent* entry = readdir(dir))
+        {
+            const std::string name = entry->d_name;
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos)
+            {
+                continue;
+            }
+            const int node = std::atoi(name.c_str() + 4);
+            for (int cpu : parse_cpu_list(read_line(sys + "node/" + name + "/cpulist")))
+            {
+                node_of_cpu[cpu] = node;
+            }
+            topology.num_nodes = std::max(topology.num_nodes, node + 1);
+        }
+        closedir(dir);
+    }
+
+    // Only CPUs this process may run on, so containers with a CPU quota see their own set.
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool have_allowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    for (int cpu : parse_cpu_list(read_line(sys + "cpu/online")))
+    {
+        if (have_allowed && cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowed))
+        {
+            continue;
+        }
+        const std::string dir     = sys + "cpu/cpu" + std::to_string(cpu) + "/topology/";
+        const int         package = read_int(dir + "physical_package_id", 0);
+        const int         core    = read_int(dir + "core_id", cpu);
+        Cpu               entry;
+        entry.cpu  = cpu;
+        entry.node = node_of_cpu.count(cpu) ? node_of_cpu[cpu] : 0;
+        entry.core = (package << 16) | core;
+        topology.cpus.push_back(entry);
+    }
+#endif
+
+    if (topology.cpus.empty())
+    {
+        const int count = std::max(1u, std::thread::hardware_concurrency());
+        for (int cpu = 0; cpu < count; ++cpu)
+        {
+            Cpu entry;
+            entry.cpu  = cpu;
+            entry.node = 0;
+            entry.core = cpu;
+            topology.cpus.push_back(entry);
+        }
+    }
+
+    std::set<int> cores;
+    for (const Cpu& cpu : topology.cpus)
+    {
+        cores.insert(cpu.core);
+    }
+    topology.num_cores = static_cast<int>(cores.size());
+    return topology;
+}
+
+// CPUs in the order threads are pinned to them for the given placement.
+std::vector<Cpu> order_cpus(const Topology& topology, const std::string& placement)
+{
+    // Groups the CPUs by node, then by core, keeping sibling order.
+    std::map<int, std::map<int, std::vector<Cpu>>> nodes;
+    for (const Cpu& cpu : topology.cpus)
+    {
+        nodes[cpu.node][cpu.core].push_back(cpu);
+    }
+
+    std::vector<Cpu> ordered;
+    if (placement == "cores" || placement == "smt")
+    {
+        for (const auto& node : nodes)
+        {
+            for (const auto& core : node.second)
+            {
+                const size_t count = placement == "smt" ? core.second.size() : 1;
+                ordered.insert(ordered.end(), core.second.begin(), core.second.begin() + count);
+            }
+        }
+    }
+    else if (placement == "spread")
+    {
+        std::vector<std::vector<Cpu>> per_node;
+        for (const auto& node : nodes)
+        {
+            per_node.push_back(std::vector<Cpu>());
+            for (const auto& core : node.second)
+            {
+                per_node.back().push_back(core.second.front());
+            }
+        }
+        for (size_t i = 0; ordered.size() < static_cast<size_t>(topology.num_cores); ++i)
+        {
+            for (const std::vector<Cpu>& node : per_node)
+            {
+                if (i < node.size())
+                {
+                    ordered.push_back(node[i]);
+                }
+            }
+        }
+    }
+    else
+    {
+        // Unpinned: one slot per logical CPU, cpu -1 means no affinity.
+        for (const Cpu& cpu : topology.cpus)
+        {
+            Cpu slot  = cpu;
+            slot.cpu  = -1;
+            slot.node = 0;
+            ordered.push_back(slot);
+        }
+    }
+    return ordered;
+}
+
+bool pin_to_cpu(int cpu)
+{
+#if defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8))
+    {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    // macOS only offers affinity hints.
+    (void) cpu;
+    return false;
+#endif
+}
+
+uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+struct Config
+{
+    uint32_t sample_rate;
+    size_t   num_frames;
+    uint16_t num_channels;
+};
+
+// State shared by the main thread and the workers of one run.
+struct Run
+{
+    std::atomic<int>  ready;
+    std::atomic<bool> start;
+    std::atomic<bool> stop;
+
+    Run()
+        : ready(0)
+        , start(false)
+        , stop(false)
+    {}
+};
+
+struct Worker
+{
+    Cpu                                    cpu;
+    const aic::Model*                      model;
+    bool                                   pinned;
+    int                                    error;
+    uint64_t                               blocks;
+    uint64_t                               busy_ns;
+    uint64_t                               active_ns;
+    std::unique_ptr<aic::LatencyHistogram> histogram;
+};
+
+void run_worker(Worker& worker, Run& run, const Config& config, const std::string& license)
+{
+    worker.pinned = worker.cpu.cpu < 0 || pin_to_cpu(worker.cpu.cpu);
+
+    // Created after pinning so the processor's memory is allocated on the worker's node.
+    auto processor_result = aic::Processor::create(*worker.model, license);
+    aic::ErrorCode rc     = processor_result.error;
+    std::unique_ptr<aic::Processor> processor;
+    if (processor_result.ok())
+    {
+        processor.reset(new aic::Processor(processor_result.take()));
+        rc = processor->initialize(config.sample_rate, config.num_channels, config.num_frames,
+                                   false);
+    }
+
+    // Deterministic noise at about -20 dBFS.
+    std::vector<float> audio(config.num_frames * config.num_channels);
+    uint32_t           seed = static_cast<uint32_t>(worker.cpu.cpu) + 1;
+    for (size_t i = 0; i < audio.size(); ++i)
+    {
+        seed     = seed * 1664525u + 1013904223u;
+        audio[i] = (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.2f;
+    }
+    for (int i = 0; i < 20 && rc == aic::ErrorCode::Success; ++i)
+    {
+        rc = processor->process_interleaved(audio.data(), config.num_channels, config.num_frames);
+    }
+    worker.error = static_cast<int>(rc);
+
+    run.ready.fetch_add(1, std::memory_order_acq_rel);
+    while (!run.start.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+    if (rc != aic::ErrorCode::Success)
+    {
+        return;
+    }
+
+    const uint64_t begin = now_ns();
+    while (!run.stop.load(std::memory_order_relaxed))
+    {
+        const uint64_t t0 = now_ns();
+        rc = processor->process_interleaved(audio.data(), config.num_channels, config.num_frames);
+        const uint64_t t1 = now_ns();
+        if (rc != aic::ErrorCode::Success)
+        {
+            worker.error = static_cast<int>(rc);
+            break;
+        }
+        worker.histogram->record(t1 - t0);
+        worker.busy_ns += t1 - t0;
+        ++worker.blocks;
+    }
+    worker.active_ns = now_ns() - begin;
+}
+
+struct Row
+{
+    std::string model_mode;
+    size_t      threads;
+    int         nodes_used;
+    int         cores_used;
+    bool        pinned;
+    double      streams;
+    double      efficiency;
+    double      rtf_mean;
+    double      rtf_min;
+    double      rtf_max;
+    double      p50_us;
+    double      p99_us;
+    double      p999_us;
+    double      max_us;
+};
+
+// Loads one model copy per NUMA node, each from a thread pinned to that node.
+bool load_per_node(const Options& options, const std::vector<Cpu>& cpus, int num_nodes,
+                   std::vector<std::unique_ptr<aic::Model>>& models)
+{
+    models.clear();
+    models.resize(num_nodes);
+    for (int node = 0; node < num_nodes; ++node)
+    {
+        int cpu = -1;
+        for (const Cpu& entry : cpus)
+        {
+            if (entry.node == node)
+            {
+                cpu = entry.cpu;
+                break;
+            }
+        }
+        if (cpu < 0 && node > 0)
+        {
+            continue;
+        }
+
+        int         error = 0;
+        std::thread loader(
+            [&]
+            {
+                if (cpu >= 0)
+                {
+                    pin_to_cpu(cpu);
+                }
+                auto result = aic::Model::create_from_file(options.model_path);
+                error       = static_cast<int>(result.error);
+                if (result.ok())
+                {
+                    models[node].reset(new aic::Model(result.take()));
+                }
+            });
+        loader.join();
+        if (error != 0)
+        {
+            std::cerr << "Model loading on node " << node
+                      << " failed with error code: " << error << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool run_threads(const std::vector<Cpu>& cpus, size_t count, const Options& options,
+                 const Config& config, const std::string& license, const aic::Model& shared,
+                 const std::vector<std::unique_ptr<aic::Model>>& per_node, Row& row)
+{
+    Run                 run;
+    std::vector<Worker> workers(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        Worker& worker = workers[i];
+        worker.cpu     = cpus[i];
+        worker.model   = &shared;
+        if (!per_node.empty() && per_node[worker.cpu.node])
+        {
+            worker.model = per_node[worker.cpu.node].get();
+        }
+        worker.pinned    = false;
+        worker.error     = 0;
+        worker.blocks    = 0;
+        worker.busy_ns   = 0;
+        worker.active_ns = 0;
+        worker.histogram.reset(new aic::LatencyHistogram());
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count; ++i)
+    {
+        threads.push_back(std::thread(run_worker, std::ref(workers[i]), std::ref(run),
+                                      std::cref(config), std::cref(license)));
+    }
+    while (run.ready.load(std::memory_order_acquire) < static_cast<int>(count))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    run.start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    run.stop.store(true, std::memory_order_relaxed);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const double block_s =
+        static_cast<double>(config.num_frames) / static_cast<double>(config.sample_rate);
+
+    aic::LatencySnapshot latencies;
+    std::set<int>        nodes;
+    std::set<int>        cores;
+    row.threads  = count;
+    row.pinned   = true;
+    row.streams  = 0.0;
+    row.rtf_mean = 0.0;
+    row.rtf_min  = 1e300;
+    row.rtf_max  = 0.0;
+    for (const Worker& worker : workers)
+    {
+        if (worker.error != 0)
+        {
+            std::cerr << "Worker on CPU " << worker.cpu.cpu
+                      << " failed with error code: " << worker.error << "\n";
+            return false;
+        }
+        const double audio_s  = static_cast<double>(worker.blocks) * block_s;
+        const double busy_s   = static_cast<double>(worker.busy_ns) / 1e9;
+        const double active_s = static_cast<double>(worker.active_ns) / 1e9;
+        const double rtf      = audio_s > 0.0 ? busy_s / audio_s : 0.0;
+        row.streams += active_s > 0.0 ? audio_s / active_s : 0.0;
+        row.rtf_mean += rtf / static_cast<double>(count);
+        row.rtf_min = std::min(row.rtf_min, rtf);
+        row.rtf_max = std::max(row.rtf_max, rtf);
+        row.pinned  = row.pinned && worker.pinned;
+        latencies.merge(worker.histogram->snapshot());
+        nodes.insert(worker.cpu.node);
+        cores.insert(worker.cpu.core);
+    }
+    row.nodes_used = static_cast<int>(nodes.size());
+    row.cores_used = static_cast<int>(cores.size());
+    row.p50_us     = static_cast<double>(latencies.get_percentile(0.5)) / 1e3;
+    row.p99_us     = static_cast<double>(latencies.get_percentile(0.99)) / 1e3;
+    row.p999_us    = static_cast<double>(latencies.get_percentile(0.999)) / 1e3;
+    row.max_us     = static_cast<double>(latencies.max_ns) / 1e3;
+    return true;
+}
+
+void print_table(const std::vector<Row>& rows)
+{
+    std::cout << std::left << std::setw(10) << "model" << std::right << std::setw(8)
+              << "threads" << std::setw(7) << "cores" << std::setw(7) << "nodes" << std::setw(10)
+              << "streams" << std::setw(8) << "eff" << std::setw(9) << "rtf" << std::setw(9)
+              << "rtf min" << std::setw(9) << "rtf max" << std::setw(10) << "p50 us"
+              << std::setw(10) << "p99 us" << std::setw(10) << "p999 us" << std::setw(10)
+              << "max us" << "\n";
+    for (const Row& row : rows)
+    {
+        std::cout << std::left << std::setw(10) << row.model_mode << std::right << std::setw(8)
+                  << row.threads << std::setw(7) << row.cores_used << std::setw(7)
+                  << row.nodes_used << std::fixed << std::setprecision(1) << std::setw(10)
+                  << row.streams << std::setprecision(2) << std::setw(8) << row.efficiency
+                  << std::setprecision(4) << std::setw(9) << row.rtf_mean << std::setw(9)
+                  << row.rtf_min << std::setw(9) << row.rtf_max << std::setprecision(1)
+                  << std::setw(10) << row.p50_us << std::setw(10) << row.p99_us << std::setw(10)
+                  << row.p999_us << std::setw(10) << row.max_us << "\n";
+    }
+}
+
+void print_json(const std::vector<Row>& rows, const Options& options, const Config& config,
+                const Topology& topology)
+{
+    std::cout << "{\n"
+              << "  \"sdk_version\": \"" << aic::get_sdk_version() << "\",\n"
+              << "  \"placement\": \"" << options.placement << "\",\n"
+              << "  \"seconds\": " << options.seconds << ",\n"
+              << "  \"sample_rate\": " << config.sample_rate << ",\n"
+              << "  \"num_frames\": " << config.num_frames << ",\n"
+              << "  \"num_channels\": " << config.num_channels << ",\n"
+              << "  \"topology\": {\"cpus\": " << topology.cpus.size()
+              << ", \"cores\": " << topology.num_cores << ", \"nodes\": " << topology.num_nodes
+              << "},\n"
+              << "  \"results\": [\n";
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        const Row& row = rows[i];
+        std::cout << "    {\"model_mode\": \"" << row.model_mode << "\", \"threads\": "
+                  << row.threads << ", \"cores_used\": " << row.cores_used
+                  << ", \"nodes_used\": " << row.nodes_used
+                  << ", \"pinned\": " << (row.pinned ? "true" : "false") << std::fixed
+                  << std::setprecision(3) << ", \"streams\": " << row.streams
+                  << ", \"efficiency\": " << row.efficiency << std::setprecision(5)
+                  << ", \"rtf_mean\": " << row.rtf_mean << ", \"rtf_min\": " << row.rtf_min
+                  << ", \"rtf_max\": " << row.rtf_max << std::setprecision(1)
+                  << ", \"p50_us\": " << row.p50_us << ", \"p99_us\": " << row.p99_us
+                  << ", \"p999_us\": " << row.p999_us << ", \"max_us\": " << row.max_us << "}"
+                  << (i + 1 < rows.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-bench-scaling <model_path> [--threads LIST] "
+                 "[--placement cores|smt|spread|none]\n"
+                 "                         [--cpus LIST] [--model-mode shared|per-node|both] "
+                 "[--seconds S]\n"
+                 "                         [--rate HZ] [--frames N] [--channels N] "
+                 "[--format table|json]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            options.threads = argv[++i];
+        }
+        else if (arg == "--placement" && i + 1 < argc)
+        {
+            options.placement = argv[++i];
+        }
+        else if (arg == "--cpus" && i + 1 < argc)
+        {
+            options.cpus = argv[++i];
+        }
+        else if (arg == "--model-mode" && i + 1 < argc)
+        {
+            options.model_mode = argv[++i];
+        }
+        else if (arg == "--seconds" && i + 1 < argc)
+        {
+            options.seconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--rate" && i + 1 < argc)
+        {
+            options.sample_rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.num_frames = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.num_channels = static_cast<uint16_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            options.format = argv[++i];
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    const std::string placements[] = {"cores", "smt", "spread", "none"};
+    if (options.model_path.empty() || options.seconds <= 0.0 || options.num_channels == 0 ||
+        std::find(std::begin(placements), std::end(placements), options.placement) ==
+            std::end(placements) ||
+        (options.model_mode != "shared" && options.model_mode != "per-node" &&
+         options.model_mode != "both") ||
+        (options.format != "table" && options.format != "json"))
+    {
+        return usage();
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    const Topology   topology = detect_topology();
+    std::vector<Cpu> cpus     = order_cpus(topology, options.placement);
+    if (!options.cpus.empty())
+    {
+        std::vector<Cpu> selected;
+        for (int id : parse_cpu_list(options.cpus))
+        {
+            for (const Cpu& cpu : topology.cpus)
+            {
+                if (cpu.cpu == id)
+                {
+                    selected.push_back(cpu);
+                }
+            }
+        }
+        cpus = selected;
+    }
+    if (cpus.empty())
+    {
+        std::cerr << "No usable CPUs\n";
+        return 1;
+    }
+
+    std::vector<size_t> counts;
+    for (const std::string& item : split(options.threads))
+    {
+        const size_t count =
+            item == "max" ? cpus.size() : std::strtoull(item.c_str(), nullptr, 10);
+        if (count == 0 || count > cpus.size())
+        {
+            std::cerr << "Skipping " << item << " threads: " << cpus.size()
+                      << " CPUs available for this placement\n";
+            continue;
+        }
+        if (std::find(counts.begin(), counts.end(), count) == counts.end())
+        {
+            counts.push_back(count);
+        }
+    }
+    if (counts.empty())
+    {
+        return usage();
+    }
+    std::sort(counts.begin(), counts.end());
+
+    auto model_result = aic::Model::create_from_file(options.model_path);
+    if (!model_result.ok())
+    {
+        std::cerr << "Model loading failed with error code: "
+                  << static_cast<int>(model_result.error) << "\n";
+        return 1;
+    }
+    aic::Model model = model_result.take();
+
+    Config config;
+    config.sample_rate =
+        options.sample_rate ? options.sample_rate : model.get_optimal_sample_rate();
+    config.num_frames =
+        options.num_frames ? options.num_frames : model.get_optimal_num_frames(config.sample_rate);
+    config.num_channels = options.num_channels;
+
+    if (options.format == "table")
+    {
+        std::cout << "Topology: " << topology.cpus.size() << " CPUs, " << topology.num_cores
+                  << " cores, " << topology.num_nodes << " NUMA nodes; placement "
+                  << options.placement << "; " << config.sample_rate << " Hz, "
+                  << config.num_frames << " frames, " << config.num_channels << " ch, "
+                  << options.seconds << " s per run\n\n";
+    }
+
+    std::vector<std::string> modes;
+    if (options.model_mode != "per-node")
+    {
+        modes.push_back("shared");
+    }
+    if (options.model_mode != "shared")
+    {
+        modes.push_back("per-node");
+    }
+
+    const std::string                        key = license;
+    std::vector<Row>                         rows;
+    std::vector<std::unique_ptr<aic::Model>> per_node;
+    for (const std::string& mode : modes)
+    {
+        if (mode == "per-node" && !load_per_node(options, cpus, topology.num_nodes, per_node))
+        {
+            return 1;
+        }
+
+        // Efficiency compares against linear scaling of the smallest thread count, usually 1.
+        double streams_per_thread = 0.0;
+        for (size_t count : counts)
+        {
+            Row row;
+            row.model_mode = mode;
+            if (!run_threads(cpus, count, options, config, key, model, per_node, row))
+            {
+                return 1;
+            }
+            if (count == counts.front())
+            {
+                streams_per_thread = row.streams / static_cast<double>(count);
+            }
+            const double linear = streams_per_thread * static_cast<double>(count);
+            row.efficiency      = linear > 0.0 ? row.streams / linear : 0.0;
+            rows.push_back(row);
+        }
+        per_node.clear();
+    }
+
+    if (options.format == "json")
+    {
+        print_json(rows, options, config, topology);
+    }
+    else
+    {
+        print_table(rows);
+        if (!rows.empty() && !rows.front().pinned)
+        {
+            std::cout << "\nThreads were not pinned; results include scheduler migrations.\n";
+        }
+    }
+    return 0;
+}
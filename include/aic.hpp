@@ -1,10 +1,13 @@
 #pragma once
 
 #include "aic.h"
+#include "aic_rt_check.hpp"
+#include "aic_trace.hpp"
 
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -187,7 +190,8 @@ enum class VadParameter : int
 class Model
 {
   private:
-    ::AicModel* model_;
+    ::AicModel*                 model_;
+    std::shared_ptr<const void> storage_;
 
   public:
     // Destructor: releases the underlying SDK model handle if one is owned
@@ -200,7 +204,7 @@ class Model
     }
 
     // Move constructor: the handle from the source Model gets moved into the new Model
-    Model(Model&& other) noexcept : model_(other.model_)
+    Model(Model&& other) noexcept : model_(other.model_), storage_(std::move(other.storage_))
     {
         other.model_ = nullptr;
     }
@@ -216,6 +220,7 @@ class Model
                 aic_model_destroy(model_);
             }
             model_       = other.model_;
+            storage_     = std::move(other.storage_);
             other.model_ = nullptr;
         }
         return *this;
@@ -260,6 +265,28 @@ class Model
      */
     static Result<Model> create_from_buffer(const uint8_t* buffer, size_t buffer_len);
 
+    /**
+     * Creates a new model instance from a memory-mapped model file.
+     *
+     * The file is mapped read-only instead of being read into private memory. The mapping is
+     * page-aligned, which satisfies the 64-byte alignment of create_from_buffer, and its pages
+     * live in the OS page cache, so every process that maps the same file shares one copy of
+     * the weights. The mapping stays alive as long as the model or any processor created from it.
+     *
+     * @param file_path Path to the model file.
+     * @param prefault Reads the whole file in before returning (MAP_POPULATE and MADV_WILLNEED
+     *                 where available), trading load time for no page faults on the first
+     *                 process calls.
+     * @return Result containing the Model and an ErrorCode.
+     *         ErrorCode::FileSystemError if the file cannot be opened or mapped.
+     *
+     * @note The file must not be modified or truncated while it is mapped. Replace model files
+     *       by writing a new file and renaming it over the old one.
+     * @warning Not thread-safe. Ensure no other threads are using the model handle.
+     */
+    static Result<Model> create_from_mapped_file(const std::string& file_path,
+                                                 bool               prefault = false);
+
     /**
      * Returns a pointer to the model identifier.
      *
@@ -354,11 +381,21 @@ class Model
   private:
     // Friend declaration: allows Processor to access the raw model handle for creation.
     friend class Processor;
+    // Friend declaration: allows ModelRegistry to load the mapping it has already hashed.
+    friend class ModelRegistry;
+
+    // Creates a model from `buffer`; `storage` owns the buffer and is kept alive with the model.
+    static Result<Model> create_from_storage(const uint8_t* buffer, size_t buffer_len,
+                                             std::shared_ptr<const void> storage);
 
     // Creates an empty Model wrapper for internal use when creation fails.
     Model() : model_(nullptr) {}
     // Wraps an existing SDK model handle; this instance becomes responsible for destroying it.
-    explicit Model(::AicModel* model) : model_(model) {}
+    // `storage` keeps the memory backing the model alive, if the wrapper owns it.
+    explicit Model(::AicModel* model, std::shared_ptr<const void> storage = nullptr)
+        : model_(model)
+        , storage_(std::move(storage))
+    {}
 };
 
 // ---------------------------
@@ -454,6 +491,7 @@ class ProcessorContext
      */
     ErrorCode reset() const
     {
+        AIC_RT_CHECK_SCOPE();
         ::AicErrorCode rc = aic_processor_context_reset(context_);
         return static_cast<ErrorCode>(static_cast<int>(rc));
     }
@@ -472,6 +510,7 @@ class ProcessorContext
      */
     ErrorCode set_parameter(ProcessorParameter parameter, float value) const
     {
+        AIC_RT_CHECK_SCOPE();
         ::AicErrorCode rc = aic_processor_context_set_parameter(
             context_, static_cast<::AicProcessorParameter>(static_cast<int>(parameter)), value);
         return static_cast<ErrorCode>(static_cast<int>(rc));
@@ -489,6 +528,7 @@ class ProcessorContext
      */
     float get_parameter(ProcessorParameter parameter) const
     {
+        AIC_RT_CHECK_SCOPE();
         float          value = 0.0f;
         ::AicErrorCode rc    = aic_processor_context_get_parameter(
             context_, static_cast<::AicProcessorParameter>(static_cast<int>(parameter)), &value);
@@ -517,6 +557,7 @@ class ProcessorContext
      */
     size_t get_output_delay() const
     {
+        AIC_RT_CHECK_SCOPE();
         size_t         latency = 0;
         ::AicErrorCode rc      = aic_processor_context_get_output_delay(context_, &latency);
         assert(rc == AIC_ERROR_CODE_SUCCESS);
@@ -525,8 +566,11 @@ class ProcessorContext
     }
 
   private:
-    // Friend declaration: allows Processor to construct ProcessorContext instances from raw handles
+    // Friend declarations: allow Processor to construct ProcessorContext instances from raw handles
+    // and the wrapper-level stages to hold an empty context until creation succeeds
     friend class Processor;
+    friend class StreamAdapter;
+    friend class DryWetMixer;
 
     // Constructor: creates an empty context wrapper for internal use when creation fails
     ProcessorContext() : context_(nullptr) {}
@@ -599,6 +643,7 @@ class VadContext
      */
     bool is_speech_detected() const
     {
+        AIC_RT_CHECK_SCOPE();
         bool           value = false;
         ::AicErrorCode rc    = aic_vad_context_is_speech_detected(context_, &value);
         assert(rc == AIC_ERROR_CODE_SUCCESS);
@@ -620,6 +665,7 @@ class VadContext
      */
     ErrorCode set_parameter(VadParameter parameter, float value) const
     {
+        AIC_RT_CHECK_SCOPE();
         ::AicErrorCode rc = aic_vad_context_set_parameter(
             context_, static_cast<::AicVadParameter>(static_cast<int>(parameter)), value);
         return static_cast<ErrorCode>(static_cast<int>(rc));
@@ -637,6 +683,7 @@ class VadContext
      */
     float get_parameter(VadParameter parameter) const
     {
+        AIC_RT_CHECK_SCOPE();
         float          value = 0.0f;
         ::AicErrorCode rc    = aic_vad_context_get_parameter(
             context_, static_cast<::AicVadParameter>(static_cast<int>(parameter)), &value);
@@ -663,7 +710,10 @@ class VadContext
 class Processor
 {
   private:
-    ::AicProcessor* processor_;
+    ::AicProcessor*             processor_;
+    ProcessorConfig             config_;
+    bool                        initialized_;
+    std::shared_ptr<const void> model_storage_;
 
   public:
     // Destructor: releases the underlying SDK processor handle if one is owned
@@ -676,9 +726,14 @@ class Processor
     }
 
     // Move constructor: the handle from the source Processor gets moved into the new Processor
-    Processor(Processor&& other) noexcept : processor_(other.processor_)
+    Processor(Processor&& other) noexcept
+        : processor_(other.processor_)
+        , config_(other.config_)
+        , initialized_(other.initialized_)
+        , model_storage_(std::move(other.model_storage_))
     {
-        other.processor_ = nullptr;
+        other.processor_   = nullptr;
+        other.initialized_ = false;
     }
 
     // Move assignment: replaces the currently owned handle with the source handle and clears the
@@ -691,8 +746,12 @@ class Processor
             {
                 aic_processor_destroy(processor_);
             }
-            processor_       = other.processor_;
-            other.processor_ = nullptr;
+            processor_         = other.processor_;
+            config_            = other.config_;
+            initialized_       = other.initialized_;
+            model_storage_     = std::move(other.model_storage_);
+            other.processor_   = nullptr;
+            other.initialized_ = false;
         }
         return *this;
     }
@@ -738,11 +797,42 @@ class Processor
     ErrorCode initialize(uint32_t sample_rate, uint16_t num_channels, size_t num_frames,
                          bool allow_variable_frames)
     {
+        AIC_TRACE_SCOPE("Processor::initialize");
         ::AicErrorCode rc = aic_processor_initialize(processor_, sample_rate, num_channels,
                                                      num_frames, allow_variable_frames);
+        initialized_      = rc == AIC_ERROR_CODE_SUCCESS;
+        if (initialized_)
+        {
+            config_ = ProcessorConfig(sample_rate, num_frames, num_channels, allow_variable_frames);
+        }
         return static_cast<ErrorCode>(static_cast<int>(rc));
     }
 
+    /**
+     * Returns true if the last call to Processor::initialize succeeded.
+     *
+     * @note Real-time safe but not thread-safe; do not call concurrently with initialize.
+     */
+    bool is_initialized() const
+    {
+        return initialized_;
+    }
+
+    /**
+     * Returns the configuration accepted by the last successful Processor::initialize call.
+     *
+     * Wrapper-level stages use this to size their buffers without asking the caller to repeat
+     * the audio configuration.
+     *
+     * @return The active configuration. Only meaningful while is_initialized() returns true.
+     *
+     * @note Real-time safe but not thread-safe; do not call concurrently with initialize.
+     */
+    const ProcessorConfig& get_config() const
+    {
+        return config_;
+    }
+
     /**
      * Processes audio with separate buffers for each channel (planar layout).
      *
@@ -774,6 +864,8 @@ class Processor
      */
     ErrorCode process_planar(float* const* audio, uint16_t num_channels, size_t num_frames)
     {
+        AIC_RT_CHECK_SCOPE();
+        AIC_TRACE_SCOPE("Processor::process_planar");
         ::AicErrorCode rc =
             aic_processor_process_planar(processor_, audio, num_channels, num_frames);
         return static_cast<ErrorCode>(static_cast<int>(rc));
@@ -807,6 +899,8 @@ class Processor
      */
     ErrorCode process_interleaved(float* audio, uint16_t num_channels, size_t num_frames)
     {
+        AIC_RT_CHECK_SCOPE();
+        AIC_TRACE_SCOPE("Processor::process_interleaved");
         ::AicErrorCode rc =
             aic_processor_process_interleaved(processor_, audio, num_channels, num_frames);
         return static_cast<ErrorCode>(static_cast<int>(rc));
@@ -840,11 +934,69 @@ class Processor
      */
     ErrorCode process_sequential(float* audio, uint16_t num_channels, size_t num_frames)
     {
+        AIC_RT_CHECK_SCOPE();
+        AIC_TRACE_SCOPE("Processor::process_sequential");
         ::AicErrorCode rc =
             aic_processor_process_sequential(processor_, audio, num_channels, num_frames);
         return static_cast<ErrorCode>(static_cast<int>(rc));
     }
 
+    /**
+     * Ends a stream and returns the output still held back by the output delay, interleaved.
+     *
+     * After the last process call of a stream, its final ProcessorContext::get_output_delay frames
+     * are still inside the processor. This pushes just enough silence through it to bring them
+     * out (exactly the delay with allow_variable_frames, otherwise the delay rounded up to whole
+     * blocks of the configured frame count) and writes only those frames to `tail`. Afterwards
+     * the context is reset and the processor is ready for the next stream.
+     *
+     * @param context Context of this processor.
+     * @param tail Interleaved buffer of `num_channels * max_frames` samples.
+     * @param num_channels Number of channels (must match initialization).
+     * @param max_frames Capacity of `tail` in frames; at least ProcessorContext::get_output_delay.
+     * @return Result containing the number of frames written to `tail` (the output delay) and an
+     *         ErrorCode: ErrorCode::ProcessorNotInitialized, ErrorCode::AudioConfigMismatch if
+     *         `num_channels` differs from the configuration, ErrorCode::ParameterOutOfRange if
+     *         `tail` is too small, ErrorCode::NullPointer, or the error of a process call.
+     *
+     * @warning Allocates memory and is not thread-safe. Avoid calling from real-time audio threads.
+     */
+    Result<size_t> drain_interleaved(const ProcessorContext& context, float* tail,
+                                     uint16_t num_channels, size_t max_frames);
+
+    /**
+     * Ends a stream like drain_interleaved, writing the tail to one buffer per channel.
+     *
+     * @param context Context of this processor.
+     * @param tail Array of channel buffer pointers, each holding `max_frames` samples.
+     * @param num_channels Number of channels (must match initialization).
+     * @param max_frames Capacity of each channel buffer; at least
+     *                   ProcessorContext::get_output_delay.
+     * @return Result containing the number of frames written per channel and an ErrorCode, as
+     *         for drain_interleaved.
+     *
+     * @warning Allocates memory and is not thread-safe. Avoid calling from real-time audio threads.
+     */
+    Result<size_t> drain_planar(const ProcessorContext& context, float* const* tail,
+                                uint16_t num_channels, size_t max_frames);
+
+    /**
+     * Ends a stream like drain_interleaved, writing the tail in sequential layout: the returned
+     * frame count `n` of channel `c` start at `tail + c * n`.
+     *
+     * @param context Context of this processor.
+     * @param tail Buffer of `num_channels * max_frames` samples.
+     * @param num_channels Number of channels (must match initialization).
+     * @param max_frames Capacity of `tail` in frames per channel; at least
+     *                   ProcessorContext::get_output_delay.
+     * @return Result containing the number of frames written per channel and an ErrorCode, as
+     *         for drain_interleaved.
+     *
+     * @warning Allocates memory and is not thread-safe. Avoid calling from real-time audio threads.
+     */
+    Result<size_t> drain_sequential(const ProcessorContext& context, float* tail,
+                                    uint16_t num_channels, size_t max_frames);
+
     /**
      * Creates a processor context handle for thread-safe control APIs.
      *
@@ -875,10 +1027,15 @@ class Processor
 
   private:
     // Constructor: creates an empty Processor wrapper for internal use when creation fails
-    Processor() : processor_(nullptr) {}
+    Processor() : processor_(nullptr), config_(0, 0), initialized_(false) {}
     // Constructor: wraps an existing SDK processor handle; this instance becomes responsible for
-    // destroying it
-    explicit Processor(::AicProcessor* processor) : processor_(processor) {}
+    // destroying it. `model_storage` keeps memory-mapped model data alive while the SDK may use it
+    explicit Processor(::AicProcessor* processor, std::shared_ptr<const void> model_storage)
+        : processor_(processor)
+        , config_(0, 0)
+        , initialized_(false)
+        , model_storage_(std::move(model_storage))
+    {}
 };
 
 // ---------------------------
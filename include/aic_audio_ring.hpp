@@ -0,0 +1,290 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace aic
+{
+
+namespace detail
+{
+struct RingWorkerState;
+} // namespace detail
+
+// ---------------------------
+// Audio ring
+// ---------------------------
+
+/**
+ * Snapshot of the counters of an AudioRing.
+ */
+struct AudioRingStats
+{
+    /// Capacity in frames.
+    size_t capacity;
+    /// Frames currently buffered.
+    size_t fill;
+    /// Highest fill level seen by the producer after a write, in frames. The producer may see
+    /// a slightly stale read index, so this is an upper bound.
+    size_t high_water;
+    /// Writes that could not store all of their frames.
+    uint64_t overruns;
+    /// Frames discarded by those writes.
+    uint64_t dropped_frames;
+    /// Reads that could not return all of the requested frames.
+    uint64_t underruns;
+    /// Frames missing from those reads.
+    uint64_t missing_frames;
+};
+
+/**
+ * Wait-free single-producer/single-consumer ring buffer for multichannel float audio.
+ *
+ * One thread writes and one thread reads; neither ever blocks or allocates. Frames are stored
+ * interleaved in a power-of-two ring, so indices wrap with a mask. The producer's and the
+ * consumer's indices and counters are `alignas(64)` groups on separate cache lines, and each
+ * side keeps a private copy of the other side's index to avoid touching the shared line on every
+ * call. Rings on the stack, in static storage or inside other objects get that alignment; a ring
+ * allocated with `new` gets it only from C++17 on, where `new` honours over-aligned types.
+ *
+ * Writes that do not fit store what fits and count an overrun; reads that find too few frames
+ * return what is there and count an underrun.
+ *
+ * @warning Exactly one producer thread and one consumer thread. Moving the ring is only allowed
+ *          while neither side uses it.
+ */
+class AudioRing
+{
+  private:
+    // Producer cache line
+    alignas(64) std::atomic<uint64_t> write_index_;
+    uint64_t                          cached_read_index_;
+    std::atomic<size_t>               high_water_;
+    std::atomic<uint64_t>             overruns_;
+    std::atomic<uint64_t>             dropped_frames_;
+
+    // Consumer cache line
+    alignas(64) std::atomic<uint64_t> read_index_;
+    uint64_t                          cached_write_index_;
+    std::atomic<uint64_t>             underruns_;
+    std::atomic<uint64_t>             missing_frames_;
+
+    // Read-only after creation, on a line of its own so neither side's stores evict it
+    alignas(64) uint16_t num_channels_;
+    size_t               capacity_;
+    size_t               mask_;
+    std::vector<float>   buffer_;
+
+  public:
+    // Move constructor: takes over the buffer and indices of the source ring
+    AudioRing(AudioRing&& other) noexcept;
+
+    // Move assignment: takes over the buffer and indices of the source ring
+    AudioRing& operator=(AudioRing&& other) noexcept;
+
+    // Deleted copy constructor: the ring is shared by exactly one producer and one consumer
+    AudioRing(const AudioRing&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    AudioRing& operator=(const AudioRing&) = delete;
+
+    /**
+     * Creates a ring buffer.
+     *
+     * @param num_channels Number of channels per frame.
+     * @param min_capacity Minimum capacity in frames; rounded up to a power of two.
+     * @return Result containing the AudioRing and an ErrorCode.
+     *         ErrorCode::ParameterOutOfRange if `num_channels` or `min_capacity` is zero or the
+     *         capacity is too large.
+     *
+     * @warning Allocates memory. Avoid calling from real-time audio threads.
+     */
+    static Result<AudioRing> create(uint16_t num_channels, size_t min_capacity);
+
+    /**
+     * Appends interleaved frames.
+     *
+     * @param audio Interleaved buffer of `num_channels * num_frames` samples.
+     * @param num_frames Number of frames to append.
+     * @return Number of frames written. Less than `num_frames` on overrun.
+     *
+     * @note Wait-free. Producer thread only.
+     */
+    size_t write_interleaved(const float* audio, size_t num_frames);
+
+    /**
+     * Appends planar frames.
+     *
+     * @param audio Array of channel buffer pointers, one per channel.
+     * @param num_frames Number of frames to append.
+     * @return Number of frames written. Less than `num_frames` on overrun.
+     *
+     * @note Wait-free. Producer thread only.
+     */
+    size_t write_planar(const float* const* audio, size_t num_frames);
+
+    /**
+     * Removes the oldest frames into an interleaved buffer.
+     *
+     * @param audio Interleaved buffer with room for `num_channels * num_frames` samples. Frames
+     *              beyond the returned count are left unchanged.
+     * @param num_frames Number of frames requested.
+     * @return Number of frames read. Less than `num_frames` on underrun.
+     *
+     * @note Wait-free. Consumer thread only.
+     */
+    size_t read_interleaved(float* audio, size_t num_frames);
+
+    /**
+     * Removes the oldest frames into planar buffers.
+     *
+     * @param audio Array of channel buffer pointers, one per channel, each with room for
+     *              `num_frames` samples. Frames beyond the returned count are left unchanged.
+     * @param num_frames Number of frames requested.
+     * @return Number of frames read. Less than `num_frames` on underrun.
+     *
+     * @note Wait-free. Consumer thread only.
+     */
+    size_t read_planar(float* const* audio, size_t num_frames);
+
+    /**
+     * Returns the number of frames that can be read.
+     *
+     * @note Wait-free. Exact on the consumer thread, a lower bound elsewhere.
+     */
+    size_t get_read_available() const;
+
+    /**
+     * Returns the number of frames that can be written.
+     *
+     * @note Wait-free. Exact on the producer thread, a lower bound elsewhere.
+     */
+    size_t get_write_available() const;
+
+    /**
+     * Returns the ring counters.
+     *
+     * @note Thread-safe and wait-free. Counters from the two sides are read independently.
+     */
+    AudioRingStats get_stats() const;
+
+    /// Returns the capacity in frames.
+    size_t get_capacity() const
+    {
+        return capacity_;
+    }
+
+    /// Returns the number of channels per frame.
+    uint16_t get_num_channels() const
+    {
+        return num_channels_;
+    }
+
+  private:
+    // Constructor: creates an empty ring for internal use when creation fails
+    AudioRing();
+    // Constructor: allocates a ring of `capacity` frames (a power of two)
+    AudioRing(uint16_t num_channels, size_t capacity);
+
+    // Reserves up to `num_frames` frames for writing and returns the first ring frame
+    size_t begin_write(size_t& num_frames);
+    // Publishes `num_frames` written frames and updates the producer counters
+    void end_write(size_t num_frames, size_t requested);
+    // Reserves up to `num_frames` frames for reading and returns the first ring frame
+    size_t begin_read(size_t& num_frames);
+    // Releases `num_frames` read frames and updates the consumer counters
+    void end_read(size_t num_frames, size_t requested);
+};
+
+// ---------------------------
+// Ring worker
+// ---------------------------
+
+/**
+ * Drains an input AudioRing into a Processor on its own thread and pushes the enhanced audio
+ * into an output AudioRing.
+ *
+ * The capture thread writes into the input ring and the playback (or network) thread reads from
+ * the output ring; neither waits for model compute. The worker processes whole blocks of the
+ * processor's configured `num_frames`, so the output trails the input by at most one block plus
+ * the processor's output delay. Audio is never dropped by the worker itself; overruns show up
+ * in the counters of the output ring.
+ *
+ * The rings stay wait-free, so the worker polls: when less than one block is buffered it sleeps
+ * for a quarter of the block duration.
+ *
+ * @warning The processor and both rings must outlive the worker, and the worker is their only
+ *          consumer (input ring), producer (output ring) and user (processor).
+ */
+class RingWorker
+{
+  private:
+    std::unique_ptr<detail::RingWorkerState> state_;
+
+  public:
+    // Destructor: stops and joins the worker thread
+    ~RingWorker();
+
+    // Move constructor: takes over the thread of the source worker
+    RingWorker(RingWorker&& other) noexcept;
+
+    // Move assignment: stops the current thread and takes over the thread of the source worker
+    RingWorker& operator=(RingWorker&& other) noexcept;
+
+    // Deleted copy constructor: the worker owns its thread exclusively
+    RingWorker(const RingWorker&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    RingWorker& operator=(const RingWorker&) = delete;
+
+    /**
+     * Creates a worker and starts its thread.
+     *
+     * @param processor Initialized processor to drive.
+     * @param input Ring the worker reads from.
+     * @param output Ring the worker writes enhanced audio to.
+     * @return Result containing the RingWorker and an ErrorCode.
+     *         ErrorCode::ProcessorNotInitialized if the processor is not initialized;
+     *         ErrorCode::AudioConfigMismatch if a ring's channel count differs from the
+     *         processor's or a ring cannot hold one block.
+     *
+     * @warning Allocates memory and starts a thread. Avoid calling from real-time audio threads.
+     */
+    static Result<RingWorker> create(Processor& processor, AudioRing& input, AudioRing& output);
+
+    /**
+     * Returns the number of blocks processed so far.
+     *
+     * @note Thread-safe and wait-free.
+     */
+    uint64_t get_processed_blocks() const;
+
+    /**
+     * Returns the number of blocks for which the processor reported an error.
+     *
+     * Failed blocks are still forwarded so the output stays aligned with the input.
+     *
+     * @note Thread-safe and wait-free.
+     */
+    uint64_t get_failed_blocks() const;
+
+    /**
+     * Returns the most recent error reported by the processor, or ErrorCode::Success.
+     *
+     * @note Thread-safe and wait-free.
+     */
+    ErrorCode get_last_error() const;
+
+  private:
+    // Constructor: creates an empty worker for internal use when creation fails
+    RingWorker();
+    // Constructor: takes over a prepared state and starts the thread
+    explicit RingWorker(std::unique_ptr<detail::RingWorkerState> state);
+};
+
+} // namespace aic
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace aic
+{
+
+namespace detail
+{
+struct BatchState;
+} // namespace detail
+
+// ---------------------------
+// Batch processing
+// ---------------------------
+
+/**
+ * Channel layout of the audio buffer of a BatchItem.
+ */
+enum class AudioLayout : int
+{
+    /// One buffer per channel, see Processor::process_planar
+    Planar = 0,
+    /// Alternating samples in one buffer, see Processor::process_interleaved
+    Interleaved = 1,
+    /// Channels one after another in one buffer, see Processor::process_sequential
+    Sequential = 2,
+};
+
+/**
+ * One stream of a batch: a processor and the buffer it enhances in-place.
+ *
+ * Use the named constructors to fill in the layout-specific fields.
+ */
+struct BatchItem
+{
+    /// Processor for this stream.
+    Processor* processor;
+    /// Layout of the audio buffer.
+    AudioLayout layout;
+    /// Channel pointers for AudioLayout::Planar, otherwise unused.
+    float* const* planar;
+    /// Buffer for AudioLayout::Interleaved and AudioLayout::Sequential, otherwise unused.
+    float* buffer;
+    /// Number of channels (must match the processor configuration).
+    uint16_t num_channels;
+    /// Number of frames per channel.
+    size_t num_frames;
+
+    /// Creates an item that calls Processor::process_planar.
+    static BatchItem make_planar(Processor& processor, float* const* audio, uint16_t num_channels,
+                                 size_t num_frames)
+    {
+        BatchItem item = {&processor, AudioLayout::Planar, audio, nullptr, num_channels,
+                          num_frames};
+        return item;
+    }
+
+    /// Creates an item that calls Processor::process_interleaved.
+    static BatchItem make_interleaved(Processor& processor, float* audio, uint16_t num_channels,
+                                      size_t num_frames)
+    {
+        BatchItem item = {&processor, AudioLayout::Interleaved, nullptr, audio, num_channels,
+                          num_frames};
+        return item;
+    }
+
+    /// Creates an item that calls Processor::process_sequential.
+    static BatchItem make_sequential(Processor& processor, float* audio, uint16_t num_channels,
+                                     size_t num_frames)
+    {
+        BatchItem item = {&processor, AudioLayout::Sequential, nullptr, audio, num_channels,
+                          num_frames};
+        return item;
+    }
+};
+
+/**
+ * Processes many independent streams per tick on a persistent pool of worker threads.
+ *
+ * The workers are started once at creation. Each call to process() publishes the batch, wakes
+ * the workers, processes items on the calling thread as well, and returns after a single
+ * barrier once every item is done. Items are claimed one at a time from a shared counter, so
+ * streams with uneven cost balance across cores.
+ *
+ * Items that share a processor are processed in their original order by one thread, so a
+ * processor is never touched by two threads at once within a batch.
+ *
+ * @warning A processor must not be used outside the batch while process() runs.
+ */
+class BatchProcessor
+{
+  private:
+    std::unique_ptr<detail::BatchState> state_;
+
+  public:
+    // Destructor: stops and joins the worker threads
+    ~BatchProcessor();
+
+    // Move constructor: takes over the worker threads of the source batch processor
+    BatchProcessor(BatchProcessor&& other) noexcept;
+
+    // Move assignment: stops the current workers and takes over those of the source
+    BatchProcessor& operator=(BatchProcessor&& other) noexcept;
+
+    // Deleted copy constructor: the batch processor owns its worker threads exclusively
+    BatchProcessor(const BatchProcessor&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    BatchProcessor& operator=(const BatchProcessor&) = delete;
+
+    /**
+     * Creates a batch processor and starts its worker threads.
+     *
+     * @param num_threads Threads that process items, including the thread calling process().
+     *                    0 uses std::thread::hardware_concurrency.
+     * @param max_items Number of items to preallocate scratch space for. Larger batches are
+     *                  accepted but allocate on first use.
+     * @return Result containing the BatchProcessor and an ErrorCode.
+     *
+     * @warning Allocates memory and starts threads. Avoid calling from real-time audio threads.
+     */
+    static Result<BatchProcessor> create(size_t num_threads = 0, size_t max_items = 512);
+
+    /**
+     * Enhances every item of a batch in-place.
+     *
+     * @param items Array of `num_items` items.
+     * @param num_items Number of items.
+     * @param results Array of `num_items` error codes, one per item, written before returning.
+     * @return ErrorCode::Success if every item succeeded, otherwise the error of the first failed
+     *         item. ErrorCode::NullPointer if `items` or `results` is null.
+     *
+     * @warning Not thread-safe; call from one thread at a time.
+     */
+    ErrorCode process(const BatchItem* items, size_t num_items, ErrorCode* results);
+
+    /**
+     * Returns the number of threads that process items, including the calling thread.
+     *
+     * @note Thread-safe.
+     */
+    size_t get_num_threads() const;
+
+  private:
+    // Constructor: creates an empty batch processor for internal use when creation fails
+    BatchProcessor();
+    // Constructor: takes over a prepared state and starts the worker threads
+    explicit BatchProcessor(std::unique_ptr<detail::BatchState> state);
+};
+
+} // namespace aic
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace aic
+{
+
+// ---------------------------
+// Chunked processing
+// ---------------------------
+
+/**
+ * Reads `num_frames` interleaved frames starting at `first_frame` of the recording into `audio`.
+ * Must fill the whole range and return ErrorCode::Success, or return an error to abort.
+ */
+typedef std::function<ErrorCode(uint64_t first_frame, float* audio, size_t num_frames)>
+    ChunkSource;
+
+/**
+ * Receives the next `num_frames` interleaved frames of the enhanced recording. Return an error
+ * to abort.
+ */
+typedef std::function<ErrorCode(const float* audio, size_t num_frames)> ChunkSink;
+
+/**
+ * Configures each worker's processor after creation, for example to set parameters on its
+ * ProcessorContext.
+ */
+typedef std::function<ErrorCode(const ProcessorContext& context)> ChunkSetup;
+
+/**
+ * Settings for process_chunked.
+ */
+struct ChunkedConfig
+{
+    /// Sample rate of the recording in Hz.
+    uint32_t sample_rate;
+    /// Number of interleaved channels.
+    uint16_t num_channels;
+    /// Length of the recording in frames.
+    uint64_t total_frames;
+    /// Frames per process call; 0 uses Model::get_optimal_num_frames for the sample rate.
+    size_t num_frames;
+    /// Frames of output each chunk contributes.
+    size_t chunk_frames;
+    /// Frames of input processed before each chunk (but the first) to bring the model into the
+    /// state it would have in one continuous pass. Their output is discarded.
+    size_t overlap_frames;
+    /// Frames over which each chunk fades into the next. At most `chunk_frames`.
+    size_t crossfade_frames;
+    /// Worker threads, each with its own processor. 0 uses std::thread::hardware_concurrency.
+    size_t num_threads;
+
+    /**
+     * Constructs a ChunkedConfig with 60 s chunks, 1 s of overlap and a 10 ms crossfade.
+     *
+     * @param sample_rate Sample rate of the recording in Hz.
+     * @param num_channels Number of interleaved channels.
+     * @param total_frames Length of the recording in frames.
+     */
+    ChunkedConfig(uint32_t sample_rate, uint16_t num_channels, uint64_t total_frames)
+        : sample_rate(sample_rate)
+        , num_channels(num_channels)
+        , total_frames(total_frames)
+        , num_frames(0)
+        , chunk_frames(static_cast<size_t>(sample_rate) * 60)
+        , overlap_frames(sample_rate)
+        , crossfade_frames(sample_rate / 100)
+        , num_threads(0)
+    {}
+};
+
+/**
+ * Enhances a long recording on several cores by splitting it into chunks that are processed
+ * concurrently, each on its own processor.
+ *
+ * Every chunk starts from a reset processor that first runs over the `overlap_frames` of input
+ * before the chunk, and continues past its end until the output delay is flushed, so each chunk
+ * is sample-aligned with the input. Neighbouring chunks are joined with a linear crossfade over
+ * `crossfade_frames`, taken from the frames following the earlier chunk. The first chunk has no
+ * warm-up and matches a continuous pass exactly; later chunks converge to it as the overlap
+ * grows past the model's memory.
+ *
+ * The output has exactly `total_frames` frames, delivered to `sink` in order on the calling
+ * thread. `source` is called from the worker threads, one call at a time. At most two chunks per
+ * thread are held in memory, so recordings of any length can be streamed from and to files.
+ *
+ * @param model Model shared by the worker processors.
+ * @param license_key License key for the worker processors.
+ * @param config Recording format and chunking settings.
+ * @param source Provides the input.
+ * @param sink Receives the output.
+ * @param setup Optional, called once for the context of every worker processor.
+ * @return ErrorCode::Success, ErrorCode::NullPointer if `source` or `sink` is empty,
+ *         ErrorCode::ParameterOutOfRange for an invalid configuration, or the first error of a
+ *         worker processor, `source`, `setup` or `sink`.
+ *
+ * @warning Allocates memory and starts threads. Avoid calling from real-time audio threads.
+ */
+ErrorCode process_chunked(const Model&         model,
+                          const std::string&   license_key,
+                          const ChunkedConfig& config,
+                          const ChunkSource&   source,
+                          const ChunkSink&     sink,
+                          const ChunkSetup&    setup = ChunkSetup());
+
+} // namespace aic
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// Latency histograms
+// ---------------------------
+
+namespace detail
+{
+// Values below 2^kLatencySubBucketBits nanoseconds get a bucket each. Every power of two above
+// that is split into 2^kLatencySubBucketBits linear sub-buckets, which bounds the relative
+// error of a reported percentile to 1/16. Values of 2^kLatencyMaxBits ns (about 68.7 s) and
+// more land in the last bucket.
+const size_t kLatencySubBucketBits = 4;
+const size_t kLatencyMaxBits       = 36;
+const size_t kLatencyNumBuckets =
+    (kLatencyMaxBits - kLatencySubBucketBits + 1) << kLatencySubBucketBits;
+} // namespace detail
+
+/**
+ * Point-in-time copy of a LatencyHistogram. Plain data that can be merged, stored and sent
+ * anywhere.
+ */
+struct LatencySnapshot
+{
+    /// Number of recorded durations per bucket, see get_bucket_upper_bound.
+    std::vector<uint64_t> counts;
+    /// Number of recorded durations.
+    uint64_t count;
+    /// Sum of all recorded durations in nanoseconds.
+    uint64_t sum_ns;
+    /// Shortest recorded duration in nanoseconds (0 if nothing was recorded).
+    uint64_t min_ns;
+    /// Longest recorded duration in nanoseconds.
+    uint64_t max_ns;
+
+    // Constructor: creates an empty snapshot
+    LatencySnapshot();
+
+    /**
+     * Adds the durations of another snapshot to this one, for example to aggregate the
+     * histograms of several streams.
+     */
+    void merge(const LatencySnapshot& other);
+
+    /**
+     * Returns the duration in nanoseconds below which the given fraction of recorded durations
+     * fall, for example 0.99 for p99.
+     *
+     * The result is the upper bound of the bucket holding that rank (never above max_ns), so it
+     * overestimates by at most 1/16. Returns 0 if nothing was recorded.
+     *
+     * @param quantile Fraction between 0.0 and 1.0 (clamped).
+     */
+    uint64_t get_percentile(double quantile) const;
+
+    /**
+     * Returns the mean duration in nanoseconds, or 0.0 if nothing was recorded.
+     */
+    double get_mean() const;
+
+    /**
+     * Returns the largest duration in nanoseconds counted by the bucket at `index`.
+     */
+    static uint64_t get_bucket_upper_bound(size_t index);
+};
+
+/**
+ * Fixed-size log-linear histogram of durations, recorded without locks.
+ *
+ * All storage is allocated at construction. record() is meant for a single writer, typically
+ * the audio thread that owns a stream, and uses only relaxed atomic loads and stores, so it
+ * never blocks and never issues a read-modify-write instruction. snapshot() may run
+ * concurrently from any thread.
+ */
+class LatencyHistogram
+{
+  private:
+    std::atomic<uint64_t> counts_[detail::kLatencyNumBuckets];
+    std::atomic<uint64_t> sum_ns_;
+    std::atomic<uint64_t> min_ns_;
+    std::atomic<uint64_t> max_ns_;
+
+  public:
+    // Constructor: creates an empty histogram
+    LatencyHistogram();
+
+    // Deleted copy constructor: use snapshot() to copy the recorded data
+    LatencyHistogram(const LatencyHistogram&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * Records one duration.
+     *
+     * @param duration_ns Duration in nanoseconds.
+     *
+     * @note Real-time safe and wait-free.
+     * @warning Single writer: calls must not overlap. Calls from different threads are fine as
+     *          long as they are ordered, for example by a processor being handed over.
+     */
+    void record(uint64_t duration_ns);
+
+    /**
+     * Copies the recorded data.
+     *
+     * Buckets are read one by one while the writer may keep recording, so a snapshot can miss
+     * the durations recorded while it is taken. It never contains torn values.
+     *
+     * @note Thread-safe. Allocates memory; intended for control threads.
+     */
+    LatencySnapshot snapshot() const;
+};
+
+// ---------------------------
+// Deadline tracking
+// ---------------------------
+
+/**
+ * A process call that took longer than its deadline budget.
+ */
+struct DeadlineEvent
+{
+    /// Index of the call, counting every call of the wrapper from 0.
+    uint64_t call_index;
+    /// Duration of the call in nanoseconds.
+    uint64_t duration_ns;
+    /// Budget the call exceeded in nanoseconds.
+    uint64_t budget_ns;
+    /// Number of frames processed by the call.
+    size_t num_frames;
+    /// Consecutive missed calls up to and including this one.
+    uint64_t streak;
+};
+
+/**
+ * Deadline and real-time factor statistics of an InstrumentedProcessor.
+ */
+struct DeadlineStats
+{
+    /// Process calls checked against a deadline (calls on an initialized processor).
+    uint64_t calls;
+    /// Calls that exceeded their budget.
+    uint64_t misses;
+    /// Consecutive misses up to the most recent call (0 if it met its deadline).
+    uint64_t current_streak;
+    /// Longest run of consecutive misses.
+    uint64_t longest_streak;
+    /// Events discarded because the event queue was full.
+    uint64_t dropped_events;
+    /// Total processing time divided by total audio duration of all checked calls.
+    double realtime_factor;
+    /// Real-time factor smoothed over roughly the last 16 calls.
+    double recent_realtime_factor;
+};
+
+namespace detail
+{
+struct InstrumentationState;
+} // namespace detail
+
+// ---------------------------
+// Instrumented processor
+// ---------------------------
+
+/**
+ * Processor wrapper that records the duration of every process call and checks it against the
+ * call's real-time deadline.
+ *
+ * Each call is timed with std::chrono::steady_clock and recorded into a LatencyHistogram owned
+ * by the wrapper. The instrumentation costs two clock reads and one histogram update per call
+ * and no locks; `aic-bench-latency` measures it on the target machine. Take snapshots from a
+ * control thread to report p50/p99/p99.9 per stream, and merge them for aggregates.
+ *
+ * A call processing `num_frames` frames has `num_frames / sample_rate` seconds of real time.
+ * Its budget is that duration times the deadline fraction (see set_deadline_fraction); a
+ * longer call is a miss. Misses are counted, and each one is queued as a DeadlineEvent in a
+ * fixed-size lock-free queue. The audio thread never runs user code: a control thread calls
+ * poll_deadline_events to hand the queued events to its callback.
+ *
+ * @warning The wrapper keeps a non-owning reference to the processor, which must outlive it.
+ */
+class InstrumentedProcessor
+{
+  private:
+    Processor*                                    processor_;
+    std::unique_ptr<detail::InstrumentationState> state_;
+
+  public:
+    /**
+     * Wraps a processor. The processor may be initialized before or after wrapping it; calls
+     * on an uninitialized processor are timed but not checked against a deadline.
+     *
+     * @param processor Processor to wrap.
+     * @param deadline_fraction Initial deadline fraction, see set_deadline_fraction.
+     *
+     * @warning Allocates memory. Avoid calling from real-time audio threads.
+     */
+    explicit InstrumentedProcessor(Processor& processor, float deadline_fraction = 1.0f);
+
+    // Destructor: releases the histogram and the event queue
+    ~InstrumentedProcessor();
+
+    // Move constructor: takes over the processor reference and statistics of the source wrapper
+    InstrumentedProcessor(InstrumentedProcessor&& other) noexcept;
+
+    // Move assignment: takes over the processor reference and statistics of the source wrapper
+    InstrumentedProcessor& operator=(InstrumentedProcessor&& other) noexcept;
+
+    // Deleted copy constructor: the statistics belong to one stream
+    InstrumentedProcessor(const InstrumentedProcessor&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    InstrumentedProcessor& operator=(const InstrumentedProcessor&) = delete;
+
+    /**
+     * Calls Processor::process_planar, records its duration and checks its deadline.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_planar(float* const* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Calls Processor::process_interleaved, records its duration and checks its deadline.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_interleaved(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Calls Processor::process_sequential, records its duration and checks its deadline.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_sequential(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Returns a snapshot of the call durations recorded so far.
+     *
+     * @note Thread-safe. Allocates memory; intended for control threads.
+     */
+    LatencySnapshot snapshot() const;
+
+    /**
+     * Returns the histogram the call durations are recorded into.
+     */
+    const LatencyHistogram& get_histogram() const;
+
+    /**
+     * Sets the share of a block's real-time duration a process call may take.
+     *
+     * **Range:** greater than 0.0; values of 0.0 or below are ignored
+     * - **1.0:** A call misses when it takes longer than the audio it processes
+     * - **0.5:** A call misses when it takes more than half of that time, leaving headroom for
+     *   the rest of the audio callback
+     *
+     * @note Thread-safe, lock-free and real-time safe. Applies from the next call on.
+     */
+    void set_deadline_fraction(float fraction);
+
+    /**
+     * Returns the current deadline fraction.
+     *
+     * @note Thread-safe, lock-free and real-time safe.
+     */
+    float get_deadline_fraction() const;
+
+    /**
+     * Returns deadline statistics and the real-time factor of the stream.
+     *
+     * @note Thread-safe and lock-free.
+     */
+    DeadlineStats get_deadline_stats() const;
+
+    /**
+     * Hands every queued deadline miss to `callback`, oldest first, on the calling thread.
+     *
+     * The queue holds 256 events. Poll often enough that it does not fill up; events arriving
+     * while it is full are dropped and counted in DeadlineStats::dropped_events.
+     *
+     * @param callback Function invoked once per event.
+     * @return Number of events delivered.
+     *
+     * @note Thread-safe. Meant to be called periodically from a control thread.
+     */
+    size_t poll_deadline_events(const std::function<void(const DeadlineEvent&)>& callback);
+
+    /**
+     * Returns the wrapped processor.
+     */
+    Processor& get_processor() const
+    {
+        return *processor_;
+    }
+
+  private:
+    // Records the duration of one call and checks it against the call's deadline
+    void account(uint64_t duration_ns, size_t num_frames);
+};
+
+} // namespace aic
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "aic.hpp"
+#include "aic_wav.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace aic
+{
+
+// ---------------------------
+// Memory-mapped float files
+// ---------------------------
+
+/**
+ * A 32-bit float audio file (WAV or headerless) opened through a read-only memory mapping.
+ *
+ * The samples are read straight from the OS page cache: no read() calls, and no copy into a
+ * user-space I/O buffer. The mapping is released when the last copy of the object is destroyed.
+ */
+class MappedAudioFile
+{
+  private:
+    std::shared_ptr<const void> mapping_;
+    const uint8_t*              samples_;
+    WavFormat                   format_;
+    uint64_t                    num_frames_;
+    bool                        is_wav_;
+
+  public:
+    /**
+     * Maps a WAV, RF64 or BW64 file with 32-bit float samples.
+     *
+     * @param path Path to the file.
+     * @return Result containing the MappedAudioFile and an ErrorCode:
+     *         ErrorCode::FileSystemError if the file cannot be opened, mapped or is not a valid
+     *         WAV file, ErrorCode::AudioConfigUnsupported for other sample formats (use
+     *         WavReader for those).
+     *
+     * @warning Performs file I/O. Avoid calling from real-time audio threads.
+     */
+    static Result<MappedAudioFile> open_wav(const std::string& path);
+
+    /**
+     * Maps a headerless file of interleaved 32-bit little-endian float samples (as written by
+     * `ffmpeg -f f32le` or `sox -t f32`). A trailing partial frame is ignored.
+     *
+     * @param path Path to the file.
+     * @param sample_rate Sample rate of the audio in Hz.
+     * @param num_channels Number of interleaved channels.
+     * @return Result containing the MappedAudioFile and an ErrorCode:
+     *         ErrorCode::ParameterOutOfRange for a zero sample rate or channel count,
+     *         ErrorCode::FileSystemError if the file is empty or cannot be opened or mapped.
+     *
+     * @warning Performs file I/O. Avoid calling from real-time audio threads.
+     */
+    static Result<MappedAudioFile> open_raw(const std::string& path, uint32_t sample_rate,
+                                            uint16_t num_channels);
+
+    /**
+     * Returns the audio format; the sample format is always SampleFormat::Float32.
+     */
+    const WavFormat& get_format() const
+    {
+        return format_;
+    }
+
+    /**
+     * Returns the number of frames in the file.
+     */
+    uint64_t get_num_frames() const
+    {
+        return num_frames_;
+    }
+
+    /**
+     * Returns true for WAV files, false for headerless ones.
+     */
+    bool is_wav() const
+    {
+        return is_wav_;
+    }
+
+    /**
+     * Returns the first byte of the interleaved samples. The samples are not necessarily
+     * 4-byte aligned; copy them out with memcpy.
+     */
+    const void* get_samples() const
+    {
+        return samples_;
+    }
+
+  private:
+    // Constructor: creates an empty file for internal use when opening fails
+    MappedAudioFile();
+};
+
+/**
+ * Enhances a memory-mapped float file into a new memory-mapped file of the same kind, format
+ * and length.
+ *
+ * The output file is created at its final size and mapped read-write (MAP_SHARED), and both
+ * mappings are advised for sequential access. Every block of `num_frames` frames is copied once
+ * from the input mapping into a 64-byte aligned scratch buffer in channel-major order, processed
+ * there with Processor::process_sequential, and stored directly into the output mapping. The
+ * output is sample-aligned with the input: the first ProcessorContext::get_output_delay frames
+ * are dropped and the input is followed by silence until its last frame has been processed.
+ *
+ * The processor's context is reset first.
+ *
+ * @param processor Processor initialized for the file's sample rate and channel count, with a
+ *                  fixed frame count (allow_variable_frames false).
+ * @param context Context of `processor`.
+ * @param input File to enhance.
+ * @param output_path Path of the output file, created or truncated. WAV inputs produce a float
+ *                    WAV file (RF64 beyond 4 GiB), headerless inputs a headerless file.
+ * @return ErrorCode::Success, ErrorCode::ProcessorNotInitialized,
+ *         ErrorCode::AudioConfigMismatch if the processor's configuration does not match the
+ *         file, ErrorCode::FileSystemError if the output cannot be created, or the error of a
+ *         process call.
+ *
+ * @warning Allocates memory and performs file I/O. Avoid calling from real-time audio threads.
+ */
+ErrorCode process_mapped_file(Processor&              processor,
+                              const ProcessorContext& context,
+                              const MappedAudioFile&  input,
+                              const std::string&      output_path);
+
+} // namespace aic
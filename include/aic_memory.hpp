@@ -0,0 +1,99 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace aic
+{
+
+// ---------------------------
+// Memory accounting
+// ---------------------------
+
+/**
+ * Memory of the calling process, or the difference between two such samples (which can be
+ * negative).
+ */
+struct MemoryUsage
+{
+    /// Resident set size in bytes: all pages of the process currently in RAM.
+    int64_t resident_bytes;
+    /// Proportional set size in bytes: resident pages, with shared pages divided among the
+    /// processes mapping them. Equal to resident_bytes where the platform does not report it.
+    int64_t proportional_bytes;
+    /// Resident anonymous memory in bytes (heap, stacks, anonymous mappings): memory private to
+    /// the process that is not backed by a file.
+    int64_t anonymous_bytes;
+};
+
+/**
+ * Returns the current memory usage of the calling process.
+ *
+ * Reads /proc/self/smaps_rollup on Linux (falling back to /proc/self/status on kernels before
+ * 4.14), task_info on macOS and GetProcessMemoryInfo on Windows. On macOS anonymous_bytes is
+ * the physical footprint; on Windows it is the private commit charge.
+ *
+ * @return Result containing the usage and an ErrorCode, ErrorCode::FileSystemError if the
+ *         platform query fails.
+ *
+ * @note Thread-safe. Performs file I/O on Linux; do not call from real-time audio threads.
+ */
+Result<MemoryUsage> get_memory_usage();
+
+/**
+ * Memory attributable to the components of one stream configuration, measured by
+ * measure_footprint.
+ */
+struct FootprintReport
+{
+    /// Sample rate the processors were initialized with.
+    uint32_t sample_rate;
+    /// Channel count the processors were initialized with.
+    uint16_t num_channels;
+    /// Frame count the processors were initialized with.
+    size_t num_frames;
+    /// Processors the per-component values are averaged over.
+    size_t num_streams;
+    /// Memory added by loading the model, shared by all processors created from it.
+    MemoryUsage model;
+    /// Memory added per processor by Processor::create, Processor::initialize and the first
+    /// process call (which allocates processing buffers lazily in some SDK versions).
+    MemoryUsage processor;
+    /// Memory added per ProcessorContext.
+    MemoryUsage context;
+    /// Memory added per VadContext.
+    MemoryUsage vad_context;
+};
+
+/**
+ * Measures the memory attributable to a model and to each processor, ProcessorContext and
+ * VadContext of one stream configuration.
+ *
+ * Loads the model, then creates `num_streams` processors with their contexts phase by phase,
+ * sampling get_memory_usage between phases. Per-component values are averaged over
+ * `num_streams` to smooth out allocator granularity. All objects are destroyed before
+ * returning.
+ *
+ * Memory freed earlier in the process may be reused by the allocator and hide part of the
+ * growth, so call this in a fresh process for each configuration for the most accurate
+ * numbers (the aic-memory-report tool does).
+ *
+ * @param model_path Path to the model file.
+ * @param license_key License key for the processors.
+ * @param config Configuration to initialize the processors with.
+ * @param num_streams Number of processors to create (at least 1).
+ * @return Result containing the report and an ErrorCode: errors from model loading, processor
+ *         creation or initialization, ErrorCode::ParameterOutOfRange for zero streams, or
+ *         ErrorCode::FileSystemError if memory usage cannot be read.
+ *
+ * @warning Allocates memory and creates processors; do not call from real-time audio threads.
+ */
+Result<FootprintReport> measure_footprint(const std::string&     model_path,
+                                          const std::string&     license_key,
+                                          const ProcessorConfig& config,
+                                          size_t                 num_streams = 8);
+
+} // namespace aic
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "aic.hpp"
+#include "aic_latency.hpp"
+#include "aic_processor_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace aic
+{
+
+// ---------------------------
+// Metrics exporter
+// ---------------------------
+
+/**
+ * Text exposition formats understood by Prometheus.
+ */
+enum class MetricsFormat
+{
+    /// Prometheus text format 0.0.4, as read by node_exporter's textfile collector.
+    Prometheus,
+    /// OpenMetrics 1.0 text format.
+    OpenMetrics,
+};
+
+/**
+ * Renders wrapper-level audio metrics for Prometheus.
+ *
+ * Register the streams (InstrumentedProcessor) and processor pools to export under a name;
+ * the name becomes the `stream` or `pool` label. Exported metrics:
+ *
+ * - `aic_active_processors`: registered streams
+ * - `aic_process_duration_seconds{stream}`: histogram of process call durations; the rate of
+ *   its `_count` is the call rate
+ * - `aic_process_duration_quantile_seconds{stream,quantile}`: p50, p99 and p99.9 computed from
+ *   the full-resolution histogram
+ * - `aic_realtime_factor{stream}`: real-time factor over roughly the last 16 calls
+ * - `aic_deadline_misses_total{stream}`, `aic_deadline_miss_streak{stream}`,
+ *   `aic_deadline_miss_streak_max{stream}`: see InstrumentedProcessor
+ * - `aic_pool_processors{pool,state}`: leased and idle processors
+ * - `aic_pool_acquires_total{pool,result}`, `aic_pool_acquire_timeouts_total{pool}`,
+ *   `aic_pool_wait_seconds_total{pool}`: see ProcessorPoolStats
+ *
+ * Collection only reads the atomics the audio thread writes; it never takes a lock that a
+ * process call takes. Pool statistics take the pool's lock, which only acquire and release
+ * use.
+ *
+ * Metrics can be served from a loopback HTTP endpoint (start_http_server) or written to a file
+ * for node_exporter's textfile collector (write_file), or both.
+ *
+ * @warning The exporter keeps non-owning references to registered streams and pools. Remove
+ *          them before they are destroyed.
+ */
+class MetricsExporter
+{
+  private:
+    mutable std::mutex                                  mutex_;
+    std::map<std::string, const InstrumentedProcessor*> streams_;
+    std::map<std::string, const ProcessorPool*>         pools_;
+    std::thread                                         server_;
+    std::atomic<bool>                                   stop_server_;
+    uint16_t                                            port_;
+    intptr_t                                            listen_socket_;
+
+  public:
+    // Constructor: creates an exporter without streams or pools
+    MetricsExporter();
+
+    // Destructor: stops the HTTP server if it is running
+    ~MetricsExporter();
+
+    // Deleted copy constructor: the exporter is shared by reference
+    MetricsExporter(const MetricsExporter&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * Exports the statistics of a stream. Registering a name again replaces the stream.
+     *
+     * @note Thread-safe.
+     */
+    void add_stream(const std::string& name, const InstrumentedProcessor& stream);
+
+    /**
+     * Stops exporting a stream.
+     *
+     * @return True if a stream with this name was registered.
+     *
+     * @note Thread-safe. Once it returns, the exporter no longer touches the stream.
+     */
+    bool remove_stream(const std::string& name);
+
+    /**
+     * Exports the statistics of a processor pool. Registering a name again replaces the pool.
+     *
+     * @note Thread-safe.
+     */
+    void add_pool(const std::string& name, const ProcessorPool& pool);
+
+    /**
+     * Stops exporting a processor pool.
+     *
+     * @return True if a pool with this name was registered.
+     *
+     * @note Thread-safe. Once it returns, the exporter no longer touches the pool.
+     */
+    bool remove_pool(const std::string& name);
+
+    /**
+     * Renders all metrics.
+     *
+     * @note Thread-safe.
+     */
+    std::string render(MetricsFormat format = MetricsFormat::OpenMetrics) const;
+
+    /**
+     * Renders all metrics into `path`, replacing the file atomically: the text is written to
+     * `path` + ".tmp" first and then renamed, so readers never see a partial file.
+     *
+     * @return ErrorCode::Success, or ErrorCode::FileSystemError if the file cannot be written.
+     *
+     * @note Thread-safe, but concurrent calls must use different paths.
+     */
+    ErrorCode write_file(const std::string& path,
+                         MetricsFormat      format = MetricsFormat::Prometheus) const;
+
+    /**
+     * Serves the metrics over HTTP on 127.0.0.1 from a background thread.
+     *
+     * Any GET request is answered with the rendered metrics, in OpenMetrics format when the
+     * request accepts `application/openmetrics-text` and in Prometheus text format otherwise.
+     *
+     * @param port TCP port, or 0 to let the OS pick one (see get_http_port).
+     * @return ErrorCode::Success, ErrorCode::ParameterOutOfRange if the server is already
+     *         running, or ErrorCode::InternalError if the socket cannot be set up.
+     *
+     * @note Thread-safe with respect to the other functions, but not to itself or
+     *       stop_http_server.
+     */
+    ErrorCode start_http_server(uint16_t port);
+
+    /**
+     * Stops the HTTP server and waits for its thread. Does nothing if it is not running.
+     */
+    void stop_http_server();
+
+    /**
+     * Returns the port the HTTP server listens on, or 0 if it is not running.
+     */
+    uint16_t get_http_port() const
+    {
+        return port_;
+    }
+
+  private:
+    // Accepts and answers connections until stop_server_ is set
+    void serve();
+};
+
+} // namespace aic
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// Dry/wet mixer
+// ---------------------------
+
+/**
+ * Blends enhanced audio with the latency-compensated original signal.
+ *
+ * Each process call stores the dry input in a preallocated delay line, enhances the buffer
+ * through the processor, and mixes it with the dry signal delayed by exactly
+ * ProcessorContext::get_output_delay frames, so both signals stay sample-aligned. The delay
+ * line is sized once at creation from the processor's configuration.
+ *
+ * The mix ratio can be changed from any thread without locking. The audio thread ramps to the
+ * new ratio across the next processed block to avoid zipper noise.
+ *
+ * @warning The mixer keeps a non-owning reference to the processor. The processor must
+ *          outlive the mixer and must not be re-initialized while the mixer is in use. Create a
+ *          new mixer after re-initializing.
+ */
+class DryWetMixer
+{
+  private:
+    Processor*         processor_;
+    ProcessorContext   context_;
+    uint16_t           num_channels_;
+    size_t             max_num_frames_;
+    size_t             delay_;
+    size_t             capacity_;
+    size_t             write_pos_;
+    float              gain_;
+    std::atomic<float> target_gain_;
+    std::vector<float> delay_line_;
+    std::vector<float> scratch_;
+
+  public:
+    // Move constructor: takes over the delay line, mix ratio and processor reference of the
+    // source mixer
+    DryWetMixer(DryWetMixer&& other) noexcept;
+
+    // Move assignment: takes over the delay line, mix ratio and processor reference of the
+    // source mixer
+    DryWetMixer& operator=(DryWetMixer&& other) noexcept;
+
+    // Deleted copy constructor: the mixer holds per-stream state that must not be duplicated
+    DryWetMixer(const DryWetMixer&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    DryWetMixer& operator=(const DryWetMixer&) = delete;
+
+    /**
+     * Creates a dry/wet mixer for an initialized processor.
+     *
+     * @param processor Initialized processor to drive.
+     * @param mix Initial mix ratio, see set_mix.
+     * @return Result containing the DryWetMixer and an ErrorCode.
+     *
+     * @warning Allocates memory and is not thread-safe. Avoid calling from real-time audio threads.
+     */
+    static Result<DryWetMixer> create(Processor& processor, float mix = 1.0f);
+
+    /**
+     * Processes audio with separate buffers for each channel (planar layout).
+     *
+     * Enhances the provided audio in-place and blends it with the delayed input.
+     *
+     * @param audio Array of channel buffer pointers, one per channel.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of samples per channel (same rules as Processor::process_planar).
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_planar(float* const* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Processes audio with interleaved channels in a single buffer.
+     *
+     * @param audio Interleaved audio buffer of size num_channels * num_frames.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of frames (same rules as Processor::process_interleaved).
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_interleaved(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Processes audio with sequential channel data in a single buffer.
+     *
+     * @param audio Sequential audio buffer of size num_channels * num_frames.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of frames (same rules as Processor::process_sequential).
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_sequential(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Sets the mix ratio between enhanced (wet) and original (dry) audio.
+     *
+     * **Range:** 0.0 to 1.0 (values outside are clamped)
+     * - **0.0:** Original audio only, delayed to match the enhanced path
+     * - **1.0:** Enhanced audio only
+     *
+     * @param mix New mix ratio.
+     *
+     * @note Thread-safe, lock-free and real-time safe. Intended for control threads.
+     */
+    void set_mix(float mix);
+
+    /**
+     * Returns the most recently requested mix ratio.
+     *
+     * @note Thread-safe, lock-free and real-time safe.
+     */
+    float get_mix() const
+    {
+        return target_gain_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Clears the delay line and the processor state, and jumps to the requested mix ratio.
+     *
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @note Real-time safe.
+     * @warning Not thread-safe with respect to the process functions.
+     */
+    ErrorCode reset();
+
+    /**
+     * Returns the delay in frames applied to the dry signal, equal to the processor's
+     * ProcessorContext::get_output_delay at creation.
+     *
+     * @note Thread-safe and real-time safe.
+     */
+    size_t get_output_delay() const
+    {
+        return delay_;
+    }
+
+  private:
+    // Constructor: creates an empty mixer for internal use when creation fails
+    DryWetMixer();
+    // Constructor: binds the mixer to an initialized processor and allocates the delay line
+    DryWetMixer(Processor& processor, ProcessorContext&& context, float mix);
+
+    // Validates the arguments shared by the three process functions
+    ErrorCode check(const void* audio, uint16_t num_channels, size_t num_frames) const;
+
+    // Stores the dry input of one process call in the delay line
+    template <typename View> void push_dry(const View& view, size_t num_frames);
+
+    // Mixes the delayed dry signal into the enhanced audio and advances the gain ramp
+    template <typename View> void mix(const View& view, size_t num_frames);
+};
+
+} // namespace aic
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// Model registry
+// ---------------------------
+
+/**
+ * Load and memory statistics of one model held by a ModelRegistry.
+ */
+struct ModelStats
+{
+    /// Canonical path the model was first loaded from.
+    std::string path;
+    /// Model identifier reported by Model::get_id.
+    std::string id;
+    /// 64-bit FNV-1a hash of the file contents.
+    uint64_t content_hash;
+    /// Size of the model file in bytes.
+    size_t file_size;
+    /// Time spent mapping, hashing and creating the model, in nanoseconds.
+    uint64_t load_time_ns;
+    /// Bytes of the model file currently resident in memory (0 where the platform offers no
+    /// way to query it).
+    size_t resident_bytes;
+    /// Handles held outside the registry.
+    long external_refs;
+};
+
+/**
+ * Thread-safe registry that shares one Model per model file across a process.
+ *
+ * acquire() resolves the path to its canonical form and returns the already loaded model when
+ * possible. Otherwise it memory-maps the file (see Model::create_from_mapped_file) and hashes
+ * its contents, so a copy of the same file under another path also shares the loaded model.
+ * Files whose hash and size match are compared byte by byte before they share a model. The
+ * model is created from that same mapping.
+ * Handles are `std::shared_ptr<const Model>`; processors created from a handle keep the model
+ * data alive on their own.
+ *
+ * Use get_global() for a process-wide instance, or create registries of your own.
+ */
+class ModelRegistry
+{
+  private:
+    struct Record;
+    struct Slot;
+
+    mutable std::mutex                           mutex_;
+    std::map<std::string, std::shared_ptr<Slot>> slots_;
+    std::vector<std::shared_ptr<Record>>         records_;
+    std::vector<std::thread>                     preloads_;
+    std::vector<ErrorCode>                       preload_errors_;
+
+  public:
+    // Constructor: creates an empty registry
+    ModelRegistry();
+
+    // Destructor: waits for running preloads and releases the registry's model references
+    ~ModelRegistry();
+
+    // Deleted copy constructor: the registry is shared by reference
+    ModelRegistry(const ModelRegistry&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+    /**
+     * Returns the process-wide registry.
+     *
+     * @note Thread-safe.
+     */
+    static ModelRegistry& get_global();
+
+    /**
+     * Returns a shared handle to the model stored at `file_path`, loading it on first use.
+     *
+     * Concurrent calls for the same file load it once; calls for different files load in
+     * parallel.
+     *
+     * @param file_path Path to the model file.
+     * @param prefault Reads the whole file in while loading, see Model::create_from_mapped_file.
+     * @return Result containing the model handle and an ErrorCode. Failed loads are not cached.
+     *
+     * @note Thread-safe. May block on file I/O; do not call from real-time audio threads.
+     */
+    Result<std::shared_ptr<const Model>> acquire(const std::string& file_path,
+                                                 bool               prefault = false);
+
+    /**
+     * Loads models on a background thread, prefaulting their pages.
+     *
+     * Later acquire() calls for these files return immediately, or wait for the preload of that
+     * file if it is still running.
+     *
+     * @param file_paths Paths of the models to load.
+     *
+     * @note Thread-safe.
+     */
+    void preload(const std::vector<std::string>& file_paths);
+
+    /**
+     * Waits for all preloads started so far.
+     *
+     * @return ErrorCode::Success if every preloaded model loaded, otherwise the first error.
+     *
+     * @note Thread-safe.
+     */
+    ErrorCode wait_for_preload();
+
+    /**
+     * Drops the registry's reference to models that have no handles outside the registry.
+     *
+     * @return Number of models released.
+     *
+     * @note Thread-safe.
+     */
+    size_t purge();
+
+    /**
+     * Returns statistics for every loaded model.
+     *
+     * @note Thread-safe. Queries residency of every model file, so it is not meant for hot
+     *       paths.
+     */
+    std::vector<ModelStats> get_stats() const;
+};
+
+} // namespace aic
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// PCM sample formats
+// ---------------------------
+
+/**
+ * Sample formats accepted by the PCM conversion kernels.
+ *
+ * All formats are little-endian. Integer formats map full scale to [-1.0, 1.0).
+ */
+enum class SampleFormat : int
+{
+    /// Signed 16-bit integer
+    Int16 = 0,
+    /// Signed 24-bit integer packed in 3 bytes
+    Int24 = 1,
+    /// Signed 32-bit integer
+    Int32 = 2,
+    /// 32-bit IEEE float
+    Float32 = 3,
+    /// 64-bit IEEE float
+    Float64 = 4,
+};
+
+/**
+ * Returns the size of one sample in bytes (2, 3, 4, 4 or 8).
+ *
+ * @note Thread-safe and real-time safe.
+ */
+size_t get_sample_size(SampleFormat format);
+
+/**
+ * Converts contiguous PCM samples to float without changing their order.
+ *
+ * @param src Source samples in `format`.
+ * @param format Format of the source samples.
+ * @param dst Destination buffer of `num_samples` floats.
+ * @param num_samples Number of samples to convert.
+ *
+ * @note Thread-safe and real-time safe.
+ */
+void convert_to_float(const void* src, SampleFormat format, float* dst, size_t num_samples);
+
+/**
+ * Converts contiguous float samples to PCM without changing their order.
+ *
+ * Integer formats are rounded to nearest and saturated to their range.
+ *
+ * @param src Source samples.
+ * @param dst Destination buffer of `num_samples` samples in `format`.
+ * @param format Format of the destination samples.
+ * @param num_samples Number of samples to convert.
+ *
+ * @note Thread-safe and real-time safe.
+ */
+void convert_from_float(const float* src, void* dst, SampleFormat format, size_t num_samples);
+
+/**
+ * Converts interleaved PCM to planar float in a single pass over the source.
+ *
+ * @param src Interleaved source buffer of `num_channels * num_frames` samples in `format`.
+ * @param format Format of the source samples.
+ * @param dst Array of channel buffer pointers, one per channel, each `num_frames` long.
+ * @param num_channels Number of channels.
+ * @param num_frames Number of frames to convert.
+ *
+ * @note Thread-safe and real-time safe.
+ */
+void deinterleave_to_float(const void* src, SampleFormat format, float* const* dst,
+                           uint16_t num_channels, size_t num_frames);
+
+/**
+ * Converts planar float to interleaved PCM in a single pass over the destination.
+ *
+ * Integer formats are rounded to nearest and saturated to their range.
+ *
+ * @param src Array of channel buffer pointers, one per channel, each `num_frames` long.
+ * @param dst Interleaved destination buffer of `num_channels * num_frames` samples in `format`.
+ * @param format Format of the destination samples.
+ * @param num_channels Number of channels.
+ * @param num_frames Number of frames to convert.
+ *
+ * @note Thread-safe and real-time safe.
+ */
+void interleave_from_float(const float* const* src, void* dst, SampleFormat format,
+                           uint16_t num_channels, size_t num_frames);
+
+// ---------------------------
+// PCM front-end
+// ---------------------------
+
+/**
+ * Runs interleaved PCM of any supported format through Processor::process_planar.
+ *
+ * The front-end deinterleaves and converts the input into preallocated planar float buffers,
+ * enhances them, and writes the result back into the caller's buffer with saturation. Every
+ * sample is read once and written once.
+ *
+ * @warning The front-end keeps a non-owning reference to the processor. The processor must
+ *          outlive the front-end and must not be re-initialized while the front-end is in use.
+ */
+class PcmFrontEnd
+{
+  private:
+    Processor*          processor_;
+    uint16_t            num_channels_;
+    size_t              num_frames_;
+    std::vector<float>  planar_;
+    std::vector<float*> channels_;
+
+  public:
+    // Move constructor: takes over the scratch buffers and processor reference of the source
+    PcmFrontEnd(PcmFrontEnd&& other) = default;
+
+    // Move assignment: takes over the scratch buffers and processor reference of the source
+    PcmFrontEnd& operator=(PcmFrontEnd&& other) = default;
+
+    // Deleted copy constructor: the channel pointers refer to this instance's scratch buffer
+    PcmFrontEnd(const PcmFrontEnd&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    PcmFrontEnd& operator=(const PcmFrontEnd&) = delete;
+
+    /**
+     * Creates a PCM front-end for an initialized processor.
+     *
+     * @param processor Initialized processor to drive.
+     * @return Result containing the PcmFrontEnd and an ErrorCode.
+     *
+     * @warning Allocates memory and is not thread-safe. Avoid calling from real-time audio threads.
+     */
+    static Result<PcmFrontEnd> create(Processor& processor);
+
+    /**
+     * Enhances interleaved PCM in-place.
+     *
+     * @param audio Interleaved buffer of `num_channels * num_frames` samples in `format`.
+     * @param format Sample format of `audio`.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of frames (same rules as Processor::process_planar).
+     * @return ErrorCode::Success on success, or an error code on failure. On failure the
+     *         buffer is left unchanged.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_interleaved(void* audio, SampleFormat format, uint16_t num_channels,
+                                  size_t num_frames);
+
+  private:
+    // Constructor: creates an empty front-end for internal use when creation fails
+    PcmFrontEnd();
+    // Constructor: binds the front-end to an initialized processor and allocates scratch buffers
+    explicit PcmFrontEnd(Processor& processor);
+};
+
+} // namespace aic
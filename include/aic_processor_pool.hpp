@@ -0,0 +1,255 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace aic
+{
+
+namespace detail
+{
+struct PoolState;
+struct PoolEntry;
+} // namespace detail
+
+// ---------------------------
+// Processor pool
+// ---------------------------
+
+/**
+ * Sizing policy for a ProcessorPool.
+ */
+struct ProcessorPoolOptions
+{
+    /// Processors created and initialized by ProcessorPool::create. The pool never shrinks below
+    /// this size.
+    size_t initial_size = 4;
+    /// Idle processors the background thread keeps ready. When fewer are idle, it creates more.
+    size_t min_idle = 1;
+    /// Upper bound on the number of processors, leased and idle together.
+    size_t max_size = 256;
+    /// Idle processors above `initial_size` are destroyed after being unused for this long.
+    std::chrono::milliseconds idle_timeout = std::chrono::milliseconds(30000);
+};
+
+/**
+ * Snapshot of the counters of a ProcessorPool.
+ */
+struct ProcessorPoolStats
+{
+    /// Acquisitions served immediately by an idle processor.
+    uint64_t hits;
+    /// Acquisitions that found no idle processor.
+    uint64_t misses;
+    /// Misses that waited for a processor to be returned or created.
+    uint64_t waits;
+    /// Misses that gave up without a processor.
+    uint64_t timeouts;
+    /// Total time spent waiting by acquire, in nanoseconds.
+    uint64_t total_wait_ns;
+    /// Longest single wait in acquire, in nanoseconds.
+    uint64_t max_wait_ns;
+    /// Processors created by the background thread after ProcessorPool::create.
+    uint64_t grown;
+    /// Processors destroyed by the background thread.
+    uint64_t shrunk;
+    /// Processors currently owned by the pool, leased and idle together.
+    size_t size;
+    /// Processors currently idle.
+    size_t idle;
+};
+
+class ProcessorPool;
+
+/**
+ * Exclusive, scoped access to one processor of a ProcessorPool.
+ *
+ * Returning the lease (on destruction or through release()) resets the processor state and
+ * restores the parameter values the processor was created with, so the next holder starts from
+ * a clean stream. An empty lease converts to false.
+ */
+class ProcessorLease
+{
+  private:
+    detail::PoolState* pool_;
+    detail::PoolEntry* entry_;
+
+  public:
+    // Constructor: creates an empty lease
+    ProcessorLease() : pool_(nullptr), entry_(nullptr) {}
+
+    // Destructor: returns the processor to the pool
+    ~ProcessorLease()
+    {
+        release();
+    }
+
+    // Move constructor: takes over the processor of the source lease and empties the source
+    ProcessorLease(ProcessorLease&& other) noexcept : pool_(other.pool_), entry_(other.entry_)
+    {
+        other.pool_  = nullptr;
+        other.entry_ = nullptr;
+    }
+
+    // Move assignment: returns the currently held processor and takes over the source lease
+    ProcessorLease& operator=(ProcessorLease&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            pool_        = other.pool_;
+            entry_       = other.entry_;
+            other.pool_  = nullptr;
+            other.entry_ = nullptr;
+        }
+        return *this;
+    }
+
+    // Deleted copy constructor: a lease grants exclusive access and cannot be shared
+    ProcessorLease(const ProcessorLease&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    ProcessorLease& operator=(const ProcessorLease&) = delete;
+
+    /// Returns true if the lease holds a processor.
+    explicit operator bool() const
+    {
+        return entry_ != nullptr;
+    }
+
+    /**
+     * Returns the leased processor, initialized with the pool's configuration.
+     *
+     * @warning Do not call Processor::initialize on a leased processor.
+     */
+    Processor& processor() const;
+
+    /**
+     * Returns the context of the leased processor for parameter changes and output delay queries.
+     */
+    const ProcessorContext& context() const;
+
+    /// Accesses the leased processor.
+    Processor* operator->() const
+    {
+        return &processor();
+    }
+
+    /**
+     * Resets the processor and returns it to the pool. The lease becomes empty.
+     *
+     * @note Does not allocate. Takes the pool lock briefly.
+     */
+    void release();
+
+  private:
+    friend class ProcessorPool;
+
+    // Constructor: takes ownership of an entry acquired from the pool
+    ProcessorLease(detail::PoolState* pool, detail::PoolEntry* entry)
+        : pool_(pool)
+        , entry_(entry)
+    {}
+};
+
+/**
+ * Keeps pre-initialized processors for one Model and ProcessorConfig ready for new streams.
+ *
+ * Processor::create and Processor::initialize allocate, so running them at stream setup delays
+ * the first blocks. The pool creates `initial_size` processors up front and hands them out as
+ * ProcessorLease objects. A background thread creates spare processors when the idle count drops
+ * below `min_idle` and destroys processors that stayed idle for `idle_timeout`, so neither cost
+ * lands on the thread that acquires.
+ *
+ * @warning The model must outlive the pool, and every lease must be returned before the pool is
+ *          destroyed.
+ */
+class ProcessorPool
+{
+  private:
+    std::unique_ptr<detail::PoolState> state_;
+
+  public:
+    // Destructor: stops the background thread and destroys all processors
+    ~ProcessorPool();
+
+    // Move constructor: takes over the processors and background thread of the source pool
+    ProcessorPool(ProcessorPool&& other) noexcept;
+
+    // Move assignment: destroys the current pool and takes over the source pool
+    ProcessorPool& operator=(ProcessorPool&& other) noexcept;
+
+    // Deleted copy constructor: the pool owns its processors exclusively
+    ProcessorPool(const ProcessorPool&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    ProcessorPool& operator=(const ProcessorPool&) = delete;
+
+    /**
+     * Creates a pool and initializes `options.initial_size` processors.
+     *
+     * @param model Model shared by all processors of the pool.
+     * @param license_key SDK license key.
+     * @param config Configuration passed to Processor::initialize for every processor.
+     * @param options Sizing policy.
+     * @return Result containing the ProcessorPool and an ErrorCode.
+     *         ErrorCode::ParameterOutOfRange if `max_size` is zero or smaller than
+     *         `initial_size`; otherwise the first error from Processor::create or
+     *         Processor::initialize.
+     *
+     * @warning Allocates memory and starts a thread. Avoid calling from real-time audio threads.
+     */
+    static Result<ProcessorPool> create(const Model& model, const std::string& license_key,
+                                        const ProcessorConfig& config,
+                                        const ProcessorPoolOptions& options =
+                                            ProcessorPoolOptions());
+
+    /**
+     * Leases an idle processor without waiting.
+     *
+     * Counts a hit when a processor is idle and a miss otherwise. A miss wakes the background
+     * thread to grow the pool.
+     *
+     * @return A lease, or an empty lease if no processor is idle.
+     *
+     * @note Thread-safe. Does not allocate; takes the pool lock briefly.
+     */
+    ProcessorLease try_acquire();
+
+    /**
+     * Leases a processor, waiting up to `timeout` for one to be returned or created.
+     *
+     * @param timeout Longest time to wait after a miss.
+     * @return A lease, or an empty lease if the timeout expired.
+     *
+     * @note Thread-safe. May block; do not call from real-time audio threads.
+     */
+    ProcessorLease acquire(std::chrono::milliseconds timeout);
+
+    /**
+     * Returns the pool counters.
+     *
+     * @note Thread-safe.
+     */
+    ProcessorPoolStats get_stats() const;
+
+    /**
+     * Returns the configuration every processor of the pool is initialized with.
+     *
+     * @note Thread-safe. Only meaningful for a pool returned by a successful create.
+     */
+    const ProcessorConfig& get_config() const;
+
+  private:
+    // Constructor: creates an empty pool for internal use when creation fails
+    ProcessorPool();
+    // Constructor: takes over a populated state and starts the background thread
+    explicit ProcessorPool(std::unique_ptr<detail::PoolState> state);
+};
+
+} // namespace aic
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "aic.hpp"
+#include "aic_stream_adapter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// Polyphase resampler
+// ---------------------------
+
+/**
+ * Streaming rational-ratio resampler using a Kaiser-windowed sinc polyphase filter bank.
+ *
+ * The ratio `output_rate / input_rate` is reduced to `L / M`. Each output sample is a dot
+ * product of one filter phase with the most recent input samples; the inner loop is vectorized
+ * for the active SimdLevel. All buffers are allocated at creation, so process() is real-time
+ * safe.
+ *
+ * The filter is linear-phase. get_group_delay() reports its delay in output samples.
+ */
+class PolyphaseResampler
+{
+  private:
+    uint32_t           input_rate_;
+    uint32_t           output_rate_;
+    uint16_t           num_channels_;
+    size_t             max_input_frames_;
+    uint32_t           up_;
+    uint32_t           down_;
+    size_t             taps_;
+    uint32_t           offset_;
+    uint32_t           phase_;
+    size_t             next_index_;
+    std::vector<float> coefficients_;
+    std::vector<float> history_;
+
+  public:
+    // Move constructor: takes over the filter bank and stream state of the source resampler
+    PolyphaseResampler(PolyphaseResampler&& other) = default;
+
+    // Move assignment: takes over the filter bank and stream state of the source resampler
+    PolyphaseResampler& operator=(PolyphaseResampler&& other) = default;
+
+    // Deleted copy constructor: the resampler holds per-stream state that must not be duplicated
+    PolyphaseResampler(const PolyphaseResampler&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    PolyphaseResampler& operator=(const PolyphaseResampler&) = delete;
+
+    /**
+     * Creates a resampler for a fixed pair of sample rates.
+     *
+     * @param input_rate Input sample rate in Hz.
+     * @param output_rate Output sample rate in Hz.
+     * @param num_channels Number of channels processed together.
+     * @param max_input_frames Largest number of input frames passed to a single process call.
+     * @param quality_taps Filter taps per output sample when not decimating (rounded up to a
+     *                     multiple of 8). Decimation scales the tap count by the ratio to keep
+     *                     the transition band constant. 32 gives > 80 dB stopband attenuation.
+     * @return Result containing the PolyphaseResampler and an ErrorCode.
+     *         ErrorCode::ParameterOutOfRange if a rate is zero or the reduced ratio would need
+     *         an excessively large filter bank.
+     *
+     * @warning Allocates memory. Avoid calling from real-time audio threads.
+     */
+    static Result<PolyphaseResampler> create(uint32_t input_rate, uint32_t output_rate,
+                                             uint16_t num_channels, size_t max_input_frames,
+                                             size_t quality_taps = 32);
+
+    /**
+     * Resamples a block of input frames.
+     *
+     * Input channels are addressed by pointer and stride, so planar (`stride == 1`, one pointer
+     * per channel), interleaved (`input[ch] = audio + ch`, `stride == num_channels`) and
+     * sequential buffers can all be consumed without an intermediate copy.
+     *
+     * @param input Array of `num_channels` channel pointers.
+     * @param input_stride Distance in samples between consecutive frames of one channel.
+     * @param num_frames Number of input frames, up to `max_input_frames`.
+     * @param output Array of `num_channels` planar output buffers, each with room for
+     *               get_max_output_frames(num_frames) samples.
+     * @return Number of output frames written (0 if `num_frames` exceeds `max_input_frames`).
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    size_t process(const float* const* input, size_t input_stride, size_t num_frames,
+                   float* const* output);
+
+    /**
+     * Clears the filter history and restarts the phase.
+     *
+     * @note Real-time safe.
+     */
+    void reset();
+
+    /**
+     * Advances the output timeline by a fraction of an output sample.
+     *
+     * Reduces get_group_delay() by `fraction`, quantized to 1 / M of an output sample. A chain
+     * of stages uses this to make its total delay a whole number of samples. The offset persists
+     * across reset().
+     *
+     * @param fraction Offset in output samples, in [0, 1).
+     *
+     * @note Real-time safe. Call before processing or together with reset() to avoid a
+     *       discontinuity.
+     */
+    void set_output_offset(double fraction);
+
+    /**
+     * Returns the largest number of output frames a process call with `num_frames` input frames
+     * can produce.
+     *
+     * @note Thread-safe and real-time safe.
+     */
+    size_t get_max_output_frames(size_t num_frames) const
+    {
+        uint64_t frames = (static_cast<uint64_t>(num_frames) * up_ + down_ - 1) / down_;
+        return static_cast<size_t>(frames) + 1;
+    }
+
+    /**
+     * Returns the filter's group delay in output samples.
+     *
+     * @note Thread-safe and real-time safe.
+     */
+    double get_group_delay() const
+    {
+        return (static_cast<double>(up_ * taps_ - 1) / 2.0 - offset_) / down_;
+    }
+
+    /// Returns the input sample rate in Hz.
+    uint32_t get_input_rate() const
+    {
+        return input_rate_;
+    }
+
+    /// Returns the output sample rate in Hz.
+    uint32_t get_output_rate() const
+    {
+        return output_rate_;
+    }
+
+  private:
+    // Friend declaration: allows ResamplingStage to hold empty resamplers until creation succeeds
+    friend class ResamplingStage;
+
+    // Constructor: creates an empty resampler for internal use when creation fails
+    PolyphaseResampler();
+    // Constructor: designs the filter bank and allocates the history buffer
+    PolyphaseResampler(uint32_t input_rate, uint32_t output_rate, uint16_t num_channels,
+                       size_t max_input_frames, uint32_t up, uint32_t down, size_t taps);
+};
+
+// ---------------------------
+// Resampling stage
+// ---------------------------
+
+/**
+ * Drives a Processor at the host sample rate while the model runs at its own rate.
+ *
+ * Host audio is resampled to the processor's configured sample rate (typically
+ * Model::get_optimal_sample_rate), re-blocked into the processor's block size by a
+ * StreamAdapter, enhanced, and resampled back. Host callbacks may have any size up to
+ * `max_num_frames` and always return the same number of frames they delivered.
+ *
+ * get_output_delay() folds the group delay of both resamplers and the adapter latency into the
+ * processor's output delay, expressed in host samples.
+ *
+ * @warning The stage keeps a non-owning reference to the processor. The processor must
+ *          outlive the stage and must not be re-initialized while the stage is in use.
+ */
+class ResamplingStage
+{
+  private:
+    uint16_t            num_channels_;
+    size_t              max_num_frames_;
+    PolyphaseResampler  down_;
+    PolyphaseResampler  up_;
+    StreamAdapter       adapter_;
+    std::vector<float>  model_;
+    std::vector<float*> model_channels_;
+    std::vector<float>  pending_;
+    std::vector<float*> pending_channels_;
+    size_t              pending_frames_;
+    std::vector<float*> host_channels_;
+
+  public:
+    // Move constructor: takes over the resamplers, adapter and buffers of the source stage
+    ResamplingStage(ResamplingStage&& other) = default;
+
+    // Move assignment: takes over the resamplers, adapter and buffers of the source stage
+    ResamplingStage& operator=(ResamplingStage&& other) = default;
+
+    // Deleted copy constructor: the stage holds per-stream state that must not be duplicated
+    ResamplingStage(const ResamplingStage&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    ResamplingStage& operator=(const ResamplingStage&) = delete;
+
+    /**
+     * Creates a resampling stage in front of an initialized processor.
+     *
+     * @param processor Processor initialized at the model rate, ideally with
+     *                  Model::get_optimal_sample_rate and Model::get_optimal_num_frames.
+     * @param host_sample_rate Sample rate of the host audio in Hz.
+     * @param max_num_frames Largest number of host frames passed to a single process call.
+     * @return Result containing the ResamplingStage and an ErrorCode.
+     *
+     * @warning Allocates memory and is not thread-safe. Avoid calling from real-time audio threads.
+     */
+    static Result<ResamplingStage> create(Processor& processor, uint32_t host_sample_rate,
+                                          size_t max_num_frames);
+
+    /**
+     * Processes host-rate audio with separate buffers for each channel (planar layout).
+     *
+     * @param audio Array of channel buffer pointers, one per channel.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of host frames, up to `max_num_frames`.
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_planar(float* const* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Processes host-rate audio with interleaved channels in a single buffer.
+     *
+     * @param audio Interleaved audio buffer of size num_channels * num_frames.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of host frames, up to `max_num_frames`.
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_interleaved(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Processes host-rate audio with sequential channel data in a single buffer.
+     *
+     * @param audio Sequential audio buffer of size num_channels * num_frames.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of host frames, up to `max_num_frames`.
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_sequential(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Clears both resamplers, the adapter and the processor state.
+     *
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @note Real-time safe.
+     * @warning Not thread-safe with respect to the process functions.
+     */
+    ErrorCode reset();
+
+    /**
+     * Returns the total output delay in host samples, rounded to the nearest sample.
+     *
+     * Includes the group delay of both resamplers, the adapter latency and
+     * ProcessorContext::get_output_delay, converted from model to host samples.
+     *
+     * @note Thread-safe and real-time safe.
+     */
+    size_t get_output_delay() const;
+
+  private:
+    // Constructor: creates an empty stage for internal use when creation fails
+    ResamplingStage();
+    // Constructor: takes over the resamplers and adapter and allocates the intermediate buffers
+    ResamplingStage(PolyphaseResampler&& down, PolyphaseResampler&& up, StreamAdapter&& adapter,
+                    uint16_t num_channels, size_t max_num_frames);
+
+    // Shared implementation of the three layouts
+    ErrorCode process(float* const* host, size_t stride, size_t num_frames);
+
+    // Total delay in host samples before rounding
+    double exact_output_delay() const;
+};
+
+} // namespace aic
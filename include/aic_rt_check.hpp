@@ -0,0 +1,145 @@
+#pragma once
+
+// Real-time safety checks for debug builds.
+//
+// Compiled in only when AIC_SDK_ENABLE_RT_CHECKS is defined to 1, which the CMake option of the
+// same name does for the wrapper and everything linking it. The wrapper then interposes the
+// allocator, pthread locks and waits, and blocking system calls, and reports every call made
+// by a thread while it is inside an AIC_RT_CHECK_SCOPE. Processor::process_* and the context
+// getters and setters open such a scope themselves; wrap your own pipeline stages to check
+// them too. Otherwise AIC_RT_CHECK_SCOPE expands to nothing.
+//
+// Interposition works on Linux with glibc. Elsewhere scopes are tracked but nothing is
+// reported.
+//
+// Included by aic.hpp, so it must not include it back.
+
+#include <cstdint>
+
+#ifndef AIC_SDK_ENABLE_RT_CHECKS
+#define AIC_SDK_ENABLE_RT_CHECKS 0
+#endif
+
+#define AIC_RT_CHECK_CONCAT_INNER(a, b) a##b
+#define AIC_RT_CHECK_CONCAT(a, b) AIC_RT_CHECK_CONCAT_INNER(a, b)
+
+#if AIC_SDK_ENABLE_RT_CHECKS
+/// Reports calls that are not real-time safe from here to the end of the enclosing scope.
+#define AIC_RT_CHECK_SCOPE() ::aic::RtCheckScope AIC_RT_CHECK_CONCAT(aic_rt_check_scope_, __LINE__)
+#else
+#define AIC_RT_CHECK_SCOPE()
+#endif
+
+namespace aic
+{
+
+// ---------------------------
+// Real-time safety checks
+// ---------------------------
+
+namespace detail
+{
+// Enters and leaves a checked scope on the calling thread. Scopes nest.
+void rt_check_enter();
+void rt_check_leave();
+} // namespace detail
+
+/**
+ * Checks the calling thread while alive. Use through AIC_RT_CHECK_SCOPE, which removes it when
+ * the checks are compiled out.
+ */
+class RtCheckScope
+{
+  public:
+    RtCheckScope()
+    {
+        detail::rt_check_enter();
+    }
+
+    ~RtCheckScope()
+    {
+        detail::rt_check_leave();
+    }
+
+    RtCheckScope(const RtCheckScope&)            = delete;
+    RtCheckScope& operator=(const RtCheckScope&) = delete;
+};
+
+/**
+ * Kinds of calls that are not real-time safe.
+ */
+enum class RtViolationKind : int
+{
+    /// malloc, calloc, realloc, aligned allocation, and operator new through them
+    Allocation = 0,
+    /// free, and operator delete through it
+    Deallocation = 1,
+    /// Blocking lock acquisition: pthread mutex and rwlock locks
+    Lock = 2,
+    /// Waiting for another thread: condition variables, semaphores, futex waits, joins
+    Wait = 3,
+    /// System calls that can block: file and socket I/O, sleeps, poll and select
+    BlockingCall = 4,
+};
+
+/**
+ * One call made inside a checked scope that is not real-time safe.
+ */
+struct RtViolation
+{
+    /// Kind of the call.
+    RtViolationKind kind;
+    /// Name of the interposed function, such as "malloc".
+    const char* function;
+    /// Return addresses of the calling thread, innermost first.
+    void* const* frames;
+    /// Number of entries in `frames`.
+    int num_frames;
+};
+
+/**
+ * Called for every violation, on the violating thread. Checks are suspended on that thread
+ * while the handler runs, so it may allocate and print.
+ */
+typedef void (*RtViolationHandler)(const RtViolation& violation);
+
+/**
+ * Returns true if the wrapper was compiled with AIC_SDK_ENABLE_RT_CHECKS.
+ */
+inline bool is_rt_check_enabled()
+{
+    return AIC_SDK_ENABLE_RT_CHECKS != 0;
+}
+
+/**
+ * Replaces the violation handler.
+ *
+ * The default handler, print_rt_violation, writes every violation to stderr.
+ *
+ * @param handler New handler, or nullptr to restore the default.
+ *
+ * @note Thread-safe.
+ */
+void set_rt_violation_handler(RtViolationHandler handler);
+
+/**
+ * Writes a violation and its backtrace to stderr. Symbol names are resolved as far as the
+ * binary's dynamic symbol table allows; link with -rdynamic for complete names.
+ *
+ * @param violation Violation to print.
+ */
+void print_rt_violation(const RtViolation& violation);
+
+/**
+ * Returns the number of violations reported by all threads since startup.
+ *
+ * @note Thread-safe.
+ */
+uint64_t get_rt_violation_count();
+
+/**
+ * Returns a readable name for a violation kind, such as "allocation".
+ */
+const char* get_rt_violation_kind_name(RtViolationKind kind);
+
+} // namespace aic
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+namespace aic
+{
+
+// ---------------------------
+// SIMD dispatch
+// ---------------------------
+
+/**
+ * Instruction set used by the wrapper's vectorized kernels (PCM conversion, resampling, mixing).
+ *
+ * The best level supported by the CPU is detected once at startup. Levels of the other CPU
+ * family are never selected.
+ */
+enum class SimdLevel : int
+{
+    /// Portable C++ fallback
+    Scalar = 0,
+    /// x86-64 baseline
+    Sse2 = 1,
+    /// x86-64 with AVX2
+    Avx2 = 2,
+    /// x86-64 with AVX-512F
+    Avx512 = 3,
+    /// AArch64 Advanced SIMD
+    Neon = 4,
+};
+
+/**
+ * Returns the best SIMD level supported by the running CPU.
+ *
+ * @note Thread-safe and real-time safe.
+ */
+SimdLevel get_supported_simd_level();
+
+/**
+ * Returns the SIMD level currently used by the wrapper's kernels.
+ *
+ * @note Thread-safe and real-time safe.
+ */
+SimdLevel get_simd_level();
+
+/**
+ * Restricts the wrapper's kernels to the given SIMD level.
+ *
+ * Intended for benchmarking and for comparing results against the scalar reference. Levels
+ * that are not supported by the running CPU fall back to get_supported_simd_level().
+ *
+ * @param level Requested SIMD level.
+ * @return The level that is active after the call.
+ *
+ * @note Thread-safe and real-time safe. Calls already in flight finish with the previous level.
+ */
+SimdLevel set_simd_level(SimdLevel level);
+
+/**
+ * Returns a human-readable name for a SIMD level (e.g., "avx2").
+ *
+ * @note Thread-safe and real-time safe.
+ */
+const char* get_simd_level_name(SimdLevel level);
+
+} // namespace aic
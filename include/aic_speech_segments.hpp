@@ -0,0 +1,108 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// Speech segmentation
+// ---------------------------
+
+/**
+ * A range of input frames `[first_frame, end_frame)` that contains speech.
+ */
+struct SpeechSegment
+{
+    /// First frame of the segment.
+    uint64_t first_frame;
+    /// Frame after the last frame of the segment.
+    uint64_t end_frame;
+};
+
+/**
+ * Turns the VadContext prediction after every process call into speech segments, in frames of
+ * the processor's input.
+ *
+ * The VAD's prediction has the same latency as the processor's output: after a call that
+ * brings the stream to `n` processed frames, it describes the frames that call output, which
+ * are input frames `[n - num_frames - delay, n - delay)`. The segmenter applies that correction,
+ * so the segments line up with the input (and with the delay-trimmed output). Segment
+ * boundaries have the resolution of one process call.
+ *
+ * Feed it from the thread that calls the processor, once per process call and once with the
+ * frame count returned by a Processor drain call, whose prediction then covers the whole tail.
+ */
+class SpeechSegmenter
+{
+  private:
+    uint64_t                   delay_;
+    uint64_t                   processed_;
+    bool                       in_speech_;
+    std::vector<SpeechSegment> segments_;
+
+  public:
+    /**
+     * Creates a segmenter for a new stream.
+     *
+     * @param output_delay ProcessorContext::get_output_delay of the processor the VAD context
+     *                     belongs to.
+     */
+    explicit SpeechSegmenter(size_t output_delay);
+
+    /**
+     * Records the prediction after a process call.
+     *
+     * @param speech_detected VadContext::is_speech_detected after the call.
+     * @param num_frames Number of frames of the call.
+     *
+     * @warning Allocates memory when a segment starts.
+     */
+    void record(bool speech_detected, size_t num_frames);
+
+    /**
+     * Returns the number of input frames classified so far: the frames processed minus the
+     * output delay.
+     */
+    uint64_t get_num_classified_frames() const
+    {
+        return processed_ > delay_ ? processed_ - delay_ : 0;
+    }
+
+    /**
+     * Returns the segments found so far, in order. While speech continues, the last segment
+     * ends at get_num_classified_frames and grows with the next call.
+     */
+    const std::vector<SpeechSegment>& get_segments() const
+    {
+        return segments_;
+    }
+
+    /**
+     * Forgets all segments and starts a new stream.
+     *
+     * @param output_delay Output delay of the processor for the new stream.
+     */
+    void reset(size_t output_delay);
+};
+
+/**
+ * Widens speech segments by `padding_frames` on both sides, clips them to the stream, and
+ * merges segments that then touch or overlap.
+ *
+ * A padding of a few hundred milliseconds keeps word onsets and endings that the VAD decision
+ * cuts off, and bridges short pauses inside sentences.
+ *
+ * @param segments Segments in order, as returned by SpeechSegmenter::get_segments.
+ * @param padding_frames Frames added before and after every segment.
+ * @param total_frames Length of the stream in frames.
+ * @return The padded segments, in order and non-overlapping.
+ */
+std::vector<SpeechSegment> pad_speech_segments(const std::vector<SpeechSegment>& segments,
+                                               uint64_t padding_frames, uint64_t total_frames);
+
+} // namespace aic
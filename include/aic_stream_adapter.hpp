@@ -0,0 +1,173 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// Stream adapter
+// ---------------------------
+
+/**
+ * Re-blocks audio callbacks of arbitrary size into the fixed block size of a Processor.
+ *
+ * Audio hosts rarely deliver the frame count returned by Model::get_optimal_num_frames.
+ * Instead of enabling allow_variable_frames (which adds buffering inside the SDK) the adapter
+ * keeps a single preallocated ring buffer, feeds the processor exactly the block size it was
+ * initialized with, and hands back the same number of frames it received on every call.
+ *
+ * The ring is organized as whole processing blocks stored in sequential layout, so each block
+ * is enhanced in place and the only copies are into and out of the ring. Host buffers may use
+ * any of the three layouts supported by Processor.
+ *
+ * **Latency:** To accept any callback size without underrunning, the adapter delays the stream
+ * by `num_frames - 1` frames of the processor configuration. Use get_output_delay() for the
+ * total end-to-end delay including the processor's own delay.
+ *
+ * @warning The adapter keeps a non-owning reference to the processor. The processor must
+ *          outlive the adapter and must not be re-initialized while the adapter is in use.
+ */
+class StreamAdapter
+{
+  private:
+    Processor*         processor_;
+    ProcessorContext   context_;
+    uint16_t           num_channels_;
+    size_t             block_frames_;
+    size_t             max_num_frames_;
+    size_t             capacity_;
+    size_t             latency_;
+    uint64_t           write_pos_;
+    uint64_t           process_pos_;
+    uint64_t           read_pos_;
+    std::vector<float> ring_;
+
+  public:
+    // Move constructor: takes over the ring buffer and processor reference of the source adapter
+    StreamAdapter(StreamAdapter&& other) = default;
+
+    // Move assignment: takes over the ring buffer and processor reference of the source adapter
+    StreamAdapter& operator=(StreamAdapter&& other) = default;
+
+    // Deleted copy constructor: the adapter holds per-stream state that must not be duplicated
+    StreamAdapter(const StreamAdapter&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    StreamAdapter& operator=(const StreamAdapter&) = delete;
+
+    /**
+     * Creates a stream adapter in front of an initialized processor.
+     *
+     * The processor's configured `num_frames` becomes the block size fed to the SDK. For the
+     * lowest total delay, initialize the processor with Model::get_optimal_num_frames and
+     * allow_variable_frames disabled.
+     *
+     * @param processor Initialized processor to drive.
+     * @param max_num_frames Largest number of frames that will be passed to a single process
+     *                       call. Determines the size of the preallocated ring buffer.
+     * @return Result containing the StreamAdapter and an ErrorCode.
+     *
+     * @warning Allocates memory and is not thread-safe. Avoid calling from real-time audio threads.
+     */
+    static Result<StreamAdapter> create(Processor& processor, size_t max_num_frames);
+
+    /**
+     * Processes audio with separate buffers for each channel (planar layout).
+     *
+     * Enhances the provided audio in-place, delayed by get_output_delay() frames.
+     *
+     * @param audio Array of channel buffer pointers, one per channel.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of samples per channel, from 0 up to the `max_num_frames` passed
+     *                   to StreamAdapter::create.
+     * @return ErrorCode::Success on success, or the first error reported by the processor.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_planar(float* const* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Processes audio with interleaved channels in a single buffer.
+     *
+     * @param audio Interleaved audio buffer of size num_channels * num_frames.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of samples per channel, from 0 up to `max_num_frames`.
+     * @return ErrorCode::Success on success, or the first error reported by the processor.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_interleaved(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Processes audio with sequential channel data in a single buffer.
+     *
+     * @param audio Sequential audio buffer of size num_channels * num_frames.
+     * @param num_channels Number of channels (must match the processor configuration).
+     * @param num_frames Number of samples per channel, from 0 up to `max_num_frames`.
+     * @return ErrorCode::Success on success, or the first error reported by the processor.
+     *
+     * @warning Real-time safe but not thread-safe; do not call from multiple threads.
+     */
+    ErrorCode process_sequential(float* audio, uint16_t num_channels, size_t num_frames);
+
+    /**
+     * Clears the ring buffer and the processor state.
+     *
+     * @return ErrorCode::Success on success, or an error code on failure.
+     *
+     * @note Real-time safe.
+     * @warning Not thread-safe with respect to the process functions.
+     */
+    ErrorCode reset();
+
+    /**
+     * Returns the delay in frames added by the adapter itself.
+     *
+     * @note Thread-safe and real-time safe.
+     */
+    size_t get_latency() const
+    {
+        return latency_;
+    }
+
+    /**
+     * Returns the total output delay in frames: the adapter latency plus
+     * ProcessorContext::get_output_delay of the wrapped processor.
+     *
+     * @note Thread-safe and real-time safe.
+     */
+    size_t get_output_delay() const
+    {
+        return latency_ + context_.get_output_delay();
+    }
+
+    /**
+     * Returns the largest frame count accepted by the process functions.
+     *
+     * @note Thread-safe and real-time safe.
+     */
+    size_t get_max_num_frames() const
+    {
+        return max_num_frames_;
+    }
+
+  private:
+    // Friend declaration: allows stages built on the adapter to hold an empty adapter until
+    // creation succeeds
+    friend class ResamplingStage;
+
+    // Constructor: creates an empty adapter for internal use when creation fails
+    StreamAdapter();
+    // Constructor: binds the adapter to an initialized processor and allocates the ring buffer
+    StreamAdapter(Processor& processor, ProcessorContext&& context, size_t max_num_frames);
+
+    // Shared implementation of the three layouts; View maps (channel, frame) to host memory
+    template <typename View> ErrorCode process(const View& view, size_t num_frames);
+};
+
+} // namespace aic
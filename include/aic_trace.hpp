@@ -0,0 +1,113 @@
+#pragma once
+
+// Span tracing for timeline views (chrome://tracing, ui.perfetto.dev).
+//
+// Compiled in only when AIC_SDK_ENABLE_TRACING is defined to 1, which the CMake option of the
+// same name does for the wrapper and everything linking it. Otherwise the AIC_TRACE_* macros
+// expand to nothing, so traced code is identical to untraced code.
+//
+// Included by aic.hpp, so it must not include it back.
+
+#include <cstdint>
+#include <string>
+
+#ifndef AIC_SDK_ENABLE_TRACING
+#define AIC_SDK_ENABLE_TRACING 0
+#endif
+
+#define AIC_TRACE_CONCAT_INNER(a, b) a##b
+#define AIC_TRACE_CONCAT(a, b) AIC_TRACE_CONCAT_INNER(a, b)
+
+#if AIC_SDK_ENABLE_TRACING
+/// Records a span named `name` from here to the end of the enclosing scope. `name` must be a
+/// string with static storage duration, such as a literal.
+#define AIC_TRACE_SCOPE(name) ::aic::TraceScope AIC_TRACE_CONCAT(aic_trace_scope_, __LINE__)(name)
+/// Names the calling thread in the trace.
+#define AIC_TRACE_THREAD_NAME(name) ::aic::set_trace_thread_name(name)
+#else
+#define AIC_TRACE_SCOPE(name)
+#define AIC_TRACE_THREAD_NAME(name)
+#endif
+
+namespace aic
+{
+
+enum class ErrorCode : int;
+
+// ---------------------------
+// Tracing
+// ---------------------------
+
+namespace detail
+{
+// Nanoseconds on the trace clock (std::chrono::steady_clock).
+uint64_t trace_now_ns();
+// Appends a completed span to the calling thread's buffer.
+void trace_record(const char* name, uint64_t start_ns, uint64_t end_ns);
+} // namespace detail
+
+/**
+ * Records one span on destruction. Use through AIC_TRACE_SCOPE, which removes it when tracing
+ * is compiled out.
+ */
+class TraceScope
+{
+  private:
+    const char* name_;
+    uint64_t    start_ns_;
+
+  public:
+    explicit TraceScope(const char* name)
+        : name_(name)
+        , start_ns_(detail::trace_now_ns())
+    {}
+
+    ~TraceScope()
+    {
+        detail::trace_record(name_, start_ns_, detail::trace_now_ns());
+    }
+
+    TraceScope(const TraceScope&)            = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+/**
+ * Returns true if the wrapper was compiled with AIC_SDK_ENABLE_TRACING.
+ */
+inline bool is_tracing_enabled()
+{
+    return AIC_SDK_ENABLE_TRACING != 0;
+}
+
+/**
+ * Names the calling thread in the trace and allocates its span buffer.
+ *
+ * Each thread gets a fixed-size buffer the first time it records a span, which allocates and
+ * briefly takes a lock. Call this from real-time threads before they start processing so the
+ * first process call does not pay for it.
+ *
+ * @param name Thread name shown in the trace viewer.
+ *
+ * @note Thread-safe.
+ */
+void set_trace_thread_name(const std::string& name);
+
+/**
+ * Writes the spans recorded so far in Chrome trace event JSON, readable by chrome://tracing
+ * and ui.perfetto.dev.
+ *
+ * Recording continues while the trace is written; each thread's buffer keeps its most recent
+ * spans (AIC_SDK_TRACE_BUFFER_EVENTS, 16384 by default) and overwrites older ones. Spans of
+ * threads that have exited are kept until they have been written; their buffers are then freed,
+ * or taken over by new threads, so hosts that keep creating short-lived threads do not grow
+ * without bound. Spans recorded while a thread's thread_local objects are destroyed are dropped.
+ *
+ * @param path Output file.
+ * @return ErrorCode::Success, or ErrorCode::FileSystemError if the file cannot be written. The
+ *         trace is empty if tracing was compiled out.
+ *
+ * @note Thread-safe. Allocates memory and performs file I/O; never call from audio threads.
+ */
+ErrorCode write_chrome_trace(const std::string& path);
+
+} // namespace aic
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "aic.hpp"
+#include "aic_pcm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace aic
+{
+
+// ---------------------------
+// WAV files
+// ---------------------------
+
+/**
+ * Audio format of a WAV file.
+ */
+struct WavFormat
+{
+    /// Sample rate in Hz.
+    uint32_t sample_rate;
+    /// Number of interleaved channels.
+    uint16_t num_channels;
+    /// Encoding of the samples.
+    SampleFormat sample_format;
+};
+
+/**
+ * Streaming reader for WAV files (RIFF, RF64 and BW64) with PCM or IEEE float samples.
+ *
+ * Samples are read in large buffered blocks and converted to interleaved float with the PCM
+ * kernels, so reading keeps up with far faster than real-time processing. Only the header is
+ * parsed up front; the audio is never held in memory as a whole.
+ */
+class WavReader
+{
+  private:
+    std::FILE*           file_;
+    WavFormat            format_;
+    uint64_t             num_frames_;
+    uint64_t             frames_left_;
+    size_t               block_align_;
+    long                 data_offset_;
+    std::vector<uint8_t> bytes_;
+
+  public:
+    // Destructor: closes the file
+    ~WavReader();
+
+    // Move constructor: takes over the file of the source reader
+    WavReader(WavReader&& other) noexcept;
+
+    // Move assignment: closes the current file and takes over the file of the source reader
+    WavReader& operator=(WavReader&& other) noexcept;
+
+    // Deleted copy constructor: the file handle is owned exclusively
+    WavReader(const WavReader&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    WavReader& operator=(const WavReader&) = delete;
+
+    /**
+     * Opens a WAV file and parses its header.
+     *
+     * Accepts 16-, 24- and 32-bit integer PCM and 32- and 64-bit float samples, in plain and
+     * WAVE_FORMAT_EXTENSIBLE headers. RF64/BW64 files take their sizes from the ds64 chunk. A
+     * data chunk whose size field is 0 or 0xFFFFFFFF in a plain RIFF file (as written by
+     * streaming recorders that never patched the header) is read until end of file.
+     *
+     * @param path Path to the file.
+     * @return Result containing the WavReader and an ErrorCode:
+     *         ErrorCode::FileSystemError if the file cannot be opened or is not a valid WAV
+     *         file, ErrorCode::AudioConfigUnsupported for other sample encodings.
+     *
+     * @warning Allocates memory and performs file I/O. Avoid calling from real-time audio
+     *          threads.
+     */
+    static Result<WavReader> create(const std::string& path);
+
+    /**
+     * Returns the audio format of the file.
+     */
+    const WavFormat& get_format() const
+    {
+        return format_;
+    }
+
+    /**
+     * Returns the number of frames the header announces, or UINT64_MAX if the header leaves the
+     * length open and the file is read until it ends.
+     */
+    uint64_t get_num_frames() const
+    {
+        return num_frames_;
+    }
+
+    /**
+     * Reads the next frames as interleaved float.
+     *
+     * @param audio Interleaved buffer with room for `num_channels * num_frames` samples.
+     * @param num_frames Maximum number of frames to read.
+     * @return Result containing the number of frames read, 0 at the end of the audio, and an
+     *         ErrorCode: ErrorCode::FileSystemError if reading fails. A trailing partial frame
+     *         is dropped.
+     *
+     * @warning Allocates memory on the first call (conversion buffer) and performs file I/O.
+     */
+    Result<size_t> read_interleaved(float* audio, size_t num_frames);
+
+    /**
+     * Moves the read position to a frame, so the next read starts there.
+     *
+     * @param frame Frame to continue reading at, at most the number of frames in the file.
+     * @return ErrorCode::Success, ErrorCode::ParameterOutOfRange beyond the end of a file with
+     *         a known length, or ErrorCode::FileSystemError if seeking fails.
+     *
+     * @warning Performs file I/O.
+     */
+    ErrorCode seek(uint64_t frame);
+
+  private:
+    // Constructor: creates an empty reader for internal use when opening fails
+    WavReader();
+};
+
+/**
+ * Streaming writer for WAV files.
+ *
+ * Writes a RIFF header with a placeholder chunk that finish() turns into the ds64 chunk of an
+ * RF64 header once the file grows beyond 4 GiB, so any length can be written without knowing
+ * it in advance and short files stay plain WAV.
+ */
+class WavWriter
+{
+  private:
+    std::FILE*           file_;
+    WavFormat            format_;
+    uint64_t             frames_written_;
+    size_t               block_align_;
+    ErrorCode            error_;
+    std::vector<uint8_t> bytes_;
+
+  public:
+    // Destructor: calls finish() if it was not called, ignoring errors
+    ~WavWriter();
+
+    // Move constructor: takes over the file of the source writer
+    WavWriter(WavWriter&& other) noexcept;
+
+    // Move assignment: finishes the current file and takes over the file of the source writer
+    WavWriter& operator=(WavWriter&& other) noexcept;
+
+    // Deleted copy constructor: the file handle is owned exclusively
+    WavWriter(const WavWriter&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    /**
+     * Creates or truncates a WAV file and writes its header.
+     *
+     * Integer formats other than 16-bit and files with more than two channels get a
+     * WAVE_FORMAT_EXTENSIBLE header, as the format specification requires.
+     *
+     * @param path Path to the file.
+     * @param format Audio format to write.
+     * @return Result containing the WavWriter and an ErrorCode:
+     *         ErrorCode::ParameterOutOfRange for a zero sample rate or channel count,
+     *         ErrorCode::FileSystemError if the file cannot be written.
+     *
+     * @warning Allocates memory and performs file I/O. Avoid calling from real-time audio
+     *          threads.
+     */
+    static Result<WavWriter> create(const std::string& path, const WavFormat& format);
+
+    /**
+     * Returns the audio format of the file.
+     */
+    const WavFormat& get_format() const
+    {
+        return format_;
+    }
+
+    /**
+     * Returns the number of frames written so far.
+     */
+    uint64_t get_num_frames() const
+    {
+        return frames_written_;
+    }
+
+    /**
+     * Appends interleaved float frames, converted to the file's sample format with
+     * saturation.
+     *
+     * @param audio Interleaved buffer of `num_channels * num_frames` samples.
+     * @param num_frames Number of frames to append.
+     * @return ErrorCode::Success, or ErrorCode::FileSystemError if writing fails (also for all
+     *         later calls).
+     *
+     * @warning Allocates memory when called with more frames than before and performs file
+     *          I/O.
+     */
+    ErrorCode write_interleaved(const float* audio, size_t num_frames);
+
+    /**
+     * Writes the final sizes into the header and closes the file.
+     *
+     * @return ErrorCode::Success, or ErrorCode::FileSystemError if any write failed. Later calls
+     *         return the same result.
+     */
+    ErrorCode finish();
+
+  private:
+    // Constructor: creates an empty writer for internal use when creation fails
+    WavWriter();
+};
+
+} // namespace aic
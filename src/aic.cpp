@@ -1,12 +1,117 @@
 #include "aic.hpp"
 
+#include "aic_mapped_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 extern "C" void aic_set_sdk_wrapper_id(uint32_t id);
 
 namespace aic
 {
 
+namespace
+{
+
+enum class DrainLayout
+{
+    Planar,
+    Interleaved,
+    Sequential
+};
+
+// Pushes silence through the processor until the output delay has come out, copies exactly
+// those frames into `planar` or `flat`, and resets the context.
+Result<size_t> drain(Processor& processor, const ProcessorContext& context, DrainLayout layout,
+                     float* const* planar, float* flat, uint16_t num_channels, size_t max_frames)
+{
+    if (!processor.is_initialized())
+    {
+        return Result<size_t>(0, ErrorCode::ProcessorNotInitialized);
+    }
+    const ProcessorConfig& config = processor.get_config();
+    if (num_channels != config.num_channels)
+    {
+        return Result<size_t>(0, ErrorCode::AudioConfigMismatch);
+    }
+    const size_t delay = context.get_output_delay();
+    if (delay > max_frames)
+    {
+        return Result<size_t>(0, ErrorCode::ParameterOutOfRange);
+    }
+    if (delay > 0 && !planar && !flat)
+    {
+        return Result<size_t>(0, ErrorCode::NullPointer);
+    }
+    for (uint16_t c = 0; planar && c < num_channels; ++c)
+    {
+        if (delay > 0 && !planar[c])
+        {
+            return Result<size_t>(0, ErrorCode::NullPointer);
+        }
+    }
+
+    // Planar and sequential calls share the scratch layout: channel c starts at c * frames.
+    const size_t        block = config.num_frames;
+    std::vector<float>  scratch(block * num_channels);
+    std::vector<float*> channels(num_channels);
+    ErrorCode           err = ErrorCode::Success;
+    for (size_t done = 0; done < delay && err == ErrorCode::Success;)
+    {
+        // Without variable frames every call is a whole block; frames past the delay are dropped.
+        const size_t frames = config.allow_variable_frames ? std::min(block, delay - done) : block;
+        const size_t keep   = std::min(frames, delay - done);
+        std::fill(scratch.begin(), scratch.end(), 0.0f);
+        for (uint16_t c = 0; c < num_channels; ++c)
+        {
+            channels[c] = scratch.data() + c * frames;
+        }
+
+        switch (layout)
+        {
+        case DrainLayout::Planar:
+            err = processor.process_planar(channels.data(), num_channels, frames);
+            break;
+        case DrainLayout::Interleaved:
+            err = processor.process_interleaved(scratch.data(), num_channels, frames);
+            break;
+        case DrainLayout::Sequential:
+            err = processor.process_sequential(scratch.data(), num_channels, frames);
+            break;
+        }
+        if (err != ErrorCode::Success)
+        {
+            break;
+        }
+
+        if (layout == DrainLayout::Interleaved)
+        {
+            std::memcpy(flat + done * num_channels, scratch.data(),
+                        keep * num_channels * sizeof(float));
+        }
+        for (uint16_t c = 0; layout != DrainLayout::Interleaved && c < num_channels; ++c)
+        {
+            float* out = layout == DrainLayout::Planar ? planar[c] : flat + c * delay;
+            std::memcpy(out + done, channels[c], keep * sizeof(float));
+        }
+        done += keep;
+    }
+
+    const ErrorCode reset_err = context.reset();
+    if (err == ErrorCode::Success)
+    {
+        err = reset_err;
+    }
+    return Result<size_t>(err == ErrorCode::Success ? delay : 0, err);
+}
+
+} // namespace
+
 Result<Model> Model::create_from_file(const std::string& file_path)
 {
+    AIC_TRACE_SCOPE("Model::create_from_file");
+
     ::AicModel*    raw_model = nullptr;
     ::AicErrorCode rc        = aic_model_create_from_file(&raw_model, file_path.c_str());
 
@@ -20,6 +125,8 @@ Result<Model> Model::create_from_file(const std::string& file_path)
 
 Result<Model> Model::create_from_buffer(const uint8_t* buffer, size_t buffer_len)
 {
+    AIC_TRACE_SCOPE("Model::create_from_buffer");
+
     ::AicModel*    raw_model = nullptr;
     ::AicErrorCode rc        = aic_model_create_from_buffer(&raw_model, buffer, buffer_len);
 
@@ -31,8 +138,38 @@ Result<Model> Model::create_from_buffer(const uint8_t* buffer, size_t buffer_len
     return Result<Model>(Model(), static_cast<ErrorCode>(static_cast<int>(rc)));
 }
 
+Result<Model> Model::create_from_mapped_file(const std::string& file_path, bool prefault)
+{
+    AIC_TRACE_SCOPE("Model::create_from_mapped_file");
+
+    auto mapped = detail::MappedFile::map(file_path, prefault);
+    if (!mapped.ok())
+    {
+        return Result<Model>(Model(), mapped.error);
+    }
+
+    std::shared_ptr<detail::MappedFile> file = mapped.take();
+    return create_from_storage(file->data(), file->size(), file);
+}
+
+Result<Model> Model::create_from_storage(const uint8_t* buffer, size_t buffer_len,
+                                         std::shared_ptr<const void> storage)
+{
+    ::AicModel*    raw_model = nullptr;
+    ::AicErrorCode rc        = aic_model_create_from_buffer(&raw_model, buffer, buffer_len);
+
+    if (rc == AIC_ERROR_CODE_SUCCESS)
+    {
+        return Result<Model>(Model(raw_model, std::move(storage)), ErrorCode::Success);
+    }
+
+    return Result<Model>(Model(), static_cast<ErrorCode>(static_cast<int>(rc)));
+}
+
 Result<Processor> Processor::create(const Model& model, const std::string& license_key)
 {
+    AIC_TRACE_SCOPE("Processor::create");
+
     static const bool wrapper_id_set = []()
     {
         aic_set_sdk_wrapper_id(1);
@@ -45,7 +182,7 @@ Result<Processor> Processor::create(const Model& model, const std::string& licen
 
     if (rc == AIC_ERROR_CODE_SUCCESS)
     {
-        return Result<Processor>(Processor(raw_processor), ErrorCode::Success);
+        return Result<Processor>(Processor(raw_processor, model.storage_), ErrorCode::Success);
     }
 
     return Result<Processor>(Processor(), static_cast<ErrorCode>(static_cast<int>(rc)));
@@ -53,6 +190,8 @@ Result<Processor> Processor::create(const Model& model, const std::string& licen
 
 Result<ProcessorContext> Processor::create_context() const
 {
+    AIC_TRACE_SCOPE("Processor::create_context");
+
     ::AicProcessorContext* raw_context = nullptr;
     ::AicErrorCode         rc          = aic_processor_context_create(&raw_context, processor_);
 
@@ -67,6 +206,8 @@ Result<ProcessorContext> Processor::create_context() const
 
 Result<VadContext> Processor::create_vad_context() const
 {
+    AIC_TRACE_SCOPE("Processor::create_vad_context");
+
     ::AicVadContext* raw_context = nullptr;
     ::AicErrorCode   rc          = aic_vad_context_create(&raw_context, processor_);
 
@@ -78,4 +219,27 @@ Result<VadContext> Processor::create_vad_context() const
     return Result<VadContext>(VadContext(), static_cast<ErrorCode>(static_cast<int>(rc)));
 }
 
+Result<size_t> Processor::drain_interleaved(const ProcessorContext& context, float* tail,
+                                            uint16_t num_channels, size_t max_frames)
+{
+    AIC_TRACE_SCOPE("Processor::drain_interleaved");
+    return drain(*this, context, DrainLayout::Interleaved, nullptr, tail, num_channels,
+                 max_frames);
+}
+
+Result<size_t> Processor::drain_planar(const ProcessorContext& context, float* const* tail,
+                                       uint16_t num_channels, size_t max_frames)
+{
+    AIC_TRACE_SCOPE("Processor::drain_planar");
+    return drain(*this, context, DrainLayout::Planar, tail, nullptr, num_channels, max_frames);
+}
+
+Result<size_t> Processor::drain_sequential(const ProcessorContext& context, float* tail,
+                                           uint16_t num_channels, size_t max_frames)
+{
+    AIC_TRACE_SCOPE("Processor::drain_sequential");
+    return drain(*this, context, DrainLayout::Sequential, nullptr, tail, num_channels,
+                 max_frames);
+}
+
 } // namespace aic
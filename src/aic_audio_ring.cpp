@@ -0,0 +1,418 @@
+#include "aic_audio_ring.hpp"
+
+#include "aic_audio_view.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace aic
+{
+
+namespace
+{
+
+// Rings larger than this (in frames) are rejected.
+const size_t kMaxCapacity = size_t(1) << 30;
+
+// Single-writer counter update: a plain load and store, no read-modify-write.
+void bump(std::atomic<uint64_t>& counter, uint64_t amount)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// ---------------------------
+// AudioRing
+// ---------------------------
+
+AudioRing::AudioRing()
+    : write_index_(0)
+    , cached_read_index_(0)
+    , high_water_(0)
+    , overruns_(0)
+    , dropped_frames_(0)
+    , read_index_(0)
+    , cached_write_index_(0)
+    , underruns_(0)
+    , missing_frames_(0)
+    , num_channels_(0)
+    , capacity_(0)
+    , mask_(0)
+{}
+
+AudioRing::AudioRing(uint16_t num_channels, size_t capacity)
+    : write_index_(0)
+    , cached_read_index_(0)
+    , high_water_(0)
+    , overruns_(0)
+    , dropped_frames_(0)
+    , read_index_(0)
+    , cached_write_index_(0)
+    , underruns_(0)
+    , missing_frames_(0)
+    , num_channels_(num_channels)
+    , capacity_(capacity)
+    , mask_(capacity - 1)
+    , buffer_(capacity * num_channels, 0.0f)
+{}
+
+AudioRing::AudioRing(AudioRing&& other) noexcept
+    : write_index_(other.write_index_.load(std::memory_order_relaxed))
+    , cached_read_index_(other.cached_read_index_)
+    , high_water_(other.high_water_.load(std::memory_order_relaxed))
+    , overruns_(other.overruns_.load(std::memory_order_relaxed))
+    , dropped_frames_(other.dropped_frames_.load(std::memory_order_relaxed))
+    , read_index_(other.read_index_.load(std::memory_order_relaxed))
+    , cached_write_index_(other.cached_write_index_)
+    , underruns_(other.underruns_.load(std::memory_order_relaxed))
+    , missing_frames_(other.missing_frames_.load(std::memory_order_relaxed))
+    , num_channels_(other.num_channels_)
+    , capacity_(other.capacity_)
+    , mask_(other.mask_)
+    , buffer_(std::move(other.buffer_))
+{
+    other.capacity_ = 0;
+    other.mask_     = 0;
+}
+
+AudioRing& AudioRing::operator=(AudioRing&& other) noexcept
+{
+    if (this != &other)
+    {
+        write_index_.store(other.write_index_.load(std::memory_order_relaxed));
+        cached_read_index_ = other.cached_read_index_;
+        high_water_.store(other.high_water_.load(std::memory_order_relaxed));
+        overruns_.store(other.overruns_.load(std::memory_order_relaxed));
+        dropped_frames_.store(other.dropped_frames_.load(std::memory_order_relaxed));
+        read_index_.store(other.read_index_.load(std::memory_order_relaxed));
+        cached_write_index_ = other.cached_write_index_;
+        underruns_.store(other.underruns_.load(std::memory_order_relaxed));
+        missing_frames_.store(other.missing_frames_.load(std::memory_order_relaxed));
+        num_channels_   = other.num_channels_;
+        capacity_       = other.capacity_;
+        mask_           = other.mask_;
+        buffer_         = std::move(other.buffer_);
+        other.capacity_ = 0;
+        other.mask_     = 0;
+    }
+    return *this;
+}
+
+Result<AudioRing> AudioRing::create(uint16_t num_channels, size_t min_capacity)
+{
+    if (num_channels == 0 || min_capacity == 0 || min_capacity > kMaxCapacity)
+    {
+        return Result<AudioRing>(AudioRing(), ErrorCode::ParameterOutOfRange);
+    }
+
+    size_t capacity = 1;
+    while (capacity < min_capacity)
+    {
+        capacity <<= 1;
+    }
+    return Result<AudioRing>(AudioRing(num_channels, capacity), ErrorCode::Success);
+}
+
+size_t AudioRing::begin_write(size_t& num_frames)
+{
+    const uint64_t write = write_index_.load(std::memory_order_relaxed);
+    if (write + num_frames - cached_read_index_ > capacity_)
+    {
+        // Only refresh the consumer's index when the cached one says the ring is too full.
+        cached_read_index_ = read_index_.load(std::memory_order_acquire);
+    }
+    size_t space = capacity_ - static_cast<size_t>(write - cached_read_index_);
+    num_frames   = std::min(num_frames, space);
+    return static_cast<size_t>(write) & mask_;
+}
+
+void AudioRing::end_write(size_t num_frames, size_t requested)
+{
+    const uint64_t write = write_index_.load(std::memory_order_relaxed) + num_frames;
+    write_index_.store(write, std::memory_order_release);
+
+    size_t fill = static_cast<size_t>(write - cached_read_index_);
+    if (fill > high_water_.load(std::memory_order_relaxed))
+    {
+        high_water_.store(fill, std::memory_order_relaxed);
+    }
+    if (num_frames < requested)
+    {
+        bump(overruns_, 1);
+        bump(dropped_frames_, requested - num_frames);
+    }
+}
+
+size_t AudioRing::begin_read(size_t& num_frames)
+{
+    const uint64_t read = read_index_.load(std::memory_order_relaxed);
+    if (cached_write_index_ - read < num_frames)
+    {
+        // Only refresh the producer's index when the cached one says the ring is too empty.
+        cached_write_index_ = write_index_.load(std::memory_order_acquire);
+    }
+    size_t available = static_cast<size_t>(cached_write_index_ - read);
+    num_frames       = std::min(num_frames, available);
+    return static_cast<size_t>(read) & mask_;
+}
+
+void AudioRing::end_read(size_t num_frames, size_t requested)
+{
+    read_index_.store(read_index_.load(std::memory_order_relaxed) + num_frames,
+                      std::memory_order_release);
+    if (num_frames < requested)
+    {
+        bump(underruns_, 1);
+        bump(missing_frames_, requested - num_frames);
+    }
+}
+
+size_t AudioRing::write_interleaved(const float* audio, size_t num_frames)
+{
+    if (!audio || capacity_ == 0)
+    {
+        return 0;
+    }
+
+    size_t count = num_frames;
+    size_t pos   = begin_write(count);
+    size_t first = std::min(count, capacity_ - pos);
+    std::memcpy(buffer_.data() + pos * num_channels_, audio, first * num_channels_ * sizeof(float));
+    std::memcpy(buffer_.data(), audio + first * num_channels_,
+                (count - first) * num_channels_ * sizeof(float));
+    end_write(count, num_frames);
+    return count;
+}
+
+size_t AudioRing::write_planar(const float* const* audio, size_t num_frames)
+{
+    if (!audio || capacity_ == 0)
+    {
+        return 0;
+    }
+
+    size_t count = num_frames;
+    size_t pos   = begin_write(count);
+    for (size_t done = 0; done < count;)
+    {
+        size_t run = std::min(count - done, capacity_ - pos);
+        for (uint16_t ch = 0; ch < num_channels_; ++ch)
+        {
+            detail::scatter(buffer_.data() + pos * num_channels_ + ch, num_channels_,
+                            audio[ch] + done, run);
+        }
+        done += run;
+        pos = 0;
+    }
+    end_write(count, num_frames);
+    return count;
+}
+
+size_t AudioRing::read_interleaved(float* audio, size_t num_frames)
+{
+    if (!audio || capacity_ == 0)
+    {
+        return 0;
+    }
+
+    size_t count = num_frames;
+    size_t pos   = begin_read(count);
+    size_t first = std::min(count, capacity_ - pos);
+    std::memcpy(audio, buffer_.data() + pos * num_channels_, first * num_channels_ * sizeof(float));
+    std::memcpy(audio + first * num_channels_, buffer_.data(),
+                (count - first) * num_channels_ * sizeof(float));
+    end_read(count, num_frames);
+    return count;
+}
+
+size_t AudioRing::read_planar(float* const* audio, size_t num_frames)
+{
+    if (!audio || capacity_ == 0)
+    {
+        return 0;
+    }
+
+    size_t count = num_frames;
+    size_t pos   = begin_read(count);
+    for (size_t done = 0; done < count;)
+    {
+        size_t run = std::min(count - done, capacity_ - pos);
+        for (uint16_t ch = 0; ch < num_channels_; ++ch)
+        {
+            detail::gather(audio[ch] + done, buffer_.data() + pos * num_channels_ + ch,
+                           num_channels_, run);
+        }
+        done += run;
+        pos = 0;
+    }
+    end_read(count, num_frames);
+    return count;
+}
+
+size_t AudioRing::get_read_available() const
+{
+    uint64_t read  = read_index_.load(std::memory_order_relaxed);
+    uint64_t write = write_index_.load(std::memory_order_acquire);
+    return static_cast<size_t>(write - read);
+}
+
+size_t AudioRing::get_write_available() const
+{
+    uint64_t write = write_index_.load(std::memory_order_relaxed);
+    uint64_t read  = read_index_.load(std::memory_order_acquire);
+    return capacity_ - static_cast<size_t>(write - read);
+}
+
+AudioRingStats AudioRing::get_stats() const
+{
+    AudioRingStats stats;
+    stats.capacity       = capacity_;
+    stats.fill           = get_read_available();
+    stats.high_water     = high_water_.load(std::memory_order_relaxed);
+    stats.overruns       = overruns_.load(std::memory_order_relaxed);
+    stats.dropped_frames = dropped_frames_.load(std::memory_order_relaxed);
+    stats.underruns      = underruns_.load(std::memory_order_relaxed);
+    stats.missing_frames = missing_frames_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ---------------------------
+// RingWorker
+// ---------------------------
+
+namespace detail
+{
+
+struct RingWorkerState
+{
+    Processor*               processor;
+    AudioRing*               input;
+    AudioRing*               output;
+    size_t                   block_frames;
+    std::chrono::nanoseconds idle_sleep;
+    std::vector<float>       block;
+    std::atomic<bool>        stopping;
+    std::atomic<uint64_t>    processed_blocks;
+    std::atomic<uint64_t>    failed_blocks;
+    std::atomic<int>         last_error;
+    std::thread              thread;
+
+    RingWorkerState(Processor& p, AudioRing& in, AudioRing& out)
+        : processor(&p)
+        , input(&in)
+        , output(&out)
+        , block_frames(p.get_config().num_frames)
+        , idle_sleep(static_cast<int64_t>(2.5e8 * static_cast<double>(block_frames) /
+                                          p.get_config().sample_rate))
+        , block(block_frames * p.get_config().num_channels, 0.0f)
+        , stopping(false)
+        , processed_blocks(0)
+        , failed_blocks(0)
+        , last_error(static_cast<int>(ErrorCode::Success))
+    {}
+};
+
+} // namespace detail
+
+namespace
+{
+
+void run_worker(detail::RingWorkerState* state)
+{
+    const uint16_t num_channels = state->input->get_num_channels();
+
+    while (!state->stopping.load(std::memory_order_relaxed))
+    {
+        if (state->input->get_read_available() < state->block_frames)
+        {
+            std::this_thread::sleep_for(state->idle_sleep);
+            continue;
+        }
+
+        state->input->read_interleaved(state->block.data(), state->block_frames);
+        ErrorCode rc = state->processor->process_interleaved(state->block.data(), num_channels,
+                                                             state->block_frames);
+        if (rc != ErrorCode::Success)
+        {
+            bump(state->failed_blocks, 1);
+            state->last_error.store(static_cast<int>(rc), std::memory_order_relaxed);
+        }
+        state->output->write_interleaved(state->block.data(), state->block_frames);
+        bump(state->processed_blocks, 1);
+    }
+}
+
+} // namespace
+
+RingWorker::RingWorker() {}
+
+RingWorker::RingWorker(std::unique_ptr<detail::RingWorkerState> state) : state_(std::move(state))
+{
+    state_->thread = std::thread(run_worker, state_.get());
+}
+
+RingWorker::~RingWorker()
+{
+    if (state_)
+    {
+        state_->stopping.store(true, std::memory_order_relaxed);
+        state_->thread.join();
+    }
+}
+
+RingWorker::RingWorker(RingWorker&& other) noexcept : state_(std::move(other.state_)) {}
+
+RingWorker& RingWorker::operator=(RingWorker&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (state_)
+        {
+            state_->stopping.store(true, std::memory_order_relaxed);
+            state_->thread.join();
+        }
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+Result<RingWorker> RingWorker::create(Processor& processor, AudioRing& input, AudioRing& output)
+{
+    if (!processor.is_initialized())
+    {
+        return Result<RingWorker>(RingWorker(), ErrorCode::ProcessorNotInitialized);
+    }
+
+    const ProcessorConfig& config = processor.get_config();
+    if (input.get_num_channels() != config.num_channels ||
+        output.get_num_channels() != config.num_channels ||
+        input.get_capacity() < config.num_frames || output.get_capacity() < config.num_frames)
+    {
+        return Result<RingWorker>(RingWorker(), ErrorCode::AudioConfigMismatch);
+    }
+
+    std::unique_ptr<detail::RingWorkerState> state(
+        new detail::RingWorkerState(processor, input, output));
+    return Result<RingWorker>(RingWorker(std::move(state)), ErrorCode::Success);
+}
+
+uint64_t RingWorker::get_processed_blocks() const
+{
+    return state_ ? state_->processed_blocks.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t RingWorker::get_failed_blocks() const
+{
+    return state_ ? state_->failed_blocks.load(std::memory_order_relaxed) : 0;
+}
+
+ErrorCode RingWorker::get_last_error() const
+{
+    return state_ ? static_cast<ErrorCode>(state_->last_error.load(std::memory_order_relaxed))
+                  : ErrorCode::Success;
+}
+
+} // namespace aic
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace aic
+{
+namespace detail
+{
+
+// Uniform (channel, frame) addressing for the three host buffer layouts. Every view exposes
+// `at(channel, frame)` and `stride()`, the distance between two consecutive frames of one channel,
+// so stages can be written once as a template and instantiated per layout.
+
+struct PlanarView
+{
+    float* const* audio;
+
+    float* at(uint16_t channel, size_t frame) const
+    {
+        return audio[channel] + frame;
+    }
+    size_t stride() const
+    {
+        return 1;
+    }
+};
+
+struct InterleavedView
+{
+    float*   audio;
+    uint16_t num_channels;
+
+    float* at(uint16_t channel, size_t frame) const
+    {
+        return audio + frame * num_channels + channel;
+    }
+    size_t stride() const
+    {
+        return num_channels;
+    }
+};
+
+struct SequentialView
+{
+    float* audio;
+    size_t num_frames;
+
+    float* at(uint16_t channel, size_t frame) const
+    {
+        return audio + channel * num_frames + frame;
+    }
+    size_t stride() const
+    {
+        return 1;
+    }
+};
+
+// Copies `count` samples from a strided source into a contiguous destination.
+inline void gather(float* dst, const float* src, size_t stride, size_t count)
+{
+    if (stride == 1)
+    {
+        std::memcpy(dst, src, count * sizeof(float));
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = src[i * stride];
+    }
+}
+
+// Copies `count` samples from a contiguous source into a strided destination.
+inline void scatter(float* dst, size_t stride, const float* src, size_t count)
+{
+    if (stride == 1)
+    {
+        std::memcpy(dst, src, count * sizeof(float));
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i * stride] = src[i];
+    }
+}
+
+} // namespace detail
+} // namespace aic
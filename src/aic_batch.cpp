@@ -0,0 +1,307 @@
+#include "aic_batch.hpp"
+
+#include "aic_cpu.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aic
+{
+
+namespace
+{
+
+// Spin iterations before an idle worker blocks. Covers back-to-back batches without a wake-up.
+const int kSpinIterations = 4000;
+
+} // namespace
+
+namespace detail
+{
+
+struct BatchState
+{
+    size_t                   num_threads;
+    std::vector<std::thread> workers;
+
+    std::mutex              mutex;
+    std::condition_variable wake;
+    std::atomic<uint64_t>   generation;
+    std::atomic<bool>       stopping;
+
+    // Batch published before each generation increment. A work unit is a run of items that
+    // share a processor; `order` lists item indices grouped by processor and `runs` holds the
+    // start of each run in `order`, followed by `order.size()`.
+    const BatchItem*    items;
+    ErrorCode*          results;
+    std::vector<size_t> order;
+    std::vector<size_t> runs;
+    size_t              num_runs;
+    std::atomic<size_t> next_run;
+    std::atomic<size_t> pending_workers;
+
+    BatchState(size_t threads, size_t max_items)
+        : num_threads(threads)
+        , generation(0)
+        , stopping(false)
+        , items(nullptr)
+        , results(nullptr)
+        , num_runs(0)
+        , next_run(0)
+        , pending_workers(0)
+    {
+        order.reserve(max_items);
+        runs.reserve(max_items + 1);
+    }
+};
+
+} // namespace detail
+
+namespace
+{
+
+ErrorCode process_item(const BatchItem& item)
+{
+    if (!item.processor)
+    {
+        return ErrorCode::NullPointer;
+    }
+    switch (item.layout)
+    {
+    case AudioLayout::Planar:
+        if (!item.planar)
+        {
+            return ErrorCode::NullPointer;
+        }
+        return item.processor->process_planar(item.planar, item.num_channels, item.num_frames);
+    case AudioLayout::Interleaved:
+        if (!item.buffer)
+        {
+            return ErrorCode::NullPointer;
+        }
+        return item.processor->process_interleaved(item.buffer, item.num_channels,
+                                                   item.num_frames);
+    case AudioLayout::Sequential:
+        if (!item.buffer)
+        {
+            return ErrorCode::NullPointer;
+        }
+        return item.processor->process_sequential(item.buffer, item.num_channels,
+                                                  item.num_frames);
+    }
+    return ErrorCode::ParameterOutOfRange;
+}
+
+// Claims runs until none are left. Shared by the workers and the calling thread.
+void drain(detail::BatchState* state)
+{
+    for (;;)
+    {
+        size_t run = state->next_run.fetch_add(1, std::memory_order_relaxed);
+        if (run >= state->num_runs)
+        {
+            return;
+        }
+        for (size_t i = state->runs[run]; i < state->runs[run + 1]; ++i)
+        {
+            size_t index          = state->order[i];
+            state->results[index] = process_item(state->items[index]);
+        }
+    }
+}
+
+void work(detail::BatchState* state)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        // Wait for the next generation: spin first, then block.
+        uint64_t generation = state->generation.load(std::memory_order_acquire);
+        for (int spin = 0; generation == seen && spin < kSpinIterations; ++spin)
+        {
+            detail::cpu_relax();
+            generation = state->generation.load(std::memory_order_acquire);
+        }
+        if (generation == seen)
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            generation = state->generation.load(std::memory_order_acquire);
+            while (generation == seen && !state->stopping.load(std::memory_order_relaxed))
+            {
+                state->wake.wait(lock);
+                generation = state->generation.load(std::memory_order_acquire);
+            }
+        }
+        if (state->stopping.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        seen = generation;
+        drain(state);
+        state->pending_workers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void stop(detail::BatchState* state)
+{
+    if (!state)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping.store(true, std::memory_order_relaxed);
+    }
+    state->wake.notify_all();
+    for (std::thread& worker : state->workers)
+    {
+        worker.join();
+    }
+    state->workers.clear();
+}
+
+} // namespace
+
+BatchProcessor::BatchProcessor() {}
+
+BatchProcessor::BatchProcessor(std::unique_ptr<detail::BatchState> state)
+    : state_(std::move(state))
+{
+    for (size_t i = 1; i < state_->num_threads; ++i)
+    {
+        state_->workers.push_back(std::thread(work, state_.get()));
+    }
+}
+
+BatchProcessor::~BatchProcessor()
+{
+    stop(state_.get());
+}
+
+BatchProcessor::BatchProcessor(BatchProcessor&& other) noexcept : state_(std::move(other.state_))
+{}
+
+BatchProcessor& BatchProcessor::operator=(BatchProcessor&& other) noexcept
+{
+    if (this != &other)
+    {
+        stop(state_.get());
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+Result<BatchProcessor> BatchProcessor::create(size_t num_threads, size_t max_items)
+{
+    if (num_threads == 0)
+    {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    std::unique_ptr<detail::BatchState> state(new detail::BatchState(num_threads, max_items));
+    return Result<BatchProcessor>(BatchProcessor(std::move(state)), ErrorCode::Success);
+}
+
+ErrorCode BatchProcessor::process(const BatchItem* items, size_t num_items, ErrorCode* results)
+{
+    if (!items || !results)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (!state_)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+    if (num_items == 0)
+    {
+        return ErrorCode::Success;
+    }
+
+    detail::BatchState* state = state_.get();
+
+    // Group items by processor; ties are ordered by index so items sharing a processor keep
+    // their order inside a run. std::sort is used because std::stable_sort may allocate.
+    state->order.resize(num_items);
+    for (size_t i = 0; i < num_items; ++i)
+    {
+        state->order[i] = i;
+    }
+    std::sort(state->order.begin(), state->order.end(),
+              [items](size_t a, size_t b)
+              {
+                  if (items[a].processor != items[b].processor)
+                  {
+                      return std::less<Processor*>()(items[a].processor, items[b].processor);
+                  }
+                  return a < b;
+              });
+
+    state->runs.clear();
+    for (size_t i = 0; i < num_items; ++i)
+    {
+        if (i == 0 || items[state->order[i]].processor != items[state->order[i - 1]].processor)
+        {
+            state->runs.push_back(i);
+        }
+    }
+    state->runs.push_back(num_items);
+
+    state->items    = items;
+    state->results  = results;
+    state->num_runs = state->runs.size() - 1;
+    state->next_run.store(0, std::memory_order_relaxed);
+
+    const size_t num_workers = state->workers.size();
+    if (num_workers > 0 && state->num_runs > 1)
+    {
+        state->pending_workers.store(num_workers, std::memory_order_relaxed);
+        {
+            // Publishing under the lock pairs with the predicate check of blocked workers.
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->generation.fetch_add(1, std::memory_order_release);
+        }
+        state->wake.notify_all();
+
+        drain(state);
+
+        // Barrier: every worker checks in once per generation. Yield after a short spin so a
+        // worker that still has to wake up can use this core.
+        for (int spin = 0; state->pending_workers.load(std::memory_order_acquire) != 0; ++spin)
+        {
+            if (spin < kSpinIterations)
+            {
+                detail::cpu_relax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+    else
+    {
+        drain(state);
+    }
+
+    for (size_t i = 0; i < num_items; ++i)
+    {
+        if (results[i] != ErrorCode::Success)
+        {
+            return results[i];
+        }
+    }
+    return ErrorCode::Success;
+}
+
+size_t BatchProcessor::get_num_threads() const
+{
+    return state_ ? state_->num_threads : 0;
+}
+
+} // namespace aic
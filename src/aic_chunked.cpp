@@ -0,0 +1,284 @@
+#include "aic_chunked.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aic
+{
+
+namespace
+{
+
+struct ChunkResult
+{
+    // Output of [first, end) of the chunk: its own frames followed by the crossfade tail
+    std::vector<float> audio;
+    size_t             num_frames;
+};
+
+struct ChunkedState
+{
+    const Model&         model;
+    const std::string&   license_key;
+    const ChunkedConfig& config;
+    const ChunkSource&   source;
+    const ChunkSetup&    setup;
+    size_t               block_frames;
+    uint64_t             num_chunks;
+    uint64_t             max_in_flight;
+
+    std::mutex                      mutex;
+    std::condition_variable         changed;
+    uint64_t                        next_chunk;
+    uint64_t                        next_to_write;
+    ErrorCode                       error;
+    std::map<uint64_t, ChunkResult> done;
+    std::mutex                      source_mutex;
+
+    ChunkedState(const Model& m, const std::string& license, const ChunkedConfig& c,
+                 const ChunkSource& s, const ChunkSetup& setup_fn)
+        : model(m)
+        , license_key(license)
+        , config(c)
+        , source(s)
+        , setup(setup_fn)
+        , block_frames(0)
+        , num_chunks(0)
+        , max_in_flight(0)
+        , next_chunk(0)
+        , next_to_write(0)
+        , error(ErrorCode::Success)
+    {}
+
+    // Records the first error and wakes everyone up to stop. Call with `mutex` held.
+    void fail(ErrorCode err)
+    {
+        if (error == ErrorCode::Success)
+        {
+            error = err;
+        }
+        changed.notify_all();
+    }
+};
+
+ErrorCode process_chunk(ChunkedState& state, Processor& processor,
+                        const ProcessorContext& context, size_t delay, uint64_t index,
+                        std::vector<float>& buffer, ChunkResult& result)
+{
+    const ChunkedConfig& config   = state.config;
+    const size_t         channels = config.num_channels;
+    const uint64_t       total    = config.total_frames;
+
+    const uint64_t first = index * config.chunk_frames;
+    const uint64_t last  = std::min<uint64_t>(first + config.chunk_frames, total);
+    const uint64_t end   = std::min<uint64_t>(last + config.crossfade_frames, total);
+    const uint64_t warm  = index == 0 ? 0 : std::min<uint64_t>(config.overlap_frames, first);
+    const uint64_t start = first - warm;
+
+    // Output frame i of a fresh processor started at `start` belongs to input frame
+    // start + i - delay, so `warm + delay` frames are dropped.
+    const uint64_t needed = warm + delay + (end - first);
+    const size_t   frames = static_cast<size_t>(
+        (needed + state.block_frames - 1) / state.block_frames * state.block_frames);
+    const size_t available = static_cast<size_t>(std::min<uint64_t>(frames, total - start));
+
+    buffer.assign(frames * channels, 0.0f);
+    {
+        std::lock_guard<std::mutex> lock(state.source_mutex);
+        ErrorCode err = state.source(start, buffer.data(), available);
+        if (err != ErrorCode::Success)
+        {
+            return err;
+        }
+    }
+
+    ErrorCode err = context.reset();
+    for (size_t offset = 0; offset < frames && err == ErrorCode::Success;
+         offset += state.block_frames)
+    {
+        err = processor.process_interleaved(buffer.data() + offset * channels,
+                                            config.num_channels, state.block_frames);
+    }
+    if (err != ErrorCode::Success)
+    {
+        return err;
+    }
+
+    const size_t skip = static_cast<size_t>(warm + delay);
+    result.num_frames = static_cast<size_t>(end - first);
+    result.audio.assign(buffer.begin() + skip * channels,
+                        buffer.begin() + (skip + result.num_frames) * channels);
+    return ErrorCode::Success;
+}
+
+void run_worker(ChunkedState& state)
+{
+    const ChunkedConfig& config = state.config;
+
+    auto processor_result = Processor::create(state.model, state.license_key);
+    if (!processor_result.ok())
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.fail(processor_result.error);
+        return;
+    }
+    Processor processor = processor_result.take();
+    ErrorCode err       = processor.initialize(config.sample_rate, config.num_channels,
+                                               state.block_frames, false);
+    auto      context   = processor.create_context();
+    if (err == ErrorCode::Success)
+    {
+        err = context.error;
+    }
+    if (err == ErrorCode::Success && state.setup)
+    {
+        err = state.setup(context.value);
+    }
+    if (err != ErrorCode::Success)
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.fail(err);
+        return;
+    }
+    const size_t delay = context.value.get_output_delay();
+
+    std::vector<float> buffer;
+    for (;;)
+    {
+        uint64_t index;
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.changed.wait(lock,
+                               [&state]
+                               {
+                                   return state.error != ErrorCode::Success ||
+                                          state.next_chunk >= state.num_chunks ||
+                                          state.next_chunk <
+                                              state.next_to_write + state.max_in_flight;
+                               });
+            if (state.error != ErrorCode::Success || state.next_chunk >= state.num_chunks)
+            {
+                return;
+            }
+            index = state.next_chunk++;
+        }
+
+        ChunkResult result;
+        err = process_chunk(state, processor, context.value, delay, index, buffer, result);
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (err != ErrorCode::Success)
+        {
+            state.fail(err);
+            return;
+        }
+        state.done[index] = std::move(result);
+        state.changed.notify_all();
+    }
+}
+
+} // namespace
+
+ErrorCode process_chunked(const Model&         model,
+                          const std::string&   license_key,
+                          const ChunkedConfig& config,
+                          const ChunkSource&   source,
+                          const ChunkSink&     sink,
+                          const ChunkSetup&    setup)
+{
+    if (!source || !sink)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (config.sample_rate == 0 || config.num_channels == 0 || config.chunk_frames == 0 ||
+        config.crossfade_frames > config.chunk_frames)
+    {
+        return ErrorCode::ParameterOutOfRange;
+    }
+    if (config.total_frames == 0)
+    {
+        return ErrorCode::Success;
+    }
+
+    ChunkedState state(model, license_key, config, source, setup);
+    state.block_frames = config.num_frames ? config.num_frames
+                                           : model.get_optimal_num_frames(config.sample_rate);
+    state.num_chunks   = (config.total_frames + config.chunk_frames - 1) / config.chunk_frames;
+
+    size_t num_threads = config.num_threads;
+    if (num_threads == 0)
+    {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads         = static_cast<size_t>(std::min<uint64_t>(num_threads, state.num_chunks));
+    state.max_in_flight = 2 * num_threads;
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        workers.push_back(std::thread(run_worker, std::ref(state)));
+    }
+
+    // Stitches the chunks in order. `tail` holds the frames the previous chunk produced past its
+    // end, which are faded into the start of the current one.
+    const size_t       channels = config.num_channels;
+    std::vector<float> tail;
+    size_t             tail_frames = 0;
+    for (uint64_t index = 0; index < state.num_chunks; ++index)
+    {
+        ChunkResult result;
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.changed.wait(lock,
+                               [&state, index]
+                               {
+                                   return state.error != ErrorCode::Success ||
+                                          state.done.count(index) != 0;
+                               });
+            if (state.error != ErrorCode::Success)
+            {
+                break;
+            }
+            result = std::move(state.done[index]);
+            state.done.erase(index);
+            state.next_to_write = index + 1;
+            state.changed.notify_all();
+        }
+
+        float* audio = result.audio.data();
+        for (size_t i = 0; i < tail_frames; ++i)
+        {
+            const float gain = (static_cast<float>(i) + 0.5f) / static_cast<float>(tail_frames);
+            for (size_t c = 0; c < channels; ++c)
+            {
+                float& sample = audio[i * channels + c];
+                sample        = tail[i * channels + c] * (1.0f - gain) + sample * gain;
+            }
+        }
+
+        const uint64_t first  = index * config.chunk_frames;
+        const size_t   frames = static_cast<size_t>(
+            std::min<uint64_t>(config.chunk_frames, config.total_frames - first));
+        ErrorCode err = sink(audio, frames);
+        if (err != ErrorCode::Success)
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.fail(err);
+            break;
+        }
+        tail_frames = result.num_frames - frames;
+        tail.assign(audio + frames * channels, audio + result.num_frames * channels);
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    return state.error;
+}
+
+} // namespace aic
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "aic_simd.hpp"
+
+// Compile-time architecture switches and per-function target attributes for the vectorized
+// kernels. Kernels for instruction sets above the compiler baseline are compiled with a target
+// attribute and only called after runtime detection, so no global compiler flags are required.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AIC_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define AIC_SIMD_X86 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define AIC_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define AIC_SIMD_NEON 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AIC_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define AIC_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define AIC_TARGET_AVX2
+#define AIC_TARGET_AVX512
+#endif
+
+namespace aic
+{
+namespace detail
+{
+
+// Level read by the kernels on every call; see set_simd_level.
+SimdLevel active_simd_level();
+
+// Spin-wait hint for busy loops; lets the sibling hyper-thread run.
+inline void cpu_relax()
+{
+#if AIC_SIMD_X86
+    _mm_pause();
+#elif AIC_SIMD_NEON && (defined(__GNUC__) || defined(__clang__))
+    __asm__ __volatile__("yield");
+#endif
+}
+
+} // namespace detail
+} // namespace aic
@@ -0,0 +1,404 @@
+#include "aic_latency.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace aic
+{
+
+namespace
+{
+
+const uint64_t kSubBuckets = 1ull << detail::kLatencySubBucketBits;
+
+// Index of the highest set bit; `value` must not be zero.
+size_t highest_bit(uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return index;
+#else
+    return 63 - static_cast<size_t>(__builtin_clzll(value));
+#endif
+}
+
+size_t bucket_index(uint64_t ns)
+{
+    if (ns < kSubBuckets)
+    {
+        return static_cast<size_t>(ns);
+    }
+    const size_t msb = highest_bit(ns);
+    if (msb >= detail::kLatencyMaxBits)
+    {
+        return detail::kLatencyNumBuckets - 1;
+    }
+    // The top kLatencySubBucketBits + 1 bits select the bucket: the leading one picks the
+    // power of two, the bits below it the linear sub-bucket.
+    const size_t shift = msb - detail::kLatencySubBucketBits;
+    return ((shift + 1) << detail::kLatencySubBucketBits) +
+           static_cast<size_t>((ns >> shift) - kSubBuckets);
+}
+
+// Deadline events held until a control thread polls them.
+const size_t kEventQueueCapacity = 256;
+
+// Weight of the newest call in the recent real-time factor.
+const float kRecentWeight = 1.0f / 16.0f;
+
+typedef std::chrono::steady_clock Clock;
+
+uint64_t elapsed_ns(Clock::time_point start)
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+// Single-writer counter update: a plain load and store, no read-modify-write.
+void bump(std::atomic<uint64_t>& counter, uint64_t amount)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+} // namespace
+
+namespace detail
+{
+
+// Everything the audio thread writes. Counters have a single writer (the thread calling the
+// process functions); readers only load them. The event queue is single-producer,
+// single-consumer, with `poll_mutex` serializing consumers.
+struct InstrumentationState
+{
+    LatencyHistogram      histogram;
+    std::atomic<float>    deadline_fraction;
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> current_streak;
+    std::atomic<uint64_t> longest_streak;
+    std::atomic<uint64_t> dropped_events;
+    std::atomic<uint64_t> processing_ns;
+    std::atomic<uint64_t> audio_ns;
+    std::atomic<float>    recent_rtf;
+    uint64_t              call_index;
+
+    DeadlineEvent         events[kEventQueueCapacity];
+    std::atomic<uint64_t> event_write;
+    std::atomic<uint64_t> event_read;
+    std::mutex            poll_mutex;
+
+    explicit InstrumentationState(float fraction)
+        : deadline_fraction(fraction)
+        , calls(0)
+        , misses(0)
+        , current_streak(0)
+        , longest_streak(0)
+        , dropped_events(0)
+        , processing_ns(0)
+        , audio_ns(0)
+        , recent_rtf(0.0f)
+        , call_index(0)
+        , event_write(0)
+        , event_read(0)
+    {}
+};
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------------------------
+// LatencySnapshot
+// ---------------------------------------------------------------------------------------------
+
+LatencySnapshot::LatencySnapshot()
+    : counts(detail::kLatencyNumBuckets, 0)
+    , count(0)
+    , sum_ns(0)
+    , min_ns(0)
+    , max_ns(0)
+{}
+
+void LatencySnapshot::merge(const LatencySnapshot& other)
+{
+    if (other.count == 0)
+    {
+        return;
+    }
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+    min_ns = count == 0 ? other.min_ns : std::min(min_ns, other.min_ns);
+    max_ns = std::max(max_ns, other.max_ns);
+    count += other.count;
+    sum_ns += other.sum_ns;
+}
+
+uint64_t LatencySnapshot::get_percentile(double quantile) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    quantile = quantile > 0.0 ? std::min(quantile, 1.0) : 0.0;
+
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(count) + 0.5);
+    rank          = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            return std::min(get_bucket_upper_bound(i), max_ns);
+        }
+    }
+    return max_ns;
+}
+
+double LatencySnapshot::get_mean() const
+{
+    return count == 0 ? 0.0 : static_cast<double>(sum_ns) / static_cast<double>(count);
+}
+
+uint64_t LatencySnapshot::get_bucket_upper_bound(size_t index)
+{
+    if (index < kSubBuckets)
+    {
+        return index;
+    }
+    if (index >= detail::kLatencyNumBuckets - 1)
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    const size_t   shift = (index >> detail::kLatencySubBucketBits) - 1;
+    const uint64_t lower = (kSubBuckets + (index & (kSubBuckets - 1))) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+// ---------------------------------------------------------------------------------------------
+// LatencyHistogram
+// ---------------------------------------------------------------------------------------------
+
+LatencyHistogram::LatencyHistogram()
+    : sum_ns_(0)
+    , min_ns_(std::numeric_limits<uint64_t>::max())
+    , max_ns_(0)
+{
+    for (size_t i = 0; i < detail::kLatencyNumBuckets; ++i)
+    {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(uint64_t duration_ns)
+{
+    // Single writer: plain load + store is enough and avoids locked instructions.
+    std::atomic<uint64_t>& bucket = counts_[bucket_index(duration_ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum_ns_.store(sum_ns_.load(std::memory_order_relaxed) + duration_ns,
+                  std::memory_order_relaxed);
+    if (duration_ns < min_ns_.load(std::memory_order_relaxed))
+    {
+        min_ns_.store(duration_ns, std::memory_order_relaxed);
+    }
+    if (duration_ns > max_ns_.load(std::memory_order_relaxed))
+    {
+        max_ns_.store(duration_ns, std::memory_order_relaxed);
+    }
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const
+{
+    LatencySnapshot snapshot;
+    for (size_t i = 0; i < detail::kLatencyNumBuckets; ++i)
+    {
+        snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.counts[i];
+    }
+    snapshot.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+    snapshot.max_ns = max_ns_.load(std::memory_order_relaxed);
+    snapshot.min_ns = snapshot.count == 0 ? 0 : min_ns_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+// ---------------------------------------------------------------------------------------------
+// InstrumentedProcessor
+// ---------------------------------------------------------------------------------------------
+
+InstrumentedProcessor::InstrumentedProcessor(Processor& processor, float deadline_fraction)
+    : processor_(&processor)
+    , state_(new detail::InstrumentationState(deadline_fraction > 0.0f ? deadline_fraction
+                                                                       : 1.0f))
+{}
+
+InstrumentedProcessor::~InstrumentedProcessor() {}
+
+InstrumentedProcessor::InstrumentedProcessor(InstrumentedProcessor&& other) noexcept
+    : processor_(other.processor_)
+    , state_(std::move(other.state_))
+{}
+
+InstrumentedProcessor& InstrumentedProcessor::operator=(InstrumentedProcessor&& other) noexcept
+{
+    processor_ = other.processor_;
+    state_     = std::move(other.state_);
+    return *this;
+}
+
+ErrorCode InstrumentedProcessor::process_planar(float* const* audio,
+                                                uint16_t      num_channels,
+                                                size_t        num_frames)
+{
+    const Clock::time_point start = Clock::now();
+    ErrorCode               rc    = processor_->process_planar(audio, num_channels, num_frames);
+    account(elapsed_ns(start), num_frames);
+    return rc;
+}
+
+ErrorCode InstrumentedProcessor::process_interleaved(float*   audio,
+                                                     uint16_t num_channels,
+                                                     size_t   num_frames)
+{
+    const Clock::time_point start = Clock::now();
+    ErrorCode rc = processor_->process_interleaved(audio, num_channels, num_frames);
+    account(elapsed_ns(start), num_frames);
+    return rc;
+}
+
+ErrorCode InstrumentedProcessor::process_sequential(float*   audio,
+                                                    uint16_t num_channels,
+                                                    size_t   num_frames)
+{
+    const Clock::time_point start = Clock::now();
+    ErrorCode rc = processor_->process_sequential(audio, num_channels, num_frames);
+    account(elapsed_ns(start), num_frames);
+    return rc;
+}
+
+void InstrumentedProcessor::account(uint64_t duration_ns, size_t num_frames)
+{
+    detail::InstrumentationState& state = *state_;
+    state.histogram.record(duration_ns);
+
+    const uint64_t call_index  = state.call_index++;
+    const uint32_t sample_rate = processor_->get_config().sample_rate;
+    if (sample_rate == 0 || num_frames == 0)
+    {
+        return;
+    }
+
+    const double audio_ns =
+        1e9 * static_cast<double>(num_frames) / static_cast<double>(sample_rate);
+    const uint64_t budget_ns = static_cast<uint64_t>(
+        audio_ns * state.deadline_fraction.load(std::memory_order_relaxed));
+
+    const bool  first  = state.calls.load(std::memory_order_relaxed) == 0;
+    const float rtf    = static_cast<float>(static_cast<double>(duration_ns) / audio_ns);
+    const float recent = state.recent_rtf.load(std::memory_order_relaxed);
+    state.recent_rtf.store(first ? rtf : recent + (rtf - recent) * kRecentWeight,
+                           std::memory_order_relaxed);
+
+    bump(state.calls, 1);
+    bump(state.processing_ns, duration_ns);
+    bump(state.audio_ns, static_cast<uint64_t>(audio_ns));
+
+    if (duration_ns <= budget_ns)
+    {
+        state.current_streak.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    bump(state.misses, 1);
+    const uint64_t streak = state.current_streak.load(std::memory_order_relaxed) + 1;
+    state.current_streak.store(streak, std::memory_order_relaxed);
+    if (streak > state.longest_streak.load(std::memory_order_relaxed))
+    {
+        state.longest_streak.store(streak, std::memory_order_relaxed);
+    }
+
+    const uint64_t write = state.event_write.load(std::memory_order_relaxed);
+    if (write - state.event_read.load(std::memory_order_acquire) >= kEventQueueCapacity)
+    {
+        bump(state.dropped_events, 1);
+        return;
+    }
+    DeadlineEvent& event = state.events[write % kEventQueueCapacity];
+    event.call_index     = call_index;
+    event.duration_ns    = duration_ns;
+    event.budget_ns      = budget_ns;
+    event.num_frames     = num_frames;
+    event.streak         = streak;
+    state.event_write.store(write + 1, std::memory_order_release);
+}
+
+LatencySnapshot InstrumentedProcessor::snapshot() const
+{
+    return state_->histogram.snapshot();
+}
+
+const LatencyHistogram& InstrumentedProcessor::get_histogram() const
+{
+    return state_->histogram;
+}
+
+void InstrumentedProcessor::set_deadline_fraction(float fraction)
+{
+    if (fraction > 0.0f)
+    {
+        state_->deadline_fraction.store(fraction, std::memory_order_relaxed);
+    }
+}
+
+float InstrumentedProcessor::get_deadline_fraction() const
+{
+    return state_->deadline_fraction.load(std::memory_order_relaxed);
+}
+
+DeadlineStats InstrumentedProcessor::get_deadline_stats() const
+{
+    const detail::InstrumentationState& state = *state_;
+
+    DeadlineStats stats;
+    stats.calls          = state.calls.load(std::memory_order_relaxed);
+    stats.misses         = state.misses.load(std::memory_order_relaxed);
+    stats.current_streak = state.current_streak.load(std::memory_order_relaxed);
+    stats.longest_streak = state.longest_streak.load(std::memory_order_relaxed);
+    stats.dropped_events = state.dropped_events.load(std::memory_order_relaxed);
+
+    const uint64_t audio_ns = state.audio_ns.load(std::memory_order_relaxed);
+    stats.realtime_factor =
+        audio_ns == 0 ? 0.0
+                      : static_cast<double>(state.processing_ns.load(std::memory_order_relaxed)) /
+                            static_cast<double>(audio_ns);
+    stats.recent_realtime_factor = state.recent_rtf.load(std::memory_order_relaxed);
+    return stats;
+}
+
+size_t InstrumentedProcessor::poll_deadline_events(
+    const std::function<void(const DeadlineEvent&)>& callback)
+{
+    detail::InstrumentationState& state = *state_;
+    std::lock_guard<std::mutex>   lock(state.poll_mutex);
+
+    const uint64_t write     = state.event_write.load(std::memory_order_acquire);
+    uint64_t       read      = state.event_read.load(std::memory_order_relaxed);
+    size_t         delivered = 0;
+    for (; read != write; ++read, ++delivered)
+    {
+        // Copy first: the slot may be reused as soon as the read index moves past it.
+        DeadlineEvent event = state.events[read % kEventQueueCapacity];
+        state.event_read.store(read + 1, std::memory_order_release);
+        callback(event);
+    }
+    return delivered;
+}
+
+} // namespace aic
@@ -0,0 +1,244 @@
+#include "aic_mapped_audio.hpp"
+
+#include "aic_mapped_file.hpp"
+#include "aic_wav_header.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace aic
+{
+
+namespace
+{
+
+const size_t kScratchAlignment = 64;
+
+// Input samples may sit at any byte offset behind a WAV header; memcpy compiles to unaligned
+// loads.
+float load_sample(const uint8_t* samples, size_t index)
+{
+    float value;
+    std::memcpy(&value, samples + index * sizeof(float), sizeof(float));
+    return value;
+}
+
+// Copies `frames` interleaved frames starting at `first` into the channel-major scratch block
+// and zero-fills the rest of the block.
+void load_block(const uint8_t* samples, uint64_t first, size_t frames, uint16_t num_channels,
+                size_t block_frames, float* scratch)
+{
+    if (num_channels == 1)
+    {
+        std::memcpy(scratch, samples + first * sizeof(float), frames * sizeof(float));
+    }
+    else
+    {
+        const size_t base = static_cast<size_t>(first) * num_channels;
+        for (uint16_t c = 0; c < num_channels; ++c)
+        {
+            float* channel = scratch + c * block_frames;
+            for (size_t i = 0; i < frames; ++i)
+            {
+                channel[i] = load_sample(samples, base + i * num_channels + c);
+            }
+        }
+    }
+    for (uint16_t c = 0; c < num_channels; ++c)
+    {
+        std::fill(scratch + c * block_frames + frames, scratch + (c + 1) * block_frames, 0.0f);
+    }
+}
+
+// Interleaves frames [begin, end) of the channel-major scratch block into the output, starting
+// at output frame `first`.
+void store_block(const float* scratch, size_t begin, size_t end, uint16_t num_channels,
+                 size_t block_frames, float* output, uint64_t first)
+{
+    float* out = output + static_cast<size_t>(first) * num_channels;
+    if (num_channels == 1)
+    {
+        std::memcpy(out, scratch + begin, (end - begin) * sizeof(float));
+        return;
+    }
+    for (size_t i = begin; i < end; ++i)
+    {
+        for (uint16_t c = 0; c < num_channels; ++c)
+        {
+            *out++ = scratch[c * block_frames + i];
+        }
+    }
+}
+
+// Writes a file that consists of the header only; an empty mapping cannot be created.
+ErrorCode write_header_only(const std::string& path, const std::vector<uint8_t>& header)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        return ErrorCode::FileSystemError;
+    }
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+    ok      = std::fclose(file) == 0 && ok;
+    return ok ? ErrorCode::Success : ErrorCode::FileSystemError;
+}
+
+} // namespace
+
+// ---------------------------
+// MappedAudioFile
+// ---------------------------
+
+MappedAudioFile::MappedAudioFile()
+    : samples_(nullptr)
+    , format_()
+    , num_frames_(0)
+    , is_wav_(false)
+{}
+
+Result<MappedAudioFile> MappedAudioFile::open_wav(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+    {
+        return Result<MappedAudioFile>(MappedAudioFile(), ErrorCode::FileSystemError);
+    }
+    WavFormat  format     = {};
+    uint64_t   num_frames = 0;
+    ErrorCode  err        = detail::read_wav_header(file, format, num_frames);
+    const long offset     = std::ftell(file);
+    std::fclose(file);
+    if (err != ErrorCode::Success)
+    {
+        return Result<MappedAudioFile>(MappedAudioFile(), err);
+    }
+    if (format.sample_format != SampleFormat::Float32)
+    {
+        return Result<MappedAudioFile>(MappedAudioFile(), ErrorCode::AudioConfigUnsupported);
+    }
+
+    auto mapped = detail::MappedFile::map(path, false);
+    if (!mapped.ok() || offset < 0 || static_cast<size_t>(offset) > mapped.value->size())
+    {
+        return Result<MappedAudioFile>(MappedAudioFile(), ErrorCode::FileSystemError);
+    }
+    std::shared_ptr<detail::MappedFile> data = mapped.take();
+    data->advise_sequential();
+
+    // Files with an open length or a truncated data chunk end where the file ends.
+    const size_t block_align = format.num_channels * sizeof(float);
+    const size_t available   = (data->size() - static_cast<size_t>(offset)) / block_align;
+
+    MappedAudioFile audio;
+    audio.samples_    = data->data() + offset;
+    audio.format_     = format;
+    audio.num_frames_ = std::min<uint64_t>(num_frames, available);
+    audio.is_wav_     = true;
+    audio.mapping_    = data;
+    return Result<MappedAudioFile>(std::move(audio), ErrorCode::Success);
+}
+
+Result<MappedAudioFile> MappedAudioFile::open_raw(const std::string& path, uint32_t sample_rate,
+                                                  uint16_t num_channels)
+{
+    if (sample_rate == 0 || num_channels == 0)
+    {
+        return Result<MappedAudioFile>(MappedAudioFile(), ErrorCode::ParameterOutOfRange);
+    }
+    auto mapped = detail::MappedFile::map(path, false);
+    if (!mapped.ok())
+    {
+        return Result<MappedAudioFile>(MappedAudioFile(), ErrorCode::FileSystemError);
+    }
+    std::shared_ptr<detail::MappedFile> data = mapped.take();
+    data->advise_sequential();
+
+    MappedAudioFile audio;
+    audio.samples_              = data->data();
+    audio.format_.sample_rate   = sample_rate;
+    audio.format_.num_channels  = num_channels;
+    audio.format_.sample_format = SampleFormat::Float32;
+    audio.num_frames_           = data->size() / (num_channels * sizeof(float));
+    audio.mapping_              = data;
+    return Result<MappedAudioFile>(std::move(audio), ErrorCode::Success);
+}
+
+// ---------------------------
+// Mapped processing
+// ---------------------------
+
+ErrorCode process_mapped_file(Processor&              processor,
+                              const ProcessorContext& context,
+                              const MappedAudioFile&  input,
+                              const std::string&      output_path)
+{
+    if (!processor.is_initialized())
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+    const ProcessorConfig& config = processor.get_config();
+    const WavFormat&       format = input.get_format();
+    if (config.sample_rate != format.sample_rate || config.num_channels != format.num_channels ||
+        config.allow_variable_frames)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+
+    const uint16_t channels     = format.num_channels;
+    const size_t   block_frames = config.num_frames;
+    const uint64_t total        = input.get_num_frames();
+    const uint64_t delay        = context.get_output_delay();
+    const size_t   data_bytes   = static_cast<size_t>(total) * channels * sizeof(float);
+
+    const std::vector<uint8_t> header =
+        input.is_wav() ? detail::make_wav_header(format, total) : std::vector<uint8_t>();
+    if (total == 0)
+    {
+        return write_header_only(output_path, header);
+    }
+
+    auto mapped = detail::MappedOutputFile::create(output_path, header.size() + data_bytes);
+    if (!mapped.ok())
+    {
+        return mapped.error;
+    }
+    std::unique_ptr<detail::MappedOutputFile> output = mapped.take();
+    std::memcpy(output->data(), header.data(), header.size());
+    output->advise_sequential();
+    // The header is a multiple of 4 bytes and the mapping starts on a page boundary.
+    float* samples = reinterpret_cast<float*>(output->data() + header.size());
+
+    const uint8_t* source = static_cast<const uint8_t*>(input.get_samples());
+
+    std::vector<float> storage(block_frames * channels + kScratchAlignment / sizeof(float));
+    const uintptr_t    address = reinterpret_cast<uintptr_t>(storage.data());
+    float*             scratch = reinterpret_cast<float*>(
+        (address + kScratchAlignment - 1) / kScratchAlignment * kScratchAlignment);
+
+    ErrorCode err = context.reset();
+    // Input frame `first` comes out of the processor as output frame `first + delay`.
+    for (uint64_t first = 0; first < total + delay && err == ErrorCode::Success;
+         first += block_frames)
+    {
+        const size_t frames =
+            first < total ? static_cast<size_t>(std::min<uint64_t>(block_frames, total - first))
+                          : 0;
+        load_block(source, first, frames, channels, block_frames, scratch);
+
+        err = processor.process_sequential(scratch, channels, block_frames);
+
+        const size_t begin = first < delay ? static_cast<size_t>(delay - first) : 0;
+        const size_t end   = static_cast<size_t>(
+            std::min<uint64_t>(block_frames, total + delay - first));
+        if (err == ErrorCode::Success && begin < end)
+        {
+            store_block(scratch, begin, end, channels, block_frames, samples,
+                        first + begin - delay);
+        }
+    }
+    return err;
+}
+
+} // namespace aic
@@ -0,0 +1,367 @@
+#include "aic_mapped_file.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace aic
+{
+namespace detail
+{
+
+namespace
+{
+
+#if defined(_WIN32)
+// Converts a UTF-8 path, like everywhere else in the wrapper, for the wide Windows APIs. Returns
+// an empty string for invalid input.
+std::wstring to_wide(const std::string& path)
+{
+    int wide_len = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (wide_len <= 0)
+    {
+        return std::wstring();
+    }
+    std::vector<wchar_t> wide(static_cast<size_t>(wide_len));
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wide.data(), wide_len);
+    return std::wstring(wide.data());
+}
+#endif
+
+#if !defined(__linux__)
+// Reads one byte per page so the OS faults the whole mapping in up front.
+void touch_pages(const uint8_t* data, size_t size)
+{
+    const size_t     page = 4096;
+    volatile uint8_t sink = 0;
+    for (size_t offset = 0; offset < size; offset += page)
+    {
+        sink = static_cast<uint8_t>(sink + data[offset]);
+    }
+    (void) sink;
+}
+#endif
+
+} // namespace
+
+MappedFile::MappedFile()
+    : data_(nullptr)
+    , size_(0)
+#if defined(_WIN32)
+    , mapping_(nullptr)
+#endif
+{}
+
+#if defined(_WIN32)
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_)
+    {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+}
+
+Result<std::shared_ptr<MappedFile>> MappedFile::map(const std::string& path, bool prefault)
+{
+    typedef Result<std::shared_ptr<MappedFile>> MapResult;
+
+    if (path.empty())
+    {
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::ModelFilePathInvalid);
+    }
+
+    const std::wstring wide = to_wide(path);
+    if (wide.empty())
+    {
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::ModelFilePathInvalid);
+    }
+
+    HANDLE file = CreateFileW(wide.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::FileSystemError);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::FileSystemError);
+    }
+    if (file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::ModelInvalid);
+    }
+
+    // The mapping object keeps the file open; the file handle is no longer needed.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::FileSystemError);
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::FileSystemError);
+    }
+
+    std::shared_ptr<MappedFile> mapped(new MappedFile());
+    mapped->data_    = static_cast<const uint8_t*>(view);
+    mapped->size_    = static_cast<size_t>(file_size.QuadPart);
+    mapped->mapping_ = mapping;
+
+    if (prefault)
+    {
+        touch_pages(mapped->data_, mapped->size_);
+    }
+
+    return MapResult(mapped, ErrorCode::Success);
+}
+
+size_t MappedFile::resident_bytes() const
+{
+    return 0;
+}
+
+void MappedFile::advise_sequential() const {}
+
+MappedOutputFile::MappedOutputFile() : data_(nullptr), size_(0), mapping_(nullptr) {}
+
+MappedOutputFile::~MappedOutputFile()
+{
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_)
+    {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    }
+}
+
+Result<std::unique_ptr<MappedOutputFile>> MappedOutputFile::create(const std::string& path,
+                                                                   size_t             size)
+{
+    typedef Result<std::unique_ptr<MappedOutputFile>> CreateResult;
+
+    if (size == 0)
+    {
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::ParameterOutOfRange);
+    }
+    const std::wstring wide = to_wide(path);
+    if (wide.empty())
+    {
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::FileSystemError);
+    }
+
+    HANDLE file = CreateFileW(wide.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::FileSystemError);
+    }
+
+    // Creating the mapping with a size extends the file to that size.
+    const uint64_t size64  = size;
+    HANDLE         mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                                static_cast<DWORD>(size64 >> 32),
+                                                static_cast<DWORD>(size64), nullptr);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::FileSystemError);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::FileSystemError);
+    }
+
+    std::unique_ptr<MappedOutputFile> mapped(new MappedOutputFile());
+    mapped->data_    = static_cast<uint8_t*>(view);
+    mapped->size_    = size;
+    mapped->mapping_ = mapping;
+    return CreateResult(std::move(mapped), ErrorCode::Success);
+}
+
+void MappedOutputFile::advise_sequential() const {}
+
+#else
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+    {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+Result<std::shared_ptr<MappedFile>> MappedFile::map(const std::string& path, bool prefault)
+{
+    typedef Result<std::shared_ptr<MappedFile>> MapResult;
+
+    if (path.empty())
+    {
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::ModelFilePathInvalid);
+    }
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::FileSystemError);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::FileSystemError);
+    }
+    if (info.st_size == 0)
+    {
+        close(fd);
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::ModelInvalid);
+    }
+
+    int flags = MAP_SHARED;
+#if defined(__linux__)
+    if (prefault)
+    {
+        flags |= MAP_POPULATE;
+    }
+#endif
+
+    // The mapping keeps the file referenced; the descriptor is no longer needed.
+    size_t size = static_cast<size_t>(info.st_size);
+    void*  data = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return MapResult(std::shared_ptr<MappedFile>(), ErrorCode::FileSystemError);
+    }
+
+    if (prefault)
+    {
+        madvise(data, size, MADV_WILLNEED);
+#if !defined(__linux__)
+        touch_pages(static_cast<const uint8_t*>(data), size);
+#endif
+    }
+
+    std::shared_ptr<MappedFile> mapped(new MappedFile());
+    mapped->data_ = static_cast<const uint8_t*>(data);
+    mapped->size_ = size;
+    return MapResult(mapped, ErrorCode::Success);
+}
+
+size_t MappedFile::resident_bytes() const
+{
+    const size_t page  = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t pages = (size_ + page - 1) / page;
+
+#if defined(__APPLE__)
+    std::vector<char> resident(pages);
+#else
+    std::vector<unsigned char> resident(pages);
+#endif
+    if (mincore(const_cast<uint8_t*>(data_), size_, resident.data()) != 0)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < pages; ++i)
+    {
+        count += resident[i] & 1;
+    }
+    return std::min(count * page, size_);
+}
+
+void MappedFile::advise_sequential() const
+{
+    madvise(const_cast<uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+}
+
+MappedOutputFile::MappedOutputFile() : data_(nullptr), size_(0) {}
+
+MappedOutputFile::~MappedOutputFile()
+{
+    if (data_)
+    {
+        munmap(data_, size_);
+    }
+}
+
+Result<std::unique_ptr<MappedOutputFile>> MappedOutputFile::create(const std::string& path,
+                                                                   size_t             size)
+{
+    typedef Result<std::unique_ptr<MappedOutputFile>> CreateResult;
+
+    if (size == 0)
+    {
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::ParameterOutOfRange);
+    }
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::FileSystemError);
+    }
+
+#if defined(__linux__)
+    // Reserves the blocks now; falls back to a sparse file where the file system cannot.
+    bool sized = posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0 ||
+                 ftruncate(fd, static_cast<off_t>(size)) == 0;
+#else
+    bool sized = ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+    void* data = sized ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return CreateResult(std::unique_ptr<MappedOutputFile>(), ErrorCode::FileSystemError);
+    }
+
+    std::unique_ptr<MappedOutputFile> mapped(new MappedOutputFile());
+    mapped->data_ = static_cast<uint8_t*>(data);
+    mapped->size_ = size;
+    return CreateResult(std::move(mapped), ErrorCode::Success);
+}
+
+void MappedOutputFile::advise_sequential() const
+{
+    madvise(data_, size_, MADV_SEQUENTIAL);
+}
+
+#endif
+
+} // namespace detail
+} // namespace aic
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "aic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace aic
+{
+namespace detail
+{
+
+// Read-only, shared memory mapping of a whole file. The mapping starts on a page boundary, so
+// its data satisfies the 64-byte alignment required by aic_model_create_from_buffer. Pages come
+// from the OS page cache and are shared by every process that maps the same file.
+class MappedFile
+{
+  private:
+    const uint8_t* data_;
+    size_t         size_;
+#if defined(_WIN32)
+    void* mapping_;
+#endif
+
+  public:
+    // Destructor: unmaps the file
+    ~MappedFile();
+
+    // Deleted copy constructor: the mapping is owned exclusively; share it through shared_ptr
+    MappedFile(const MappedFile&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps `path` read-only. With `prefault`, asks the OS to read the whole file in now
+    // (MAP_POPULATE / MADV_WILLNEED, or touching every page where neither exists) so the first
+    // process call does not take page faults.
+    //
+    // Errors: ModelFilePathInvalid for an empty path, FileSystemError if the file cannot be
+    // opened or mapped, ModelInvalid for an empty file.
+    static Result<std::shared_ptr<MappedFile>> map(const std::string& path, bool prefault);
+
+    const uint8_t* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // Bytes of the mapping currently resident in memory (mincore). Returns 0 where the platform
+    // offers no such query.
+    size_t resident_bytes() const;
+
+    // Tells the OS the mapping will be read front to back (MADV_SEQUENTIAL), so it reads ahead
+    // aggressively and drops pages behind the reader early. No-op where unsupported.
+    void advise_sequential() const;
+
+  private:
+    MappedFile();
+};
+
+// Writable, shared memory mapping of a newly created file of fixed size. Stores into the mapping
+// go to the page cache and reach the file without further copies; the OS writes them back in
+// the background and at the latest when the mapping is closed. On Linux the file's blocks are
+// allocated up front, so a full disk is reported at creation instead of as SIGBUS on a store.
+class MappedOutputFile
+{
+  private:
+    uint8_t* data_;
+    size_t   size_;
+#if defined(_WIN32)
+    void* mapping_;
+#endif
+
+  public:
+    // Destructor: unmaps the file
+    ~MappedOutputFile();
+
+    // Deleted copy constructor: the mapping is owned exclusively
+    MappedOutputFile(const MappedOutputFile&) = delete;
+
+    // Deleted copy assignment: copying is disabled for the same reason as the copy constructor
+    MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+    // Creates or truncates `path`, sizes it to `size` bytes and maps it read-write.
+    //
+    // Errors: ParameterOutOfRange for a size of 0, FileSystemError if the file cannot be
+    // created, sized or mapped.
+    static Result<std::unique_ptr<MappedOutputFile>> create(const std::string& path, size_t size);
+
+    uint8_t* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // Tells the OS the mapping will be written front to back. No-op where unsupported.
+    void advise_sequential() const;
+
+  private:
+    MappedOutputFile();
+};
+
+} // namespace detail
+} // namespace aic
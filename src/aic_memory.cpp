@@ -0,0 +1,222 @@
+#include "aic_memory.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+namespace aic
+{
+
+namespace
+{
+
+#if defined(__linux__)
+// Sums the "<key>: <value> kB" lines of a /proc file into the requested fields.
+bool read_proc_kb(const char* path, const char* const* keys, int64_t* const* fields, size_t n)
+{
+    std::FILE* file = std::fopen(path, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<bool> found(n, false);
+    char              line[256];
+    while (std::fgets(line, sizeof(line), file))
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t length = std::strlen(keys[i]);
+            if (std::strncmp(line, keys[i], length) == 0 && line[length] == ':')
+            {
+                long long kb = 0;
+                if (std::sscanf(line + length + 1, "%lld", &kb) == 1)
+                {
+                    *fields[i] += static_cast<int64_t>(kb) * 1024;
+                    found[i] = true;
+                }
+            }
+        }
+    }
+    std::fclose(file);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!found[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+MemoryUsage subtract(const MemoryUsage& after, const MemoryUsage& before, size_t divisor)
+{
+    const int64_t n = static_cast<int64_t>(divisor);
+    MemoryUsage   delta;
+    delta.resident_bytes     = (after.resident_bytes - before.resident_bytes) / n;
+    delta.proportional_bytes = (after.proportional_bytes - before.proportional_bytes) / n;
+    delta.anonymous_bytes    = (after.anonymous_bytes - before.anonymous_bytes) / n;
+    return delta;
+}
+
+} // namespace
+
+Result<MemoryUsage> get_memory_usage()
+{
+    MemoryUsage usage = {};
+
+#if defined(__linux__)
+    const char* rollup_keys[]   = {"Rss", "Pss", "Anonymous"};
+    int64_t*    rollup_fields[] = {&usage.resident_bytes, &usage.proportional_bytes,
+                                   &usage.anonymous_bytes};
+    if (read_proc_kb("/proc/self/smaps_rollup", rollup_keys, rollup_fields, 3))
+    {
+        return Result<MemoryUsage>(usage, ErrorCode::Success);
+    }
+
+    usage                       = MemoryUsage();
+    const char* status_keys[]   = {"VmRSS", "RssAnon"};
+    int64_t*    status_fields[] = {&usage.resident_bytes, &usage.anonymous_bytes};
+    if (read_proc_kb("/proc/self/status", status_keys, status_fields, 2))
+    {
+        usage.proportional_bytes = usage.resident_bytes;
+        return Result<MemoryUsage>(usage, ErrorCode::Success);
+    }
+#elif defined(__APPLE__)
+    task_vm_info_data_t    info  = {};
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, reinterpret_cast<task_info_t>(&info), &count) ==
+        KERN_SUCCESS)
+    {
+        usage.resident_bytes     = static_cast<int64_t>(info.resident_size);
+        usage.proportional_bytes = usage.resident_bytes;
+        usage.anonymous_bytes    = static_cast<int64_t>(info.phys_footprint);
+        return Result<MemoryUsage>(usage, ErrorCode::Success);
+    }
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS_EX counters = {};
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(),
+                                reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
+                                sizeof(counters)))
+    {
+        usage.resident_bytes     = static_cast<int64_t>(counters.WorkingSetSize);
+        usage.proportional_bytes = usage.resident_bytes;
+        usage.anonymous_bytes    = static_cast<int64_t>(counters.PrivateUsage);
+        return Result<MemoryUsage>(usage, ErrorCode::Success);
+    }
+#endif
+
+    return Result<MemoryUsage>(MemoryUsage(), ErrorCode::FileSystemError);
+}
+
+Result<FootprintReport> measure_footprint(const std::string&     model_path,
+                                          const std::string&     license_key,
+                                          const ProcessorConfig& config,
+                                          size_t                 num_streams)
+{
+    typedef Result<FootprintReport> FootprintResult;
+
+    if (num_streams == 0)
+    {
+        return FootprintResult(FootprintReport(), ErrorCode::ParameterOutOfRange);
+    }
+
+    FootprintReport report = {};
+    report.sample_rate     = config.sample_rate;
+    report.num_channels    = config.num_channels;
+    report.num_frames      = config.num_frames;
+    report.num_streams     = num_streams;
+
+    // Reserved up front so growing the vectors does not count towards any component.
+    std::vector<Processor>        processors;
+    std::vector<ProcessorContext> contexts;
+    std::vector<VadContext>       vad_contexts;
+    processors.reserve(num_streams);
+    contexts.reserve(num_streams);
+    vad_contexts.reserve(num_streams);
+    std::vector<float> audio(config.num_frames * config.num_channels, 0.0f);
+
+    auto base = get_memory_usage();
+    if (!base.ok())
+    {
+        return FootprintResult(report, base.error);
+    }
+
+    auto model_result = Model::create_from_file(model_path);
+    if (!model_result.ok())
+    {
+        return FootprintResult(report, model_result.error);
+    }
+    Model model       = model_result.take();
+    auto  after_model = get_memory_usage();
+    report.model      = subtract(after_model.value, base.value, 1);
+
+    for (size_t i = 0; i < num_streams; ++i)
+    {
+        auto processor_result = Processor::create(model, license_key);
+        if (!processor_result.ok())
+        {
+            return FootprintResult(report, processor_result.error);
+        }
+        processors.push_back(processor_result.take());
+
+        Processor& processor = processors.back();
+        ErrorCode  rc        = processor.initialize(config.sample_rate, config.num_channels,
+                                                    config.num_frames,
+                                                    config.allow_variable_frames);
+        if (rc == ErrorCode::Success)
+        {
+            rc = processor.process_interleaved(audio.data(), config.num_channels,
+                                               config.num_frames);
+        }
+        if (rc != ErrorCode::Success)
+        {
+            return FootprintResult(report, rc);
+        }
+    }
+    auto after_processors = get_memory_usage();
+    report.processor      = subtract(after_processors.value, after_model.value, num_streams);
+
+    for (size_t i = 0; i < num_streams; ++i)
+    {
+        auto context_result = processors[i].create_context();
+        if (!context_result.ok())
+        {
+            return FootprintResult(report, context_result.error);
+        }
+        contexts.push_back(context_result.take());
+    }
+    auto after_contexts = get_memory_usage();
+    report.context      = subtract(after_contexts.value, after_processors.value, num_streams);
+
+    for (size_t i = 0; i < num_streams; ++i)
+    {
+        auto vad_result = processors[i].create_vad_context();
+        if (!vad_result.ok())
+        {
+            return FootprintResult(report, vad_result.error);
+        }
+        vad_contexts.push_back(vad_result.take());
+    }
+    auto after_vad     = get_memory_usage();
+    report.vad_context = subtract(after_vad.value, after_contexts.value, num_streams);
+
+    return FootprintResult(report, ErrorCode::Success);
+}
+
+} // namespace aic
@@ -0,0 +1,516 @@
+#include "aic_metrics.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace aic
+{
+
+namespace
+{
+
+#if defined(_WIN32)
+typedef SOCKET Socket;
+const Socket   kInvalidSocket = INVALID_SOCKET;
+
+void close_socket(Socket s)
+{
+    closesocket(s);
+}
+#else
+typedef int  Socket;
+const Socket kInvalidSocket = -1;
+
+void close_socket(Socket s)
+{
+    close(s);
+}
+#endif
+
+// Upper bounds of the exported histogram buckets in seconds, besides +Inf.
+const double kBucketBounds[] = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+                                0.01,   0.025,   0.05,   0.1,   0.25};
+
+// Quantiles exported from the full-resolution histogram.
+const double kQuantiles[]      = {0.5, 0.99, 0.999};
+const char*  kQuantileLabels[] = {"0.5", "0.99", "0.999"};
+
+// Time the HTTP thread waits for a connection before checking whether it should stop.
+const int kAcceptPollMs = 100;
+
+// Longest request header the HTTP server reads.
+const size_t kMaxRequestSize = 8192;
+
+struct StreamData
+{
+    std::string     name;
+    LatencySnapshot latency;
+    DeadlineStats   deadlines;
+};
+
+struct PoolData
+{
+    std::string        name;
+    ProcessorPoolStats stats;
+};
+
+std::string escape_label(const std::string& value)
+{
+    std::string escaped;
+    for (size_t i = 0; i < value.size(); ++i)
+    {
+        switch (value[i])
+        {
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            escaped += value[i];
+        }
+    }
+    return escaped;
+}
+
+double to_seconds(uint64_t ns)
+{
+    return static_cast<double>(ns) * 1e-9;
+}
+
+// Writes the metadata lines of a metric family. OpenMetrics names counter families without
+// the `_total` suffix their samples carry; the Prometheus text format names them like the
+// samples.
+void family(std::ostream& out, MetricsFormat format, const char* name, const char* type,
+            const char* unit, const char* help)
+{
+    std::string family_name = name;
+    if (format == MetricsFormat::OpenMetrics && std::string(type) == "counter")
+    {
+        family_name = family_name.substr(0, family_name.size() - 6);
+    }
+    out << "# TYPE " << family_name << " " << type << "\n";
+    if (format == MetricsFormat::OpenMetrics && unit)
+    {
+        out << "# UNIT " << family_name << " " << unit << "\n";
+    }
+    out << "# HELP " << family_name << " " << help << "\n";
+}
+
+void render_streams(std::ostream& out, MetricsFormat format, const std::vector<StreamData>& streams)
+{
+    family(out, format, "aic_active_processors", "gauge", nullptr,
+           "Processors registered with the exporter.");
+    out << "aic_active_processors " << streams.size() << "\n";
+
+    if (streams.empty())
+    {
+        return;
+    }
+
+    family(out, format, "aic_process_duration_seconds", "histogram", "seconds",
+           "Duration of process calls.");
+    for (size_t s = 0; s < streams.size(); ++s)
+    {
+        const std::string     label = "stream=\"" + escape_label(streams[s].name) + "\"";
+        const LatencySnapshot& latency = streams[s].latency;
+
+        // Every fine bucket is counted under the first bound at or above its upper bound.
+        size_t   bucket     = 0;
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b < sizeof(kBucketBounds) / sizeof(kBucketBounds[0]); ++b)
+        {
+            const uint64_t bound_ns = static_cast<uint64_t>(kBucketBounds[b] * 1e9 + 0.5);
+            for (; bucket < latency.counts.size() &&
+                   LatencySnapshot::get_bucket_upper_bound(bucket) <= bound_ns;
+                 ++bucket)
+            {
+                cumulative += latency.counts[bucket];
+            }
+            out << "aic_process_duration_seconds_bucket{" << label << ",le=\"" << kBucketBounds[b]
+                << "\"} " << cumulative << "\n";
+        }
+        out << "aic_process_duration_seconds_bucket{" << label << ",le=\"+Inf\"} "
+            << latency.count << "\n";
+        out << "aic_process_duration_seconds_count{" << label << "} " << latency.count << "\n";
+        out << "aic_process_duration_seconds_sum{" << label << "} " << to_seconds(latency.sum_ns)
+            << "\n";
+    }
+
+    family(out, format, "aic_process_duration_quantile_seconds", "gauge", "seconds",
+           "Quantiles of the process call duration since the stream was created.");
+    for (size_t s = 0; s < streams.size(); ++s)
+    {
+        for (size_t q = 0; q < sizeof(kQuantiles) / sizeof(kQuantiles[0]); ++q)
+        {
+            out << "aic_process_duration_quantile_seconds{stream=\""
+                << escape_label(streams[s].name) << "\",quantile=\"" << kQuantileLabels[q]
+                << "\"} " << to_seconds(streams[s].latency.get_percentile(kQuantiles[q])) << "\n";
+        }
+    }
+
+    family(out, format, "aic_realtime_factor", "gauge", nullptr,
+           "Processing time divided by audio duration over roughly the last 16 calls.");
+    for (size_t s = 0; s < streams.size(); ++s)
+    {
+        out << "aic_realtime_factor{stream=\"" << escape_label(streams[s].name) << "\"} "
+            << streams[s].deadlines.recent_realtime_factor << "\n";
+    }
+
+    family(out, format, "aic_deadline_misses_total", "counter", nullptr,
+           "Process calls that exceeded their deadline budget.");
+    for (size_t s = 0; s < streams.size(); ++s)
+    {
+        out << "aic_deadline_misses_total{stream=\"" << escape_label(streams[s].name) << "\"} "
+            << streams[s].deadlines.misses << "\n";
+    }
+
+    family(out, format, "aic_deadline_miss_streak", "gauge", nullptr,
+           "Consecutive deadline misses up to the most recent call.");
+    for (size_t s = 0; s < streams.size(); ++s)
+    {
+        out << "aic_deadline_miss_streak{stream=\"" << escape_label(streams[s].name) << "\"} "
+            << streams[s].deadlines.current_streak << "\n";
+    }
+
+    family(out, format, "aic_deadline_miss_streak_max", "gauge", nullptr,
+           "Longest run of consecutive deadline misses.");
+    for (size_t s = 0; s < streams.size(); ++s)
+    {
+        out << "aic_deadline_miss_streak_max{stream=\"" << escape_label(streams[s].name)
+            << "\"} " << streams[s].deadlines.longest_streak << "\n";
+    }
+}
+
+void render_pools(std::ostream& out, MetricsFormat format, const std::vector<PoolData>& pools)
+{
+    if (pools.empty())
+    {
+        return;
+    }
+
+    family(out, format, "aic_pool_processors", "gauge", nullptr,
+           "Processors owned by the pool, by state.");
+    for (size_t p = 0; p < pools.size(); ++p)
+    {
+        const std::string        label = "pool=\"" + escape_label(pools[p].name) + "\"";
+        const ProcessorPoolStats& stats = pools[p].stats;
+        out << "aic_pool_processors{" << label << ",state=\"leased\"} "
+            << stats.size - stats.idle << "\n";
+        out << "aic_pool_processors{" << label << ",state=\"idle\"} " << stats.idle << "\n";
+    }
+
+    family(out, format, "aic_pool_acquires_total", "counter", nullptr,
+           "Acquisitions served by an idle processor (hit) or not (miss).");
+    for (size_t p = 0; p < pools.size(); ++p)
+    {
+        const std::string label = "pool=\"" + escape_label(pools[p].name) + "\"";
+        out << "aic_pool_acquires_total{" << label << ",result=\"hit\"} " << pools[p].stats.hits
+            << "\n";
+        out << "aic_pool_acquires_total{" << label << ",result=\"miss\"} "
+            << pools[p].stats.misses << "\n";
+    }
+
+    family(out, format, "aic_pool_acquire_timeouts_total", "counter", nullptr,
+           "Acquisitions that gave up without a processor.");
+    for (size_t p = 0; p < pools.size(); ++p)
+    {
+        out << "aic_pool_acquire_timeouts_total{pool=\"" << escape_label(pools[p].name)
+            << "\"} " << pools[p].stats.timeouts << "\n";
+    }
+
+    family(out, format, "aic_pool_wait_seconds_total", "counter", "seconds",
+           "Time spent waiting for a processor.");
+    for (size_t p = 0; p < pools.size(); ++p)
+    {
+        out << "aic_pool_wait_seconds_total{pool=\"" << escape_label(pools[p].name) << "\"} "
+            << to_seconds(pools[p].stats.total_wait_ns) << "\n";
+    }
+}
+
+// Sends the whole buffer; gives up when the peer goes away. Where MSG_NOSIGNAL is missing,
+// SO_NOSIGPIPE on the accepted socket keeps a vanished peer from raising SIGPIPE.
+void send_all(Socket s, const std::string& data)
+{
+#if defined(MSG_NOSIGNAL)
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        int n = static_cast<int>(
+            send(s, data.data() + sent, static_cast<int>(data.size() - sent), flags));
+        if (n <= 0)
+        {
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter()
+    : stop_server_(false)
+    , port_(0)
+    , listen_socket_(static_cast<intptr_t>(kInvalidSocket))
+{}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop_http_server();
+}
+
+void MetricsExporter::add_stream(const std::string& name, const InstrumentedProcessor& stream)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_[name] = &stream;
+}
+
+bool MetricsExporter::remove_stream(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.erase(name) > 0;
+}
+
+void MetricsExporter::add_pool(const std::string& name, const ProcessorPool& pool)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pools_[name] = &pool;
+}
+
+bool MetricsExporter::remove_pool(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pools_.erase(name) > 0;
+}
+
+std::string MetricsExporter::render(MetricsFormat format) const
+{
+    std::vector<StreamData> streams;
+    std::vector<PoolData>   pools;
+    {
+        // Holding the lock keeps registered objects alive until their data is copied.
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = streams_.begin(); it != streams_.end(); ++it)
+        {
+            StreamData data;
+            data.name      = it->first;
+            data.latency   = it->second->snapshot();
+            data.deadlines = it->second->get_deadline_stats();
+            streams.push_back(data);
+        }
+        for (auto it = pools_.begin(); it != pools_.end(); ++it)
+        {
+            PoolData data;
+            data.name  = it->first;
+            data.stats = it->second->get_stats();
+            pools.push_back(data);
+        }
+    }
+
+    std::ostringstream out;
+    out.precision(9);
+    render_streams(out, format, streams);
+    render_pools(out, format, pools);
+    if (format == MetricsFormat::OpenMetrics)
+    {
+        out << "# EOF\n";
+    }
+    return out.str();
+}
+
+ErrorCode MetricsExporter::write_file(const std::string& path, MetricsFormat format) const
+{
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        file << render(format);
+        file.flush();
+        if (!file)
+        {
+            std::remove(temporary.c_str());
+            return ErrorCode::FileSystemError;
+        }
+    }
+
+#if defined(_WIN32)
+    const bool renamed = MoveFileExA(temporary.c_str(), path.c_str(),
+                                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    const bool renamed = std::rename(temporary.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed)
+    {
+        std::remove(temporary.c_str());
+        return ErrorCode::FileSystemError;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode MetricsExporter::start_http_server(uint16_t port)
+{
+    if (server_.joinable())
+    {
+        return ErrorCode::ParameterOutOfRange;
+    }
+
+#if defined(_WIN32)
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
+    {
+        return ErrorCode::InternalError;
+    }
+#endif
+
+    Socket s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == kInvalidSocket)
+    {
+        return ErrorCode::InternalError;
+    }
+
+    int reuse = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    socklen_t length = sizeof(address);
+    if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(s, 16) != 0 ||
+        getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+    {
+        close_socket(s);
+        return ErrorCode::InternalError;
+    }
+
+    listen_socket_ = static_cast<intptr_t>(s);
+    port_          = ntohs(address.sin_port);
+    stop_server_.store(false);
+    server_ = std::thread(&MetricsExporter::serve, this);
+    return ErrorCode::Success;
+}
+
+void MetricsExporter::stop_http_server()
+{
+    if (!server_.joinable())
+    {
+        return;
+    }
+    stop_server_.store(true);
+    server_.join();
+    close_socket(static_cast<Socket>(listen_socket_));
+    listen_socket_ = static_cast<intptr_t>(kInvalidSocket);
+    port_          = 0;
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+void MetricsExporter::serve()
+{
+    const Socket listener = static_cast<Socket>(listen_socket_);
+
+    while (!stop_server_.load())
+    {
+        pollfd entry  = {};
+        entry.fd      = listener;
+        entry.events  = POLLIN;
+#if defined(_WIN32)
+        int ready = WSAPoll(&entry, 1, kAcceptPollMs);
+#else
+        int ready = poll(&entry, 1, kAcceptPollMs);
+#endif
+        if (ready <= 0)
+        {
+            continue;
+        }
+
+        Socket client = accept(listener, nullptr, nullptr);
+        if (client == kInvalidSocket)
+        {
+            continue;
+        }
+
+        // A stalled client must not keep the server from stopping.
+#if defined(_WIN32)
+        DWORD timeout = 1000;
+#else
+        timeval timeout = {1, 0};
+#endif
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout),
+                   sizeof(timeout));
+#if defined(SO_NOSIGPIPE)
+        // macOS and the BSDs: a scraper that disconnects mid-response must not kill the host
+        // process with SIGPIPE.
+        const int no_sigpipe = 1;
+        setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+        std::string request;
+        char        chunk[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestSize)
+        {
+            int n = static_cast<int>(recv(client, chunk, sizeof(chunk), 0));
+            if (n <= 0)
+            {
+                break;
+            }
+            request.append(chunk, static_cast<size_t>(n));
+        }
+
+        std::string response;
+        if (request.compare(0, 4, "GET ") != 0)
+        {
+            response = "HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\n"
+                       "Connection: close\r\n\r\n";
+        }
+        else
+        {
+            const bool openmetrics =
+                request.find("application/openmetrics-text") != std::string::npos;
+            const std::string body =
+                render(openmetrics ? MetricsFormat::OpenMetrics : MetricsFormat::Prometheus);
+            std::ostringstream header;
+            header << "HTTP/1.1 200 OK\r\nContent-Type: "
+                   << (openmetrics ? "application/openmetrics-text; version=1.0.0; charset=utf-8"
+                                   : "text/plain; version=0.0.4; charset=utf-8")
+                   << "\r\nContent-Length: " << body.size() << "\r\nConnection: close\r\n\r\n";
+            response = header.str() + body;
+        }
+        send_all(client, response);
+        close_socket(client);
+    }
+}
+
+} // namespace aic
@@ -0,0 +1,380 @@
+#include "aic_mixer.hpp"
+
+#include "aic_audio_view.hpp"
+#include "aic_cpu.hpp"
+
+#include <algorithm>
+
+namespace aic
+{
+
+namespace
+{
+
+// wet[i] = dry[i] + (wet[i] - dry[i]) * (gain + i * step)
+typedef void (*MixFn)(float* wet, const float* dry, size_t n, float gain, float step);
+
+float clamp_mix(float mix)
+{
+    // Also maps NaN to 0
+    return mix > 0.0f ? std::min(mix, 1.0f) : 0.0f;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Mix kernels
+// ---------------------------------------------------------------------------------------------
+
+void mix_scalar(float* wet, const float* dry, size_t n, float gain, float step)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        float g = gain + static_cast<float>(i) * step;
+        wet[i]  = dry[i] + (wet[i] - dry[i]) * g;
+    }
+}
+
+#if AIC_SIMD_X86
+
+void mix_sse2(float* wet, const float* dry, size_t n, float gain, float step)
+{
+    __m128       g     = _mm_add_ps(_mm_set1_ps(gain),
+                                    _mm_mul_ps(_mm_set1_ps(step), _mm_setr_ps(0, 1, 2, 3)));
+    const __m128 delta = _mm_set1_ps(4.0f * step);
+    size_t       i     = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 d = _mm_loadu_ps(dry + i);
+        __m128 w = _mm_loadu_ps(wet + i);
+        _mm_storeu_ps(wet + i, _mm_add_ps(d, _mm_mul_ps(_mm_sub_ps(w, d), g)));
+        g = _mm_add_ps(g, delta);
+    }
+    mix_scalar(wet + i, dry + i, n - i, gain + static_cast<float>(i) * step, step);
+}
+
+AIC_TARGET_AVX2 void mix_avx2(float* wet, const float* dry, size_t n, float gain, float step)
+{
+    __m256 g = _mm256_fmadd_ps(_mm256_set1_ps(step), _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7),
+                               _mm256_set1_ps(gain));
+    const __m256 delta = _mm256_set1_ps(8.0f * step);
+    size_t       i     = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 d = _mm256_loadu_ps(dry + i);
+        __m256 w = _mm256_loadu_ps(wet + i);
+        _mm256_storeu_ps(wet + i, _mm256_fmadd_ps(_mm256_sub_ps(w, d), g, d));
+        g = _mm256_add_ps(g, delta);
+    }
+    mix_scalar(wet + i, dry + i, n - i, gain + static_cast<float>(i) * step, step);
+}
+
+AIC_TARGET_AVX512 void mix_avx512(float* wet, const float* dry, size_t n, float gain, float step)
+{
+    __m512 g = _mm512_fmadd_ps(
+        _mm512_set1_ps(step),
+        _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm512_set1_ps(gain));
+    const __m512 delta = _mm512_set1_ps(16.0f * step);
+    size_t       i     = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512 d = _mm512_loadu_ps(dry + i);
+        __m512 w = _mm512_loadu_ps(wet + i);
+        _mm512_storeu_ps(wet + i, _mm512_fmadd_ps(_mm512_sub_ps(w, d), g, d));
+        g = _mm512_add_ps(g, delta);
+    }
+    mix_scalar(wet + i, dry + i, n - i, gain + static_cast<float>(i) * step, step);
+}
+
+#endif // AIC_SIMD_X86
+
+#if AIC_SIMD_NEON
+
+void mix_neon(float* wet, const float* dry, size_t n, float gain, float step)
+{
+    const float       ramp[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t       g       = vmlaq_n_f32(vdupq_n_f32(gain), vld1q_f32(ramp), step);
+    const float32x4_t delta   = vdupq_n_f32(4.0f * step);
+    size_t            i       = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t d = vld1q_f32(dry + i);
+        float32x4_t w = vld1q_f32(wet + i);
+        vst1q_f32(wet + i, vfmaq_f32(d, vsubq_f32(w, d), g));
+        g = vaddq_f32(g, delta);
+    }
+    mix_scalar(wet + i, dry + i, n - i, gain + static_cast<float>(i) * step, step);
+}
+
+#endif // AIC_SIMD_NEON
+
+MixFn select_mix()
+{
+    switch (detail::active_simd_level())
+    {
+#if AIC_SIMD_X86
+    case SimdLevel::Sse2:
+        return mix_sse2;
+    case SimdLevel::Avx2:
+        return mix_avx2;
+    case SimdLevel::Avx512:
+        return mix_avx512;
+#endif
+#if AIC_SIMD_NEON
+    case SimdLevel::Neon:
+        return mix_neon;
+#endif
+    default:
+        return mix_scalar;
+    }
+}
+
+} // namespace
+
+DryWetMixer::DryWetMixer()
+    : processor_(nullptr)
+    , context_()
+    , num_channels_(0)
+    , max_num_frames_(0)
+    , delay_(0)
+    , capacity_(0)
+    , write_pos_(0)
+    , gain_(1.0f)
+    , target_gain_(1.0f)
+{}
+
+DryWetMixer::DryWetMixer(Processor& processor, ProcessorContext&& context, float mix)
+    : processor_(&processor)
+    , context_(std::move(context))
+    , num_channels_(processor.get_config().num_channels)
+    , max_num_frames_(processor.get_config().num_frames)
+    , delay_(context_.get_output_delay())
+    , capacity_(delay_ + max_num_frames_)
+    , write_pos_(0)
+    , gain_(clamp_mix(mix))
+    , target_gain_(clamp_mix(mix))
+{
+    // A ring of `delay + num_frames` frames per channel: the frames read by a call are never
+    // overwritten by the frames it writes.
+    delay_line_.assign(capacity_ * num_channels_, 0.0f);
+    scratch_.assign(max_num_frames_ * num_channels_, 0.0f);
+}
+
+DryWetMixer::DryWetMixer(DryWetMixer&& other) noexcept
+    : processor_(other.processor_)
+    , context_(std::move(other.context_))
+    , num_channels_(other.num_channels_)
+    , max_num_frames_(other.max_num_frames_)
+    , delay_(other.delay_)
+    , capacity_(other.capacity_)
+    , write_pos_(other.write_pos_)
+    , gain_(other.gain_)
+    , target_gain_(other.target_gain_.load(std::memory_order_relaxed))
+    , delay_line_(std::move(other.delay_line_))
+    , scratch_(std::move(other.scratch_))
+{
+    other.processor_ = nullptr;
+}
+
+DryWetMixer& DryWetMixer::operator=(DryWetMixer&& other) noexcept
+{
+    if (this != &other)
+    {
+        processor_      = other.processor_;
+        context_        = std::move(other.context_);
+        num_channels_   = other.num_channels_;
+        max_num_frames_ = other.max_num_frames_;
+        delay_          = other.delay_;
+        capacity_       = other.capacity_;
+        write_pos_      = other.write_pos_;
+        gain_           = other.gain_;
+        target_gain_.store(other.target_gain_.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+        delay_line_      = std::move(other.delay_line_);
+        scratch_         = std::move(other.scratch_);
+        other.processor_ = nullptr;
+    }
+    return *this;
+}
+
+Result<DryWetMixer> DryWetMixer::create(Processor& processor, float mix)
+{
+    if (!processor.is_initialized())
+    {
+        return Result<DryWetMixer>(DryWetMixer(), ErrorCode::ProcessorNotInitialized);
+    }
+
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        return Result<DryWetMixer>(DryWetMixer(), context_result.error);
+    }
+
+    return Result<DryWetMixer>(DryWetMixer(processor, context_result.take(), mix),
+                               ErrorCode::Success);
+}
+
+ErrorCode DryWetMixer::check(const void* audio, uint16_t num_channels, size_t num_frames) const
+{
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (!processor_)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+    if (num_channels != num_channels_ || num_frames > max_num_frames_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode DryWetMixer::process_planar(float* const* audio, uint16_t num_channels,
+                                      size_t num_frames)
+{
+    ErrorCode rc = check(audio, num_channels, num_frames);
+    if (rc != ErrorCode::Success)
+    {
+        return rc;
+    }
+
+    detail::PlanarView view{audio};
+    push_dry(view, num_frames);
+    rc = processor_->process_planar(audio, num_channels, num_frames);
+    if (rc == ErrorCode::Success)
+    {
+        mix(view, num_frames);
+    }
+    return rc;
+}
+
+ErrorCode DryWetMixer::process_interleaved(float* audio, uint16_t num_channels,
+                                           size_t num_frames)
+{
+    ErrorCode rc = check(audio, num_channels, num_frames);
+    if (rc != ErrorCode::Success)
+    {
+        return rc;
+    }
+
+    detail::InterleavedView view{audio, num_channels};
+    push_dry(view, num_frames);
+    rc = processor_->process_interleaved(audio, num_channels, num_frames);
+    if (rc == ErrorCode::Success)
+    {
+        mix(view, num_frames);
+    }
+    return rc;
+}
+
+ErrorCode DryWetMixer::process_sequential(float* audio, uint16_t num_channels,
+                                          size_t num_frames)
+{
+    ErrorCode rc = check(audio, num_channels, num_frames);
+    if (rc != ErrorCode::Success)
+    {
+        return rc;
+    }
+
+    detail::SequentialView view{audio, num_frames};
+    push_dry(view, num_frames);
+    rc = processor_->process_sequential(audio, num_channels, num_frames);
+    if (rc == ErrorCode::Success)
+    {
+        mix(view, num_frames);
+    }
+    return rc;
+}
+
+template <typename View> void DryWetMixer::push_dry(const View& view, size_t num_frames)
+{
+    const size_t stride = view.stride();
+    for (size_t done = 0; done < num_frames;)
+    {
+        size_t pos = (write_pos_ + done) % capacity_;
+        size_t run = std::min(num_frames - done, capacity_ - pos);
+        for (uint16_t ch = 0; ch < num_channels_; ++ch)
+        {
+            float* line = delay_line_.data() + ch * capacity_;
+            detail::gather(line + pos, view.at(ch, done), stride, run);
+        }
+        done += run;
+    }
+}
+
+template <typename View> void DryWetMixer::mix(const View& view, size_t num_frames)
+{
+    // The dry frames that line up with this call's output start `delay_` frames before the
+    // frames it just stored.
+    const size_t read_pos = (write_pos_ + capacity_ - delay_) % capacity_;
+    write_pos_            = (write_pos_ + num_frames) % capacity_;
+
+    const float target = target_gain_.load(std::memory_order_relaxed);
+    const float gain   = gain_;
+    gain_              = target;
+    if (num_frames == 0 || (gain == 1.0f && target == 1.0f))
+    {
+        return;
+    }
+
+    // Ramp linearly so the last frame of the block reaches the target.
+    const float  step   = (target - gain) / static_cast<float>(num_frames);
+    const MixFn  kernel = select_mix();
+    const size_t stride = view.stride();
+
+    if (stride == 1)
+    {
+        // Planar and sequential layouts: mix each channel against the delay line directly.
+        for (size_t done = 0; done < num_frames;)
+        {
+            size_t pos   = (read_pos + done) % capacity_;
+            size_t run   = std::min(num_frames - done, capacity_ - pos);
+            float  start = gain + static_cast<float>(done + 1) * step;
+            for (uint16_t ch = 0; ch < num_channels_; ++ch)
+            {
+                const float* line = delay_line_.data() + ch * capacity_;
+                kernel(view.at(ch, done), line + pos, run, start, step);
+            }
+            done += run;
+        }
+        return;
+    }
+
+    // Interleaved layout: interleave the delayed dry signal once, then mix the whole buffer in
+    // one pass. The ramp advances per sample instead of per frame, which is inaudible.
+    for (size_t done = 0; done < num_frames;)
+    {
+        size_t pos = (read_pos + done) % capacity_;
+        size_t run = std::min(num_frames - done, capacity_ - pos);
+        for (uint16_t ch = 0; ch < num_channels_; ++ch)
+        {
+            const float* line = delay_line_.data() + ch * capacity_;
+            detail::scatter(scratch_.data() + done * stride + ch, stride, line + pos, run);
+        }
+        done += run;
+    }
+    const float sample_step = step / static_cast<float>(stride);
+    kernel(view.at(0, 0), scratch_.data(), num_frames * stride, gain + sample_step, sample_step);
+}
+
+void DryWetMixer::set_mix(float mix)
+{
+    target_gain_.store(clamp_mix(mix), std::memory_order_relaxed);
+}
+
+ErrorCode DryWetMixer::reset()
+{
+    if (!processor_)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+
+    std::fill(delay_line_.begin(), delay_line_.end(), 0.0f);
+    write_pos_ = 0;
+    gain_      = target_gain_.load(std::memory_order_relaxed);
+
+    return context_.reset();
+}
+
+} // namespace aic
@@ -0,0 +1,261 @@
+#include "aic_model_registry.hpp"
+
+#include "aic_mapped_file.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace aic
+{
+
+namespace
+{
+
+// 64-bit FNV-1a
+uint64_t hash_contents(const uint8_t* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Resolves symlinks and relative components. Fails if the file does not exist.
+bool canonicalize(const std::string& path, std::string& canonical)
+{
+#if defined(_WIN32)
+    char* resolved = _fullpath(nullptr, path.c_str(), 0);
+#else
+    char* resolved = realpath(path.c_str(), nullptr);
+#endif
+    if (!resolved)
+    {
+        return false;
+    }
+    canonical = resolved;
+    std::free(resolved);
+    return true;
+}
+
+} // namespace
+
+// A loaded model. Several slots share one record when their files have the same contents.
+struct ModelRegistry::Record
+{
+    std::shared_ptr<const Model>        model;
+    std::shared_ptr<detail::MappedFile> file;
+    std::string                         path;
+    std::string                         id;
+    uint64_t                            content_hash;
+    uint64_t                            load_time_ns;
+};
+
+// One canonical path. The slot mutex serializes loads of the same file without holding the
+// registry lock, so different files load in parallel.
+struct ModelRegistry::Slot
+{
+    std::mutex              mutex;
+    std::shared_ptr<Record> record;
+};
+
+ModelRegistry::ModelRegistry() {}
+
+ModelRegistry::~ModelRegistry()
+{
+    wait_for_preload();
+}
+
+ModelRegistry& ModelRegistry::get_global()
+{
+    static ModelRegistry registry;
+    return registry;
+}
+
+Result<std::shared_ptr<const Model>> ModelRegistry::acquire(const std::string& file_path,
+                                                            bool               prefault)
+{
+    typedef Result<std::shared_ptr<const Model>> AcquireResult;
+    typedef std::chrono::steady_clock            clock;
+
+    if (file_path.empty())
+    {
+        return AcquireResult(std::shared_ptr<const Model>(), ErrorCode::ModelFilePathInvalid);
+    }
+
+    std::string canonical;
+    if (!canonicalize(file_path, canonical))
+    {
+        return AcquireResult(std::shared_ptr<const Model>(), ErrorCode::FileSystemError);
+    }
+
+    std::shared_ptr<Slot> slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<Slot>&      entry = slots_[canonical];
+        if (!entry)
+        {
+            entry.reset(new Slot());
+        }
+        slot = entry;
+    }
+
+    std::lock_guard<std::mutex> slot_lock(slot->mutex);
+    if (slot->record)
+    {
+        return AcquireResult(slot->record->model, ErrorCode::Success);
+    }
+
+    const clock::time_point start = clock::now();
+
+    // The model is created from the same mapping that gets hashed and compared, so the bytes
+    // that are loaded are the bytes that were deduplicated.
+    auto mapped = detail::MappedFile::map(canonical, prefault);
+    if (!mapped.ok())
+    {
+        return AcquireResult(std::shared_ptr<const Model>(), mapped.error);
+    }
+    std::shared_ptr<detail::MappedFile> file = mapped.take();
+    const uint64_t hash = hash_contents(file->data(), file->size());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < records_.size(); ++i)
+        {
+            const Record& other = *records_[i];
+            if (other.content_hash == hash && other.file->size() == file->size() &&
+                std::memcmp(other.file->data(), file->data(), file->size()) == 0)
+            {
+                slot->record = records_[i];
+                return AcquireResult(slot->record->model, ErrorCode::Success);
+            }
+        }
+    }
+
+    auto model_result = Model::create_from_storage(file->data(), file->size(), file);
+    if (!model_result.ok())
+    {
+        return AcquireResult(std::shared_ptr<const Model>(), model_result.error);
+    }
+
+    std::shared_ptr<Record> record(new Record());
+    record->model        = std::make_shared<Model>(model_result.take());
+    record->file         = file;
+    record->path         = canonical;
+    record->id           = record->model->get_id();
+    record->content_hash = hash;
+    record->load_time_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        records_.push_back(record);
+    }
+    slot->record = record;
+    return AcquireResult(record->model, ErrorCode::Success);
+}
+
+void ModelRegistry::preload(const std::vector<std::string>& file_paths)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    preloads_.push_back(std::thread(
+        [this, file_paths]()
+        {
+            for (size_t i = 0; i < file_paths.size(); ++i)
+            {
+                ErrorCode rc = acquire(file_paths[i], true).error;
+                if (rc != ErrorCode::Success)
+                {
+                    std::lock_guard<std::mutex> error_lock(mutex_);
+                    preload_errors_.push_back(rc);
+                }
+            }
+        }));
+}
+
+ErrorCode ModelRegistry::wait_for_preload()
+{
+    std::vector<std::thread> running;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running.swap(preloads_);
+    }
+    for (size_t i = 0; i < running.size(); ++i)
+    {
+        running[i].join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ErrorCode rc = preload_errors_.empty() ? ErrorCode::Success : preload_errors_.front();
+    preload_errors_.clear();
+    return rc;
+}
+
+size_t ModelRegistry::purge()
+{
+    typedef std::map<std::string, std::shared_ptr<Slot>>::iterator SlotIterator;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t released = 0;
+    for (size_t i = 0; i < records_.size();)
+    {
+        // Slots only get locked with try_lock: blocking here would invert the lock order used
+        // by acquire(). A busy slot may be about to hand out this record, so keep it for now.
+        bool                      busy = false;
+        std::vector<SlotIterator> users;
+        for (auto it = slots_.begin(); it != slots_.end() && !busy; ++it)
+        {
+            std::unique_lock<std::mutex> slot_lock(it->second->mutex, std::try_to_lock);
+            if (!slot_lock.owns_lock())
+            {
+                busy = true;
+            }
+            else if (it->second->record == records_[i])
+            {
+                users.push_back(it);
+            }
+        }
+
+        if (busy || records_[i]->model.use_count() > 1)
+        {
+            ++i;
+            continue;
+        }
+
+        for (size_t u = 0; u < users.size(); ++u)
+        {
+            slots_.erase(users[u]);
+        }
+        records_.erase(records_.begin() + i);
+        ++released;
+    }
+    return released;
+}
+
+std::vector<ModelStats> ModelRegistry::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<ModelStats> stats;
+    stats.reserve(records_.size());
+    for (size_t i = 0; i < records_.size(); ++i)
+    {
+        const Record& record = *records_[i];
+        ModelStats    entry;
+        entry.path           = record.path;
+        entry.id             = record.id;
+        entry.content_hash   = record.content_hash;
+        entry.file_size      = record.file->size();
+        entry.load_time_ns   = record.load_time_ns;
+        entry.resident_bytes = record.file->resident_bytes();
+        entry.external_refs  = record.model.use_count() - 1;
+        stats.push_back(entry);
+    }
+    return stats;
+}
+
+} // namespace aic
@@ -0,0 +1,985 @@
+#include "aic_pcm.hpp"
+
+#include "aic_cpu.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace aic
+{
+
+namespace
+{
+
+typedef void (*ToFloatFn)(const void* src, float* dst, size_t n);
+typedef void (*FromFloatFn)(const float* src, void* dst, size_t n);
+
+// Full-scale factors. Positive full scale of the integer formats is one LSB short of 1.0.
+const float kInt16Scale = 32768.0f;
+const float kInt24Scale = 8388608.0f;
+const float kInt32Scale = 2147483648.0f;
+
+// Largest float that still converts to a valid int32 (2^31 - 128).
+const float kInt32MaxFloat = 2147483520.0f;
+
+// Number of interleaved samples staged in L1 between conversion and (de)interleaving.
+const size_t kChunkSamples = 1024;
+
+// ---------------------------------------------------------------------------------------------
+// Scalar reference kernels
+// ---------------------------------------------------------------------------------------------
+
+inline float saturate(float value, float lo, float hi)
+{
+    if (!(value == value))
+    {
+        return 0.0f;
+    }
+    return value < lo ? lo : (value > hi ? hi : value);
+}
+
+inline int32_t load_int24(const uint8_t* p)
+{
+    uint32_t v = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                 (static_cast<uint32_t>(p[2]) << 16);
+    return static_cast<int32_t>(v << 8) >> 8;
+}
+
+inline void store_int24(uint8_t* p, int32_t value)
+{
+    uint32_t v = static_cast<uint32_t>(value);
+    p[0]       = static_cast<uint8_t>(v);
+    p[1]       = static_cast<uint8_t>(v >> 8);
+    p[2]       = static_cast<uint8_t>(v >> 16);
+}
+
+void int16_to_float_scalar(const void* src, float* dst, size_t n)
+{
+    const int16_t* s = static_cast<const int16_t*>(src);
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] = static_cast<float>(s[i]) * (1.0f / kInt16Scale);
+    }
+}
+
+void int24_to_float_scalar(const void* src, float* dst, size_t n)
+{
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] = static_cast<float>(load_int24(s + 3 * i)) * (1.0f / kInt24Scale);
+    }
+}
+
+void int32_to_float_scalar(const void* src, float* dst, size_t n)
+{
+    const int32_t* s = static_cast<const int32_t*>(src);
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] = static_cast<float>(s[i]) * (1.0f / kInt32Scale);
+    }
+}
+
+void float32_to_float_scalar(const void* src, float* dst, size_t n)
+{
+    std::memcpy(dst, src, n * sizeof(float));
+}
+
+void float64_to_float_scalar(const void* src, float* dst, size_t n)
+{
+    const double* s = static_cast<const double*>(src);
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] = static_cast<float>(s[i]);
+    }
+}
+
+void float_to_int16_scalar(const float* src, void* dst, size_t n)
+{
+    int16_t* d = static_cast<int16_t*>(dst);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v = saturate(src[i] * kInt16Scale, -32768.0f, 32767.0f);
+        d[i]    = static_cast<int16_t>(std::lrint(v));
+    }
+}
+
+void float_to_int24_scalar(const float* src, void* dst, size_t n)
+{
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v = saturate(src[i] * kInt24Scale, -8388608.0f, 8388607.0f);
+        store_int24(d + 3 * i, static_cast<int32_t>(std::lrint(v)));
+    }
+}
+
+void float_to_int32_scalar(const float* src, void* dst, size_t n)
+{
+    int32_t* d = static_cast<int32_t*>(dst);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v = saturate(src[i] * kInt32Scale, -kInt32Scale, kInt32MaxFloat);
+        d[i]    = static_cast<int32_t>(std::lrint(v));
+    }
+}
+
+void float_to_float32_scalar(const float* src, void* dst, size_t n)
+{
+    std::memcpy(dst, src, n * sizeof(float));
+}
+
+void float_to_float64_scalar(const float* src, void* dst, size_t n)
+{
+    double* d = static_cast<double*>(dst);
+    for (size_t i = 0; i < n; ++i)
+    {
+        d[i] = static_cast<double>(src[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// SSE2 kernels (x86-64 baseline)
+// ---------------------------------------------------------------------------------------------
+
+#if AIC_SIMD_X86
+
+// Clamps to [lo, hi] like saturate(). max and min return their second operand for NaN, which
+// would turn NaN into negative full scale, so NaN lanes are zeroed first.
+inline __m128 saturate_sse2(__m128 v, __m128 lo, __m128 hi)
+{
+    return _mm_min_ps(_mm_max_ps(_mm_and_ps(v, _mm_cmpord_ps(v, v)), lo), hi);
+}
+
+void int16_to_float_sse2(const void* src, float* dst, size_t n)
+{
+    const int16_t* s     = static_cast<const int16_t*>(src);
+    const __m128   scale = _mm_set1_ps(1.0f / kInt16Scale);
+    size_t         i     = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    int16_to_float_scalar(s + i, dst + i, n - i);
+}
+
+void int32_to_float_sse2(const void* src, float* dst, size_t n)
+{
+    const int32_t* s     = static_cast<const int32_t*>(src);
+    const __m128   scale = _mm_set1_ps(1.0f / kInt32Scale);
+    size_t         i     = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    int32_to_float_scalar(s + i, dst + i, n - i);
+}
+
+void float64_to_float_sse2(const void* src, float* dst, size_t n)
+{
+    const double* s = static_cast<const double*>(src);
+    size_t        i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(s + i));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(s + i + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+    }
+    float64_to_float_scalar(s + i, dst + i, n - i);
+}
+
+void float_to_int16_sse2(const float* src, void* dst, size_t n)
+{
+    int16_t*     d     = static_cast<int16_t*>(dst);
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    const __m128 lo    = _mm_set1_ps(-32768.0f);
+    const __m128 hi    = _mm_set1_ps(32767.0f);
+    size_t       i     = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128  a      = saturate_sse2(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo, hi);
+        __m128  b      = saturate_sse2(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), lo, hi);
+        __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), packed);
+    }
+    float_to_int16_scalar(src + i, d + i, n - i);
+}
+
+void float_to_int24_sse2(const float* src, void* dst, size_t n)
+{
+    uint8_t*     d     = static_cast<uint8_t*>(dst);
+    const __m128 scale = _mm_set1_ps(kInt24Scale);
+    const __m128 lo    = _mm_set1_ps(-8388608.0f);
+    const __m128 hi    = _mm_set1_ps(8388607.0f);
+    size_t       i     = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128  v = saturate_sse2(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo, hi);
+        int32_t q[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(q), _mm_cvtps_epi32(v));
+        for (size_t k = 0; k < 4; ++k)
+        {
+            store_int24(d + 3 * (i + k), q[k]);
+        }
+    }
+    float_to_int24_scalar(src + i, d + 3 * i, n - i);
+}
+
+void float_to_int32_sse2(const float* src, void* dst, size_t n)
+{
+    int32_t*     d     = static_cast<int32_t*>(dst);
+    const __m128 scale = _mm_set1_ps(kInt32Scale);
+    const __m128 lo    = _mm_set1_ps(-kInt32Scale);
+    const __m128 hi    = _mm_set1_ps(kInt32MaxFloat);
+    size_t       i     = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 v = saturate_sse2(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo, hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_cvtps_epi32(v));
+    }
+    float_to_int32_scalar(src + i, d + i, n - i);
+}
+
+void float_to_float64_sse2(const float* src, void* dst, size_t n)
+{
+    double* d = static_cast<double*>(dst);
+    size_t  i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(src + i);
+        _mm_storeu_pd(d + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(d + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    float_to_float64_scalar(src + i, d + i, n - i);
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX2 kernels
+// ---------------------------------------------------------------------------------------------
+
+AIC_TARGET_AVX2 inline __m256 saturate_avx2(__m256 v, __m256 lo, __m256 hi)
+{
+    return _mm256_min_ps(_mm256_max_ps(_mm256_and_ps(v, _mm256_cmp_ps(v, v, _CMP_ORD_Q)), lo),
+                         hi);
+}
+
+AIC_TARGET_AVX2 void int16_to_float_avx2(const void* src, float* dst, size_t n)
+{
+    const int16_t* s     = static_cast<const int16_t*>(src);
+    const __m256   scale = _mm256_set1_ps(1.0f / kInt16Scale);
+    size_t         i     = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 8));
+        __m256  fa = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(a));
+        __m256  fb = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(b));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(fa, scale));
+        _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(fb, scale));
+    }
+    int16_to_float_sse2(s + i, dst + i, n - i);
+}
+
+AIC_TARGET_AVX2 void int24_to_float_avx2(const void* src, float* dst, size_t n)
+{
+    const uint8_t* s     = static_cast<const uint8_t*>(src);
+    const __m256   scale = _mm256_set1_ps(1.0f / kInt32Scale);
+    // Lane 0 receives bytes 0..15 and lane 1 bytes 12..27, so each lane holds 4 packed samples.
+    const __m256i  spread = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+    // Moves sample k (bytes 3k..3k+2) into the top three bytes of dword k, zeroing the low byte.
+    const __m256i  shuffle =
+        _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3,
+                         4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    size_t i = 0;
+    // Each iteration loads 32 bytes for 24 bytes of samples; stop while the load stays in bounds.
+    for (; i + 11 <= n; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 3 * i));
+        v         = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, spread), shuffle);
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    int24_to_float_scalar(s + 3 * i, dst + i, n - i);
+}
+
+AIC_TARGET_AVX2 void int32_to_float_avx2(const void* src, float* dst, size_t n)
+{
+    const int32_t* s     = static_cast<const int32_t*>(src);
+    const __m256   scale = _mm256_set1_ps(1.0f / kInt32Scale);
+    size_t         i     = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    int32_to_float_scalar(s + i, dst + i, n - i);
+}
+
+AIC_TARGET_AVX2 void float64_to_float_avx2(const void* src, float* dst, size_t n)
+{
+    const double* s = static_cast<const double*>(src);
+    size_t        i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm_storeu_ps(dst + i, _mm256_cvtpd_ps(_mm256_loadu_pd(s + i)));
+        _mm_storeu_ps(dst + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(s + i + 4)));
+    }
+    float64_to_float_scalar(s + i, dst + i, n - i);
+}
+
+AIC_TARGET_AVX2 void float_to_int16_avx2(const float* src, void* dst, size_t n)
+{
+    int16_t*     d     = static_cast<int16_t*>(dst);
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    const __m256 lo    = _mm256_set1_ps(-32768.0f);
+    const __m256 hi    = _mm256_set1_ps(32767.0f);
+    size_t       i     = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256  v = saturate_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo, hi);
+        __m256i q = _mm256_cvtps_epi32(v);
+        __m128i packed =
+            _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), packed);
+    }
+    float_to_int16_scalar(src + i, d + i, n - i);
+}
+
+AIC_TARGET_AVX2 void float_to_int24_avx2(const float* src, void* dst, size_t n)
+{
+    uint8_t*      d     = static_cast<uint8_t*>(dst);
+    const __m256  scale = _mm256_set1_ps(kInt24Scale);
+    const __m256  lo    = _mm256_set1_ps(-8388608.0f);
+    const __m256  hi    = _mm256_set1_ps(8388607.0f);
+    // Packs the low three bytes of each dword into the first 12 bytes of the lane.
+    const __m256i shuffle =
+        _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6,
+                         8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    size_t i = 0;
+    // The second 16-byte store ends 4 bytes past the 24 bytes written per iteration.
+    for (; i + 10 <= n; i += 8)
+    {
+        __m256  v = saturate_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo, hi);
+        __m256i q = _mm256_shuffle_epi8(_mm256_cvtps_epi32(v), shuffle);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 3 * i), _mm256_castsi256_si128(q));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 3 * i + 12),
+                         _mm256_extracti128_si256(q, 1));
+    }
+    float_to_int24_scalar(src + i, d + 3 * i, n - i);
+}
+
+AIC_TARGET_AVX2 void float_to_int32_avx2(const float* src, void* dst, size_t n)
+{
+    int32_t*     d     = static_cast<int32_t*>(dst);
+    const __m256 scale = _mm256_set1_ps(kInt32Scale);
+    const __m256 lo    = _mm256_set1_ps(-kInt32Scale);
+    const __m256 hi    = _mm256_set1_ps(kInt32MaxFloat);
+    size_t       i     = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 v = saturate_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo, hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_cvtps_epi32(v));
+    }
+    float_to_int32_scalar(src + i, d + i, n - i);
+}
+
+AIC_TARGET_AVX2 void float_to_float64_avx2(const float* src, void* dst, size_t n)
+{
+    double* d = static_cast<double*>(dst);
+    size_t  i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(d + i, _mm256_cvtps_pd(_mm_loadu_ps(src + i)));
+        _mm256_storeu_pd(d + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)));
+    }
+    float_to_float64_scalar(src + i, d + i, n - i);
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX-512F kernels. Packed 24-bit stays on the AVX2 kernels: byte shuffles at 512 bit need
+// AVX-512BW.
+//
+// The unmasked forms of several AVX-512F intrinsics pass an undefined source vector, which GCC
+// reports as uninitialized. The kernels use the zero-masking forms with all lanes enabled.
+// ---------------------------------------------------------------------------------------------
+
+const __mmask8  kAllLanes8  = 0xFF;
+const __mmask16 kAllLanes16 = 0xFFFF;
+
+// Zeroes NaN lanes, then clamps to [lo, hi], like saturate().
+AIC_TARGET_AVX512 inline __m512 saturate_avx512(__m512 v, __m512 lo, __m512 hi)
+{
+    const __mmask16 ordered = _mm512_cmp_ps_mask(v, v, _CMP_ORD_Q);
+    return _mm512_maskz_min_ps(kAllLanes16, _mm512_maskz_max_ps(ordered, v, lo), hi);
+}
+
+AIC_TARGET_AVX512 void int16_to_float_avx512(const void* src, float* dst, size_t n)
+{
+    const int16_t* s     = static_cast<const int16_t*>(src);
+    const __m512   scale = _mm512_set1_ps(1.0f / kInt16Scale);
+    size_t         i     = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        __m512i q = _mm512_maskz_cvtepi16_epi32(kAllLanes16, v);
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_maskz_cvtepi32_ps(kAllLanes16, q), scale));
+    }
+    int16_to_float_scalar(s + i, dst + i, n - i);
+}
+
+AIC_TARGET_AVX512 void int32_to_float_avx512(const void* src, float* dst, size_t n)
+{
+    const int32_t* s     = static_cast<const int32_t*>(src);
+    const __m512   scale = _mm512_set1_ps(1.0f / kInt32Scale);
+    size_t         i     = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512i v = _mm512_loadu_si512(s + i);
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_maskz_cvtepi32_ps(kAllLanes16, v), scale));
+    }
+    int32_to_float_scalar(s + i, dst + i, n - i);
+}
+
+AIC_TARGET_AVX512 void float64_to_float_avx512(const void* src, float* dst, size_t n)
+{
+    const double* s = static_cast<const double*>(src);
+    size_t        i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        _mm256_storeu_ps(dst + i, _mm512_maskz_cvtpd_ps(kAllLanes8, _mm512_loadu_pd(s + i)));
+        _mm256_storeu_ps(dst + i + 8,
+                         _mm512_maskz_cvtpd_ps(kAllLanes8, _mm512_loadu_pd(s + i + 8)));
+    }
+    float64_to_float_scalar(s + i, dst + i, n - i);
+}
+
+AIC_TARGET_AVX512 void float_to_int16_avx512(const float* src, void* dst, size_t n)
+{
+    int16_t*     d     = static_cast<int16_t*>(dst);
+    const __m512 scale = _mm512_set1_ps(kInt16Scale);
+    const __m512 lo    = _mm512_set1_ps(-32768.0f);
+    const __m512 hi    = _mm512_set1_ps(32767.0f);
+    size_t       i     = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512  v = saturate_avx512(_mm512_mul_ps(_mm512_loadu_ps(src + i), scale), lo, hi);
+        __m512i q = _mm512_maskz_cvtps_epi32(kAllLanes16, v);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i),
+                            _mm512_maskz_cvtsepi32_epi16(kAllLanes16, q));
+    }
+    float_to_int16_scalar(src + i, d + i, n - i);
+}
+
+AIC_TARGET_AVX512 void float_to_int32_avx512(const float* src, void* dst, size_t n)
+{
+    int32_t*     d     = static_cast<int32_t*>(dst);
+    const __m512 scale = _mm512_set1_ps(kInt32Scale);
+    const __m512 lo    = _mm512_set1_ps(-kInt32Scale);
+    const __m512 hi    = _mm512_set1_ps(kInt32MaxFloat);
+    size_t       i     = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m512 v = saturate_avx512(_mm512_mul_ps(_mm512_loadu_ps(src + i), scale), lo, hi);
+        _mm512_storeu_si512(d + i, _mm512_maskz_cvtps_epi32(kAllLanes16, v));
+    }
+    float_to_int32_scalar(src + i, d + i, n - i);
+}
+
+AIC_TARGET_AVX512 void float_to_float64_avx512(const float* src, void* dst, size_t n)
+{
+    double* d = static_cast<double*>(dst);
+    size_t  i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        _mm512_storeu_pd(d + i, _mm512_maskz_cvtps_pd(kAllLanes8, _mm256_loadu_ps(src + i)));
+        _mm512_storeu_pd(d + i + 8,
+                         _mm512_maskz_cvtps_pd(kAllLanes8, _mm256_loadu_ps(src + i + 8)));
+    }
+    float_to_float64_scalar(src + i, d + i, n - i);
+}
+
+#endif // AIC_SIMD_X86
+
+// ---------------------------------------------------------------------------------------------
+// NEON kernels (AArch64)
+// ---------------------------------------------------------------------------------------------
+
+#if AIC_SIMD_NEON
+
+void int16_to_float_neon(const void* src, float* dst, size_t n)
+{
+    const int16_t* s = static_cast<const int16_t*>(src);
+    size_t         i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        int16x8_t v = vld1q_s16(s + i);
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(v)), 15));
+        vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(v)), 15));
+    }
+    int16_to_float_scalar(s + i, dst + i, n - i);
+}
+
+void int24_to_float_neon(const void* src, float* dst, size_t n)
+{
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    size_t         i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // De-interleave the byte planes, then rebuild each sample in the top 24 bits of a dword.
+        uint8x8x3_t b   = vld3_u8(s + 3 * i);
+        uint16x8_t  low = vorrq_u16(vmovl_u8(b.val[0]), vshlq_n_u16(vmovl_u8(b.val[1]), 8));
+        uint16x8_t  top = vmovl_u8(b.val[2]);
+        uint32x4_t  a =
+            vorrq_u32(vmovl_u16(vget_low_u16(low)), vshlq_n_u32(vmovl_u16(vget_low_u16(top)), 16));
+        uint32x4_t c = vorrq_u32(vmovl_u16(vget_high_u16(low)),
+                                 vshlq_n_u32(vmovl_u16(vget_high_u16(top)), 16));
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vreinterpretq_s32_u32(vshlq_n_u32(a, 8)), 31));
+        vst1q_f32(dst + i + 4, vcvtq_n_f32_s32(vreinterpretq_s32_u32(vshlq_n_u32(c, 8)), 31));
+    }
+    int24_to_float_scalar(s + 3 * i, dst + i, n - i);
+}
+
+void int32_to_float_neon(const void* src, float* dst, size_t n)
+{
+    const int32_t* s = static_cast<const int32_t*>(src);
+    size_t         i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_f32(dst + i, vcvtq_n_f32_s32(vld1q_s32(s + i), 31));
+    }
+    int32_to_float_scalar(s + i, dst + i, n - i);
+}
+
+void float64_to_float_neon(const void* src, float* dst, size_t n)
+{
+    const double* s = static_cast<const double*>(src);
+    size_t        i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x2_t lo = vcvt_f32_f64(vld1q_f64(s + i));
+        vst1q_f32(dst + i, vcvt_high_f32_f64(lo, vld1q_f64(s + i + 2)));
+    }
+    float64_to_float_scalar(s + i, dst + i, n - i);
+}
+
+void float_to_int16_neon(const float* src, void* dst, size_t n)
+{
+    int16_t* d = static_cast<int16_t*>(dst);
+    size_t   i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        // Float to int conversion and narrowing both saturate on NEON.
+        int32x4_t a = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), kInt16Scale));
+        int32x4_t b = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), kInt16Scale));
+        vst1q_s16(d + i, vcombine_s16(vqmovn_s32(a), vqmovn_s32(b)));
+    }
+    float_to_int16_scalar(src + i, d + i, n - i);
+}
+
+void float_to_int24_neon(const float* src, void* dst, size_t n)
+{
+    uint8_t*        d  = static_cast<uint8_t*>(dst);
+    const int32x4_t lo = vdupq_n_s32(-8388608);
+    const int32x4_t hi = vdupq_n_s32(8388607);
+    size_t          i  = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        int32x4_t a = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), kInt24Scale));
+        int32x4_t b = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i + 4), kInt24Scale));
+        a           = vminq_s32(vmaxq_s32(a, lo), hi);
+        b           = vminq_s32(vmaxq_s32(b, lo), hi);
+        // Split into byte planes and let the structured store interleave them.
+        uint32x4_t  ua = vreinterpretq_u32_s32(a);
+        uint32x4_t  ub = vreinterpretq_u32_s32(b);
+        uint8x8x3_t planes;
+        planes.val[0] = vmovn_u16(vcombine_u16(vmovn_u32(ua), vmovn_u32(ub)));
+        planes.val[1] = vmovn_u16(
+            vcombine_u16(vmovn_u32(vshrq_n_u32(ua, 8)), vmovn_u32(vshrq_n_u32(ub, 8))));
+        planes.val[2] = vmovn_u16(
+            vcombine_u16(vmovn_u32(vshrq_n_u32(ua, 16)), vmovn_u32(vshrq_n_u32(ub, 16))));
+        vst3_u8(d + 3 * i, planes);
+    }
+    float_to_int24_scalar(src + i, d + 3 * i, n - i);
+}
+
+void float_to_int32_neon(const float* src, void* dst, size_t n)
+{
+    int32_t* d = static_cast<int32_t*>(dst);
+    size_t   i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_s32(d + i, vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), kInt32Scale)));
+    }
+    float_to_int32_scalar(src + i, d + i, n - i);
+}
+
+void float_to_float64_neon(const float* src, void* dst, size_t n)
+{
+    double* d = static_cast<double*>(dst);
+    size_t  i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t v = vld1q_f32(src + i);
+        vst1q_f64(d + i, vcvt_f64_f32(vget_low_f32(v)));
+        vst1q_f64(d + i + 2, vcvt_high_f64_f32(v));
+    }
+    float_to_float64_scalar(src + i, d + i, n - i);
+}
+
+#endif // AIC_SIMD_NEON
+
+// ---------------------------------------------------------------------------------------------
+// (De)interleaving of float samples staged in L1
+// ---------------------------------------------------------------------------------------------
+
+void deinterleave(const float* src, float* const* dst, uint16_t num_channels, size_t offset,
+                  size_t num_frames)
+{
+    if (num_channels == 2)
+    {
+        float* left  = dst[0] + offset;
+        float* right = dst[1] + offset;
+        size_t i     = 0;
+#if AIC_SIMD_X86
+        for (; i + 4 <= num_frames; i += 4)
+        {
+            __m128 a = _mm_loadu_ps(src + 2 * i);
+            __m128 b = _mm_loadu_ps(src + 2 * i + 4);
+            _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+#elif AIC_SIMD_NEON
+        for (; i + 4 <= num_frames; i += 4)
+        {
+            float32x4x2_t v = vld2q_f32(src + 2 * i);
+            vst1q_f32(left + i, v.val[0]);
+            vst1q_f32(right + i, v.val[1]);
+        }
+#endif
+        for (; i < num_frames; ++i)
+        {
+            left[i]  = src[2 * i];
+            right[i] = src[2 * i + 1];
+        }
+        return;
+    }
+
+    for (uint16_t ch = 0; ch < num_channels; ++ch)
+    {
+        float*       d = dst[ch] + offset;
+        const float* s = src + ch;
+        for (size_t i = 0; i < num_frames; ++i)
+        {
+            d[i] = s[i * num_channels];
+        }
+    }
+}
+
+void interleave(const float* const* src, float* dst, uint16_t num_channels, size_t offset,
+                size_t num_frames)
+{
+    if (num_channels == 2)
+    {
+        const float* left  = src[0] + offset;
+        const float* right = src[1] + offset;
+        size_t       i     = 0;
+#if AIC_SIMD_X86
+        for (; i + 4 <= num_frames; i += 4)
+        {
+            __m128 l = _mm_loadu_ps(left + i);
+            __m128 r = _mm_loadu_ps(right + i);
+            _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+        }
+#elif AIC_SIMD_NEON
+        for (; i + 4 <= num_frames; i += 4)
+        {
+            float32x4x2_t v;
+            v.val[0] = vld1q_f32(left + i);
+            v.val[1] = vld1q_f32(right + i);
+            vst2q_f32(dst + 2 * i, v);
+        }
+#endif
+        for (; i < num_frames; ++i)
+        {
+            dst[2 * i]     = left[i];
+            dst[2 * i + 1] = right[i];
+        }
+        return;
+    }
+
+    for (uint16_t ch = 0; ch < num_channels; ++ch)
+    {
+        const float* s = src[ch] + offset;
+        float*       d = dst + ch;
+        for (size_t i = 0; i < num_frames; ++i)
+        {
+            d[i * num_channels] = s[i];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------------------------
+
+// Kernels per SIMD level, indexed by SampleFormat.
+struct PcmKernels
+{
+    ToFloatFn   to_float[5];
+    FromFloatFn from_float[5];
+};
+
+const PcmKernels kScalarKernels = {
+    {int16_to_float_scalar, int24_to_float_scalar, int32_to_float_scalar, float32_to_float_scalar,
+     float64_to_float_scalar},
+    {float_to_int16_scalar, float_to_int24_scalar, float_to_int32_scalar, float_to_float32_scalar,
+     float_to_float64_scalar},
+};
+
+#if AIC_SIMD_X86
+const PcmKernels kSse2Kernels = {
+    {int16_to_float_sse2, int24_to_float_scalar, int32_to_float_sse2, float32_to_float_scalar,
+     float64_to_float_sse2},
+    {float_to_int16_sse2, float_to_int24_sse2, float_to_int32_sse2, float_to_float32_scalar,
+     float_to_float64_sse2},
+};
+
+const PcmKernels kAvx2Kernels = {
+    {int16_to_float_avx2, int24_to_float_avx2, int32_to_float_avx2, float32_to_float_scalar,
+     float64_to_float_avx2},
+    {float_to_int16_avx2, float_to_int24_avx2, float_to_int32_avx2, float_to_float32_scalar,
+     float_to_float64_avx2},
+};
+
+const PcmKernels kAvx512Kernels = {
+    {int16_to_float_avx512, int24_to_float_avx2, int32_to_float_avx512, float32_to_float_scalar,
+     float64_to_float_avx512},
+    {float_to_int16_avx512, float_to_int24_avx2, float_to_int32_avx512, float_to_float32_scalar,
+     float_to_float64_avx512},
+};
+#endif
+
+#if AIC_SIMD_NEON
+const PcmKernels kNeonKernels = {
+    {int16_to_float_neon, int24_to_float_neon, int32_to_float_neon, float32_to_float_scalar,
+     float64_to_float_neon},
+    {float_to_int16_neon, float_to_int24_neon, float_to_int32_neon, float_to_float32_scalar,
+     float_to_float64_neon},
+};
+#endif
+
+const PcmKernels& active_kernels()
+{
+    switch (detail::active_simd_level())
+    {
+#if AIC_SIMD_X86
+    case SimdLevel::Sse2:
+        return kSse2Kernels;
+    case SimdLevel::Avx2:
+        return kAvx2Kernels;
+    case SimdLevel::Avx512:
+        return kAvx512Kernels;
+#endif
+#if AIC_SIMD_NEON
+    case SimdLevel::Neon:
+        return kNeonKernels;
+#endif
+    default:
+        return kScalarKernels;
+    }
+}
+
+ToFloatFn select_to_float(SampleFormat format)
+{
+    return active_kernels().to_float[static_cast<int>(format)];
+}
+
+FromFloatFn select_from_float(SampleFormat format)
+{
+    return active_kernels().from_float[static_cast<int>(format)];
+}
+
+} // namespace
+
+size_t get_sample_size(SampleFormat format)
+{
+    switch (format)
+    {
+    case SampleFormat::Int16:
+        return 2;
+    case SampleFormat::Int24:
+        return 3;
+    case SampleFormat::Int32:
+        return 4;
+    case SampleFormat::Float32:
+        return 4;
+    case SampleFormat::Float64:
+        return 8;
+    }
+    return 0;
+}
+
+void convert_to_float(const void* src, SampleFormat format, float* dst, size_t num_samples)
+{
+    select_to_float(format)(src, dst, num_samples);
+}
+
+void convert_from_float(const float* src, void* dst, SampleFormat format, size_t num_samples)
+{
+    select_from_float(format)(src, dst, num_samples);
+}
+
+void deinterleave_to_float(const void* src, SampleFormat format, float* const* dst,
+                           uint16_t num_channels, size_t num_frames)
+{
+    if (num_channels == 0)
+    {
+        return;
+    }
+
+    ToFloatFn to_float = select_to_float(format);
+    if (num_channels == 1)
+    {
+        to_float(src, dst[0], num_frames);
+        return;
+    }
+    if (format == SampleFormat::Float32)
+    {
+        deinterleave(static_cast<const float*>(src), dst, num_channels, 0, num_frames);
+        return;
+    }
+
+    // Convert a chunk of interleaved samples into an L1-resident staging buffer, then split it
+    // into the channel buffers. Source and destination memory are each touched exactly once.
+    float          staging[kChunkSamples];
+    const size_t   chunk_frames = num_channels < kChunkSamples ? kChunkSamples / num_channels : 1;
+    const size_t   frame_bytes  = get_sample_size(format) * num_channels;
+    const uint8_t* bytes        = static_cast<const uint8_t*>(src);
+    for (size_t offset = 0; offset < num_frames; offset += chunk_frames)
+    {
+        size_t frames = num_frames - offset < chunk_frames ? num_frames - offset : chunk_frames;
+        if (frames * num_channels > kChunkSamples)
+        {
+            // More channels than the staging buffer holds; convert frame by frame.
+            for (size_t f = 0; f < frames; ++f)
+            {
+                for (uint16_t ch = 0; ch < num_channels; ++ch)
+                {
+                    to_float(bytes + (offset + f) * frame_bytes + ch * get_sample_size(format),
+                             dst[ch] + offset + f, 1);
+                }
+            }
+            continue;
+        }
+        to_float(bytes + offset * frame_bytes, staging, frames * num_channels);
+        deinterleave(staging, dst, num_channels, offset, frames);
+    }
+}
+
+void interleave_from_float(const float* const* src, void* dst, SampleFormat format,
+                           uint16_t num_channels, size_t num_frames)
+{
+    if (num_channels == 0)
+    {
+        return;
+    }
+
+    FromFloatFn from_float = select_from_float(format);
+    if (num_channels == 1)
+    {
+        from_float(src[0], dst, num_frames);
+        return;
+    }
+    if (format == SampleFormat::Float32)
+    {
+        interleave(src, static_cast<float*>(dst), num_channels, 0, num_frames);
+        return;
+    }
+
+    float        staging[kChunkSamples];
+    const size_t chunk_frames = num_channels < kChunkSamples ? kChunkSamples / num_channels : 1;
+    const size_t frame_bytes  = get_sample_size(format) * num_channels;
+    uint8_t*     bytes        = static_cast<uint8_t*>(dst);
+    for (size_t offset = 0; offset < num_frames; offset += chunk_frames)
+    {
+        size_t frames = num_frames - offset < chunk_frames ? num_frames - offset : chunk_frames;
+        if (frames * num_channels > kChunkSamples)
+        {
+            for (size_t f = 0; f < frames; ++f)
+            {
+                for (uint16_t ch = 0; ch < num_channels; ++ch)
+                {
+                    from_float(src[ch] + offset + f,
+                               bytes + (offset + f) * frame_bytes + ch * get_sample_size(format),
+                               1);
+                }
+            }
+            continue;
+        }
+        interleave(src, staging, num_channels, offset, frames);
+        from_float(staging, bytes + offset * frame_bytes, frames * num_channels);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------
+// PcmFrontEnd
+// ---------------------------------------------------------------------------------------------
+
+PcmFrontEnd::PcmFrontEnd() : processor_(nullptr), num_channels_(0), num_frames_(0) {}
+
+PcmFrontEnd::PcmFrontEnd(Processor& processor)
+    : processor_(&processor)
+    , num_channels_(processor.get_config().num_channels)
+    , num_frames_(processor.get_config().num_frames)
+    , planar_(static_cast<size_t>(num_channels_) * num_frames_, 0.0f)
+    , channels_(num_channels_)
+{
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        channels_[ch] = planar_.data() + ch * num_frames_;
+    }
+}
+
+Result<PcmFrontEnd> PcmFrontEnd::create(Processor& processor)
+{
+    if (!processor.is_initialized())
+    {
+        return Result<PcmFrontEnd>(PcmFrontEnd(), ErrorCode::ProcessorNotInitialized);
+    }
+    return Result<PcmFrontEnd>(PcmFrontEnd(processor), ErrorCode::Success);
+}
+
+ErrorCode PcmFrontEnd::process_interleaved(void* audio, SampleFormat format,
+                                           uint16_t num_channels, size_t num_frames)
+{
+    if (!processor_)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (num_channels != num_channels_ || num_frames > num_frames_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+
+    deinterleave_to_float(audio, format, channels_.data(), num_channels, num_frames);
+
+    ErrorCode rc = processor_->process_planar(channels_.data(), num_channels, num_frames);
+    if (rc != ErrorCode::Success)
+    {
+        return rc;
+    }
+
+    interleave_from_float(channels_.data(), audio, format, num_channels, num_frames);
+    return ErrorCode::Success;
+}
+
+} // namespace aic
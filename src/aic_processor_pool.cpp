@@ -0,0 +1,395 @@
+#include "aic_processor_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace aic
+{
+
+namespace detail
+{
+
+struct PoolEntry
+{
+    Processor                             processor;
+    ProcessorContext                      context;
+    float                                 bypass;
+    float                                 enhancement_level;
+    std::chrono::steady_clock::time_point idle_since;
+
+    PoolEntry(Processor&& p, ProcessorContext&& c)
+        : processor(std::move(p))
+        , context(std::move(c))
+        , bypass(context.get_parameter(ProcessorParameter::Bypass))
+        , enhancement_level(context.get_parameter(ProcessorParameter::EnhancementLevel))
+        , idle_since(std::chrono::steady_clock::now())
+    {}
+};
+
+struct PoolState
+{
+    const Model*         model;
+    std::string          license_key;
+    ProcessorConfig      config;
+    ProcessorPoolOptions options;
+
+    mutable std::mutex      mutex;
+    std::condition_variable returned;
+    std::condition_variable maintenance;
+    bool                    stopping;
+    std::thread             thread;
+
+    // All processors owned by the pool. `idle` is a stack, so recently returned processors are
+    // reused first and the oldest idle ones sit at the front. Both reserve `max_size` up front so
+    // returning a lease never allocates.
+    std::vector<std::unique_ptr<PoolEntry>> entries;
+    std::vector<PoolEntry*>                 idle;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t waits;
+    uint64_t timeouts;
+    uint64_t total_wait_ns;
+    uint64_t max_wait_ns;
+    uint64_t grown;
+    uint64_t shrunk;
+
+    PoolState(const Model& m, const std::string& key, const ProcessorConfig& c,
+              const ProcessorPoolOptions& o)
+        : model(&m)
+        , license_key(key)
+        , config(c)
+        , options(o)
+        , stopping(false)
+        , hits(0)
+        , misses(0)
+        , waits(0)
+        , timeouts(0)
+        , total_wait_ns(0)
+        , max_wait_ns(0)
+        , grown(0)
+        , shrunk(0)
+    {
+        entries.reserve(options.max_size);
+        idle.reserve(options.max_size);
+    }
+};
+
+} // namespace detail
+
+namespace
+{
+
+ErrorCode create_entry(const detail::PoolState& state, std::unique_ptr<detail::PoolEntry>& entry)
+{
+    auto processor_result = Processor::create(*state.model, state.license_key);
+    if (!processor_result.ok())
+    {
+        return processor_result.error;
+    }
+    Processor processor = processor_result.take();
+
+    const ProcessorConfig& config = state.config;
+    ErrorCode rc = processor.initialize(config.sample_rate, config.num_channels, config.num_frames,
+                                        config.allow_variable_frames);
+    if (rc != ErrorCode::Success)
+    {
+        return rc;
+    }
+
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        return context_result.error;
+    }
+
+    entry.reset(new detail::PoolEntry(std::move(processor), context_result.take()));
+    return ErrorCode::Success;
+}
+
+// Background thread: keeps `min_idle` processors ready and retires processors that stayed idle
+// for `idle_timeout`. Processors are created and destroyed without holding the lock.
+void maintain(detail::PoolState* state)
+{
+    typedef std::chrono::steady_clock clock;
+
+    const ProcessorPoolOptions& options = state->options;
+    const clock::duration       period  = std::min<clock::duration>(
+        options.idle_timeout / 2 + std::chrono::milliseconds(1), std::chrono::seconds(1));
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (!state->stopping)
+    {
+        // Grow
+        while (!state->stopping && state->idle.size() < options.min_idle &&
+               state->entries.size() < options.max_size)
+        {
+            std::unique_ptr<detail::PoolEntry> entry;
+            lock.unlock();
+            ErrorCode rc = create_entry(*state, entry);
+            lock.lock();
+            if (rc != ErrorCode::Success)
+            {
+                break; // Retry on the next period
+            }
+            state->idle.push_back(entry.get());
+            state->entries.push_back(std::move(entry));
+            ++state->grown;
+            state->returned.notify_one();
+        }
+
+        // Shrink, oldest idle processor first
+        std::vector<std::unique_ptr<detail::PoolEntry>> retired;
+        const clock::time_point                         now = clock::now();
+        while (!state->idle.empty() && state->idle.size() > options.min_idle &&
+               state->entries.size() > options.initial_size &&
+               now - state->idle.front()->idle_since >= options.idle_timeout)
+        {
+            detail::PoolEntry* oldest = state->idle.front();
+            state->idle.erase(state->idle.begin());
+            for (size_t i = 0; i < state->entries.size(); ++i)
+            {
+                if (state->entries[i].get() == oldest)
+                {
+                    retired.push_back(std::move(state->entries[i]));
+                    state->entries.erase(state->entries.begin() + i);
+                    break;
+                }
+            }
+            ++state->shrunk;
+        }
+        if (!retired.empty())
+        {
+            lock.unlock();
+            retired.clear();
+            lock.lock();
+        }
+
+        state->maintenance.wait_for(lock, period);
+    }
+}
+
+void stop(detail::PoolState* state)
+{
+    if (!state)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping = true;
+    }
+    state->maintenance.notify_all();
+    state->returned.notify_all();
+    if (state->thread.joinable())
+    {
+        state->thread.join();
+    }
+    assert(state->idle.size() == state->entries.size() && "ProcessorLease outlived its pool");
+}
+
+} // namespace
+
+// ---------------------------
+// ProcessorLease
+// ---------------------------
+
+Processor& ProcessorLease::processor() const
+{
+    assert(entry_);
+    return entry_->processor;
+}
+
+const ProcessorContext& ProcessorLease::context() const
+{
+    assert(entry_);
+    return entry_->context;
+}
+
+void ProcessorLease::release()
+{
+    if (!entry_)
+    {
+        return;
+    }
+
+    entry_->context.reset();
+    entry_->context.set_parameter(ProcessorParameter::Bypass, entry_->bypass);
+    entry_->context.set_parameter(ProcessorParameter::EnhancementLevel, entry_->enhancement_level);
+
+    {
+        std::lock_guard<std::mutex> lock(pool_->mutex);
+        entry_->idle_since = std::chrono::steady_clock::now();
+        pool_->idle.push_back(entry_);
+    }
+    pool_->returned.notify_one();
+
+    pool_  = nullptr;
+    entry_ = nullptr;
+}
+
+// ---------------------------
+// ProcessorPool
+// ---------------------------
+
+ProcessorPool::ProcessorPool() {}
+
+ProcessorPool::ProcessorPool(std::unique_ptr<detail::PoolState> state) : state_(std::move(state))
+{
+    state_->thread = std::thread(maintain, state_.get());
+}
+
+ProcessorPool::~ProcessorPool()
+{
+    stop(state_.get());
+}
+
+ProcessorPool::ProcessorPool(ProcessorPool&& other) noexcept : state_(std::move(other.state_)) {}
+
+ProcessorPool& ProcessorPool::operator=(ProcessorPool&& other) noexcept
+{
+    if (this != &other)
+    {
+        stop(state_.get());
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+Result<ProcessorPool> ProcessorPool::create(const Model& model, const std::string& license_key,
+                                            const ProcessorConfig&      config,
+                                            const ProcessorPoolOptions& options)
+{
+    if (options.max_size == 0 || options.max_size < options.initial_size)
+    {
+        return Result<ProcessorPool>(ProcessorPool(), ErrorCode::ParameterOutOfRange);
+    }
+
+    std::unique_ptr<detail::PoolState> state(
+        new detail::PoolState(model, license_key, config, options));
+
+    for (size_t i = 0; i < options.initial_size; ++i)
+    {
+        std::unique_ptr<detail::PoolEntry> entry;
+        ErrorCode                          rc = create_entry(*state, entry);
+        if (rc != ErrorCode::Success)
+        {
+            return Result<ProcessorPool>(ProcessorPool(), rc);
+        }
+        state->idle.push_back(entry.get());
+        state->entries.push_back(std::move(entry));
+    }
+
+    return Result<ProcessorPool>(ProcessorPool(std::move(state)), ErrorCode::Success);
+}
+
+ProcessorLease ProcessorPool::try_acquire()
+{
+    if (!state_)
+    {
+        return ProcessorLease();
+    }
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (state_->idle.empty())
+    {
+        ++state_->misses;
+        lock.unlock();
+        state_->maintenance.notify_one();
+        return ProcessorLease();
+    }
+
+    ++state_->hits;
+    detail::PoolEntry* entry = state_->idle.back();
+    state_->idle.pop_back();
+    bool low = state_->idle.size() < state_->options.min_idle;
+    lock.unlock();
+
+    if (low)
+    {
+        state_->maintenance.notify_one();
+    }
+    return ProcessorLease(state_.get(), entry);
+}
+
+ProcessorLease ProcessorPool::acquire(std::chrono::milliseconds timeout)
+{
+    typedef std::chrono::steady_clock clock;
+
+    if (!state_)
+    {
+        return ProcessorLease();
+    }
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (state_->idle.empty())
+    {
+        ++state_->misses;
+        ++state_->waits;
+        state_->maintenance.notify_one();
+
+        detail::PoolState*      state = state_.get();
+        const clock::time_point start = clock::now();
+        state->returned.wait_for(lock, timeout,
+                                 [state]() { return !state->idle.empty() || state->stopping; });
+        uint64_t waited = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+        state->total_wait_ns += waited;
+        state->max_wait_ns = std::max(state->max_wait_ns, waited);
+
+        if (state->idle.empty())
+        {
+            ++state->timeouts;
+            return ProcessorLease();
+        }
+    }
+    else
+    {
+        ++state_->hits;
+    }
+
+    detail::PoolEntry* entry = state_->idle.back();
+    state_->idle.pop_back();
+    bool low = state_->idle.size() < state_->options.min_idle;
+    lock.unlock();
+
+    if (low)
+    {
+        state_->maintenance.notify_one();
+    }
+    return ProcessorLease(state_.get(), entry);
+}
+
+ProcessorPoolStats ProcessorPool::get_stats() const
+{
+    ProcessorPoolStats stats = {};
+    if (!state_)
+    {
+        return stats;
+    }
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    stats.hits          = state_->hits;
+    stats.misses        = state_->misses;
+    stats.waits         = state_->waits;
+    stats.timeouts      = state_->timeouts;
+    stats.total_wait_ns = state_->total_wait_ns;
+    stats.max_wait_ns   = state_->max_wait_ns;
+    stats.grown         = state_->grown;
+    stats.shrunk        = state_->shrunk;
+    stats.size          = state_->entries.size();
+    stats.idle          = state_->idle.size();
+    return stats;
+}
+
+const ProcessorConfig& ProcessorPool::get_config() const
+{
+    static const ProcessorConfig empty(0, 0);
+    return state_ ? state_->config : empty;
+}
+
+} // namespace aic
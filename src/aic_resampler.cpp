@@ -0,0 +1,529 @@
+#include "aic_resampler.hpp"
+
+#include "aic_audio_view.hpp"
+#include "aic_cpu.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace aic
+{
+
+namespace
+{
+
+typedef float (*DotFn)(const float* a, const float* b, size_t n);
+
+// Filter banks larger than this (in coefficients) are rejected; 4 MiB of floats.
+const size_t kMaxCoefficients = size_t(1) << 20;
+
+// Passband edge relative to the lower of the two Nyquist frequencies.
+const double kRolloff = 0.92;
+
+// Kaiser window shape; 8.6 gives roughly 85 dB stopband attenuation.
+const double kKaiserBeta = 8.6;
+
+const double kPi = 3.14159265358979323846;
+
+uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0)
+    {
+        uint32_t t = a % b;
+        a          = b;
+        b          = t;
+    }
+    return a;
+}
+
+// Zeroth-order modified Bessel function of the first kind (power series).
+double bessel_i0(double x)
+{
+    double sum  = 1.0;
+    double term = 1.0;
+    double q    = x * x / 4.0;
+    for (int k = 1; k < 64; ++k)
+    {
+        term *= q / (static_cast<double>(k) * k);
+        sum += term;
+        if (term < sum * 1e-12)
+        {
+            break;
+        }
+    }
+    return sum;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Dot product kernels; n is always a multiple of 8
+// ---------------------------------------------------------------------------------------------
+
+float dot_scalar(const float* a, const float* b, size_t n)
+{
+    float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < n; i += 4)
+    {
+        acc[0] += a[i] * b[i];
+        acc[1] += a[i + 1] * b[i + 1];
+        acc[2] += a[i + 2] * b[i + 2];
+        acc[3] += a[i + 3] * b[i + 3];
+    }
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+#if AIC_SIMD_X86
+
+float dot_sse2(const float* a, const float* b, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (size_t i = 0; i < n; i += 8)
+    {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 acc = _mm_add_ps(acc0, acc1);
+    acc        = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc        = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    return _mm_cvtss_f32(acc);
+}
+
+// Horizontal sum of the eight lanes.
+AIC_TARGET_AVX2 inline float reduce_add_avx2(__m256 sum)
+{
+    __m128 acc = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    acc        = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc        = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    return _mm_cvtss_f32(acc);
+}
+
+AIC_TARGET_AVX2 float dot_avx2(const float* a, const float* b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i    = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    if (i < n)
+    {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    return reduce_add_avx2(_mm256_add_ps(acc0, acc1));
+}
+
+AIC_TARGET_AVX512 float dot_avx512(const float* a, const float* b, size_t n)
+{
+    __m512 acc = _mm512_setzero_ps();
+    size_t i   = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc);
+    }
+    // _mm512_reduce_add_ps and the unmasked 256-bit extracts pass an undefined source vector
+    // that GCC reports as uninitialized, so the halves are extracted with zero masking.
+    // extractf32x8 needs AVX-512DQ.
+    const __m512d wide = _mm512_castps_pd(acc);
+    const __m256  low  = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, wide, 0));
+    const __m256  high = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, wide, 1));
+    float         sum  = reduce_add_avx2(_mm256_add_ps(low, high));
+    if (i < n)
+    {
+        sum += dot_sse2(a + i, b + i, n - i);
+    }
+    return sum;
+}
+
+#endif // AIC_SIMD_X86
+
+#if AIC_SIMD_NEON
+
+float dot_neon(const float* a, const float* b, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < n; i += 8)
+    {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1));
+}
+
+#endif // AIC_SIMD_NEON
+
+DotFn select_dot()
+{
+    switch (detail::active_simd_level())
+    {
+#if AIC_SIMD_X86
+    case SimdLevel::Sse2:
+        return dot_sse2;
+    case SimdLevel::Avx2:
+        return dot_avx2;
+    case SimdLevel::Avx512:
+        return dot_avx512;
+#endif
+#if AIC_SIMD_NEON
+    case SimdLevel::Neon:
+        return dot_neon;
+#endif
+    default:
+        return dot_scalar;
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------------
+// PolyphaseResampler
+// ---------------------------------------------------------------------------------------------
+
+PolyphaseResampler::PolyphaseResampler()
+    : input_rate_(0)
+    , output_rate_(0)
+    , num_channels_(0)
+    , max_input_frames_(0)
+    , up_(1)
+    , down_(1)
+    , taps_(0)
+    , offset_(0)
+    , phase_(0)
+    , next_index_(0)
+{}
+
+PolyphaseResampler::PolyphaseResampler(uint32_t input_rate, uint32_t output_rate,
+                                       uint16_t num_channels, size_t max_input_frames,
+                                       uint32_t up, uint32_t down, size_t taps)
+    : input_rate_(input_rate)
+    , output_rate_(output_rate)
+    , num_channels_(num_channels)
+    , max_input_frames_(max_input_frames)
+    , up_(up)
+    , down_(down)
+    , taps_(taps)
+    , offset_(0)
+    , phase_(0)
+    , next_index_(0)
+    , coefficients_(static_cast<size_t>(up) * taps, 0.0f)
+    , history_(num_channels * (taps - 1 + max_input_frames), 0.0f)
+{
+    // Prototype low-pass at the upsampled rate, cut off below the lower Nyquist frequency.
+    const size_t length = static_cast<size_t>(up_) * taps_;
+    const double cutoff = kRolloff * 0.5 / std::max(up_, down_);
+    const double center = (length - 1) / 2.0;
+    const double norm   = bessel_i0(kKaiserBeta);
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        double t    = i - center;
+        double x    = 2.0 * cutoff * t;
+        double sinc = x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+        double r    = t / (center > 0.0 ? center : 1.0);
+        double w    = bessel_i0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+        double h    = up_ * 2.0 * cutoff * sinc * w;
+
+        // Phase p holds taps p, p + L, p + 2L, ... stored newest-sample-last so each output is a
+        // plain dot product with a contiguous slice of the history.
+        size_t phase                                    = i % up_;
+        size_t tap                                      = i / up_;
+        coefficients_[phase * taps_ + (taps_ - 1 - tap)] = static_cast<float>(h);
+    }
+}
+
+Result<PolyphaseResampler> PolyphaseResampler::create(uint32_t input_rate, uint32_t output_rate,
+                                                      uint16_t num_channels,
+                                                      size_t max_input_frames, size_t quality_taps)
+{
+    if (input_rate == 0 || output_rate == 0 || num_channels == 0 || max_input_frames == 0 ||
+        quality_taps == 0)
+    {
+        return Result<PolyphaseResampler>(PolyphaseResampler(), ErrorCode::ParameterOutOfRange);
+    }
+
+    uint32_t g    = gcd(input_rate, output_rate);
+    uint32_t up   = output_rate / g;
+    uint32_t down = input_rate / g;
+
+    // When decimating, widen the filter so the transition band stays the same width relative to
+    // the output Nyquist frequency.
+    size_t taps = quality_taps;
+    if (down > up)
+    {
+        taps = static_cast<size_t>((static_cast<uint64_t>(quality_taps) * down + up - 1) / up);
+    }
+    taps = (taps + 7) / 8 * 8;
+
+    if (static_cast<uint64_t>(up) * taps > kMaxCoefficients)
+    {
+        return Result<PolyphaseResampler>(PolyphaseResampler(), ErrorCode::ParameterOutOfRange);
+    }
+
+    return Result<PolyphaseResampler>(PolyphaseResampler(input_rate, output_rate, num_channels,
+                                                         max_input_frames, up, down, taps),
+                                      ErrorCode::Success);
+}
+
+size_t PolyphaseResampler::process(const float* const* input, size_t input_stride,
+                                   size_t num_frames, float* const* output)
+{
+    if (num_frames > max_input_frames_ || taps_ == 0)
+    {
+        return 0;
+    }
+
+    const DotFn  dot          = select_dot();
+    const size_t history_size = taps_ - 1 + max_input_frames_;
+    uint32_t     phase        = phase_;
+    size_t       index        = next_index_;
+    size_t       produced     = 0;
+
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        // Append the new input after the last `taps - 1` samples of the previous call.
+        float* history = history_.data() + ch * history_size;
+        detail::gather(history + taps_ - 1, input[ch], input_stride, num_frames);
+
+        // Every channel walks the same phase sequence from the saved stream state.
+        phase    = phase_;
+        index    = next_index_;
+        produced = 0;
+        float* out = output[ch];
+        while (index < num_frames)
+        {
+            out[produced++] = dot(coefficients_.data() + phase * taps_, history + index, taps_);
+            phase += down_;
+            index += phase / up_;
+            phase %= up_;
+        }
+
+        std::memmove(history, history + num_frames, (taps_ - 1) * sizeof(float));
+    }
+
+    phase_      = phase;
+    next_index_ = index - num_frames;
+    return produced;
+}
+
+void PolyphaseResampler::reset()
+{
+    std::fill(history_.begin(), history_.end(), 0.0f);
+
+    // Starting `offset_` steps into the upsampled timeline shifts every output earlier.
+    phase_      = offset_ % up_;
+    next_index_ = offset_ / up_;
+}
+
+void PolyphaseResampler::set_output_offset(double fraction)
+{
+    if (!(fraction >= 0.0) || fraction >= 1.0)
+    {
+        fraction = 0.0;
+    }
+    offset_     = static_cast<uint32_t>(fraction * down_ + 0.5);
+    phase_      = offset_ % up_;
+    next_index_ = offset_ / up_;
+}
+
+// ---------------------------------------------------------------------------------------------
+// ResamplingStage
+// ---------------------------------------------------------------------------------------------
+
+ResamplingStage::ResamplingStage() : num_channels_(0), max_num_frames_(0), pending_frames_(0) {}
+
+ResamplingStage::ResamplingStage(PolyphaseResampler&& down, PolyphaseResampler&& up,
+                                 StreamAdapter&& adapter, uint16_t num_channels,
+                                 size_t max_num_frames)
+    : num_channels_(num_channels)
+    , max_num_frames_(max_num_frames)
+    , down_(std::move(down))
+    , up_(std::move(up))
+    , adapter_(std::move(adapter))
+    , pending_frames_(0)
+    , host_channels_(num_channels, nullptr)
+{
+    // Model-rate frames produced by one host callback, and host-rate frames produced from them.
+    // The upsampler emits at least as many frames as the host delivered in total, so `pending_`
+    // only ever carries a few surplus frames into the next call.
+    size_t model_frames   = down_.get_max_output_frames(max_num_frames_);
+    size_t pending_frames = max_num_frames_ + up_.get_max_output_frames(model_frames);
+
+    model_.assign(num_channels_ * model_frames, 0.0f);
+    pending_.assign(num_channels_ * pending_frames, 0.0f);
+    model_channels_.resize(num_channels_);
+    pending_channels_.resize(num_channels_);
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        model_channels_[ch] = model_.data() + ch * model_frames;
+    }
+
+    // Let the upsampler absorb the fractional part of the chain delay so that the delay
+    // reported in whole host samples is exact.
+    double delay = exact_output_delay();
+    up_.set_output_offset(delay - std::floor(delay));
+}
+
+Result<ResamplingStage> ResamplingStage::create(Processor& processor, uint32_t host_sample_rate,
+                                                size_t max_num_frames)
+{
+    if (!processor.is_initialized())
+    {
+        return Result<ResamplingStage>(ResamplingStage(), ErrorCode::ProcessorNotInitialized);
+    }
+
+    const ProcessorConfig& config = processor.get_config();
+
+    auto down = PolyphaseResampler::create(host_sample_rate, config.sample_rate,
+                                           config.num_channels, max_num_frames);
+    if (!down.ok())
+    {
+        return Result<ResamplingStage>(ResamplingStage(), down.error);
+    }
+
+    size_t model_frames = down.value.get_max_output_frames(max_num_frames);
+    auto   up           = PolyphaseResampler::create(config.sample_rate, host_sample_rate,
+                                                     config.num_channels, model_frames);
+    if (!up.ok())
+    {
+        return Result<ResamplingStage>(ResamplingStage(), up.error);
+    }
+
+    auto adapter = StreamAdapter::create(processor, model_frames);
+    if (!adapter.ok())
+    {
+        return Result<ResamplingStage>(ResamplingStage(), adapter.error);
+    }
+
+    return Result<ResamplingStage>(ResamplingStage(down.take(), up.take(), adapter.take(),
+                                                   config.num_channels, max_num_frames),
+                                   ErrorCode::Success);
+}
+
+ErrorCode ResamplingStage::process_planar(float* const* audio, uint16_t num_channels,
+                                          size_t num_frames)
+{
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (num_channels != num_channels_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        host_channels_[ch] = audio[ch];
+    }
+    return process(host_channels_.data(), 1, num_frames);
+}
+
+ErrorCode ResamplingStage::process_interleaved(float* audio, uint16_t num_channels,
+                                               size_t num_frames)
+{
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (num_channels != num_channels_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        host_channels_[ch] = audio + ch;
+    }
+    return process(host_channels_.data(), num_channels_, num_frames);
+}
+
+ErrorCode ResamplingStage::process_sequential(float* audio, uint16_t num_channels,
+                                              size_t num_frames)
+{
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (num_channels != num_channels_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        host_channels_[ch] = audio + ch * num_frames;
+    }
+    return process(host_channels_.data(), 1, num_frames);
+}
+
+ErrorCode ResamplingStage::process(float* const* host, size_t stride, size_t num_frames)
+{
+    if (num_channels_ == 0)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+    if (num_frames > max_num_frames_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+
+    // Host rate -> model rate, enhanced in processor-sized blocks by the adapter.
+    size_t    model_frames = down_.process(host, stride, num_frames, model_channels_.data());
+    ErrorCode result = adapter_.process_planar(model_channels_.data(), num_channels_, model_frames);
+
+    // Model rate -> host rate, appended behind the surplus of the previous call.
+    const size_t pending_capacity = pending_.size() / num_channels_;
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        pending_channels_[ch] = pending_.data() + ch * pending_capacity + pending_frames_;
+    }
+    pending_frames_ +=
+        up_.process(model_channels_.data(), 1, model_frames, pending_channels_.data());
+
+    // Exactly `num_frames` go back to the host; the rest waits for the next call.
+    size_t available = std::min(pending_frames_, num_frames);
+    for (uint16_t ch = 0; ch < num_channels_; ++ch)
+    {
+        float* pending = pending_.data() + ch * pending_capacity;
+        detail::scatter(host[ch], stride, pending, available);
+        for (size_t i = available; i < num_frames; ++i)
+        {
+            host[ch][i * stride] = 0.0f;
+        }
+        std::memmove(pending, pending + available, (pending_frames_ - available) * sizeof(float));
+    }
+    pending_frames_ -= available;
+
+    return result;
+}
+
+ErrorCode ResamplingStage::reset()
+{
+    if (num_channels_ == 0)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+    down_.reset();
+    up_.reset();
+    pending_frames_ = 0;
+    return adapter_.reset();
+}
+
+size_t ResamplingStage::get_output_delay() const
+{
+    if (num_channels_ == 0)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(exact_output_delay() + 0.5);
+}
+
+double ResamplingStage::exact_output_delay() const
+{
+    // Both group delays and the model-rate delay, all converted to host samples.
+    double host_per_model = static_cast<double>(up_.get_output_rate()) / up_.get_input_rate();
+    double model_delay    = down_.get_group_delay() + adapter_.get_output_delay();
+    return model_delay * host_per_model + up_.get_group_delay();
+}
+
+} // namespace aic
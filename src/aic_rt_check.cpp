@@ -0,0 +1,418 @@
+// Checked scopes and, with AIC_SDK_ENABLE_RT_CHECKS on Linux/glibc, the interposers that report
+// calls made inside them.
+//
+// The interposers are plain definitions of the libc and libpthread symbols. They take
+// precedence over libc for the whole process once this object is linked, which the inline
+// RtCheckScope calls in aic.hpp guarantee. Allocations are forwarded to glibc's __libc_*
+// entry points; everything else to the next definition found by dlsym(RTLD_NEXT).
+
+// The fortified inline versions of read() and friends would clash with the definitions below.
+#undef _FORTIFY_SOURCE
+
+#include "aic_rt_check.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+
+#if AIC_SDK_ENABLE_RT_CHECKS && defined(__linux__) && defined(__GLIBC__)
+#define AIC_RT_CHECK_INTERPOSE 1
+#include <cstdarg>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#define AIC_RT_CHECK_INTERPOSE 0
+#endif
+
+#if defined(__GNUC__)
+// Initial-exec TLS never allocates on first access, so the allocator interposers can use it.
+#define AIC_RT_CHECK_TLS __attribute__((tls_model("initial-exec")))
+#else
+#define AIC_RT_CHECK_TLS
+#endif
+
+namespace aic
+{
+
+namespace
+{
+
+const int kMaxFrames = 48;
+
+// Trivial, so the thread_local needs no constructor call.
+struct ThreadState
+{
+    int depth;
+    int suspended;
+};
+
+thread_local ThreadState thread_state AIC_RT_CHECK_TLS = {0, 0};
+
+std::atomic<RtViolationHandler> violation_handler(nullptr);
+std::atomic<uint64_t>           violation_count(0);
+
+#if AIC_RT_CHECK_INTERPOSE
+void report(RtViolationKind kind, const char* function)
+{
+    ThreadState& state = thread_state;
+    ++state.suspended;
+
+    void* frames[kMaxFrames];
+    int   num_frames = backtrace(frames, kMaxFrames);
+
+    RtViolation violation;
+    violation.kind       = kind;
+    violation.function   = function;
+    violation.frames     = frames;
+    violation.num_frames = num_frames;
+
+    violation_count.fetch_add(1, std::memory_order_relaxed);
+    RtViolationHandler handler = violation_handler.load(std::memory_order_acquire);
+    (handler ? handler : print_rt_violation)(violation);
+
+    --state.suspended;
+}
+
+inline void check(RtViolationKind kind, const char* function)
+{
+    const ThreadState& state = thread_state;
+    if (state.depth > 0 && state.suspended == 0)
+    {
+        report(kind, function);
+    }
+}
+
+// Looks up the definition this file shadows. Races only ever store the same pointer.
+template <typename Function> Function next(std::atomic<Function>& slot, const char* name)
+{
+    Function function = slot.load(std::memory_order_acquire);
+    if (!function)
+    {
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        slot.store(function, std::memory_order_release);
+    }
+    return function;
+}
+#endif
+
+} // namespace
+
+namespace detail
+{
+
+void rt_check_enter()
+{
+    ++thread_state.depth;
+}
+
+void rt_check_leave()
+{
+    --thread_state.depth;
+}
+
+} // namespace detail
+
+void set_rt_violation_handler(RtViolationHandler handler)
+{
+    violation_handler.store(handler, std::memory_order_release);
+}
+
+void print_rt_violation(const RtViolation& violation)
+{
+    std::fprintf(stderr, "aic rt-check: %s (%s) inside a real-time scope\n", violation.function,
+                 get_rt_violation_kind_name(violation.kind));
+#if AIC_RT_CHECK_INTERPOSE
+    // Skips report() and the interposer itself.
+    const int skip = violation.num_frames > 2 ? 2 : 0;
+    std::fflush(stderr);
+    backtrace_symbols_fd(violation.frames + skip, violation.num_frames - skip, 2);
+#endif
+}
+
+uint64_t get_rt_violation_count()
+{
+    return violation_count.load(std::memory_order_relaxed);
+}
+
+const char* get_rt_violation_kind_name(RtViolationKind kind)
+{
+    switch (kind)
+    {
+    case RtViolationKind::Allocation:
+        return "allocation";
+    case RtViolationKind::Deallocation:
+        return "deallocation";
+    case RtViolationKind::Lock:
+        return "lock";
+    case RtViolationKind::Wait:
+        return "wait";
+    case RtViolationKind::BlockingCall:
+        return "blocking call";
+    }
+    return "unknown";
+}
+
+} // namespace aic
+
+#if AIC_RT_CHECK_INTERPOSE
+
+using aic::RtViolationKind;
+using aic::check;
+using aic::next;
+
+extern "C"
+{
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void  __libc_free(void* pointer);
+
+// -------- Allocator --------
+
+void* malloc(size_t size) __THROW
+{
+    check(RtViolationKind::Allocation, "malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) __THROW
+{
+    check(RtViolationKind::Allocation, "calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) __THROW
+{
+    check(RtViolationKind::Allocation, "realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(size_t alignment, size_t size) __THROW
+{
+    check(RtViolationKind::Allocation, "memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) __THROW
+{
+    check(RtViolationKind::Allocation, "aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, size_t alignment, size_t size) __THROW
+{
+    check(RtViolationKind::Allocation, "posix_memalign");
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+    {
+        return EINVAL;
+    }
+    void* memory = __libc_memalign(alignment, size);
+    if (!memory)
+    {
+        return ENOMEM;
+    }
+    *pointer = memory;
+    return 0;
+}
+
+void free(void* pointer) __THROW
+{
+    if (pointer)
+    {
+        check(RtViolationKind::Deallocation, "free");
+    }
+    __libc_free(pointer);
+}
+
+// -------- Locks and waits --------
+
+typedef int (*MutexLock)(pthread_mutex_t*);
+typedef int (*RwLock)(pthread_rwlock_t*);
+typedef int (*CondWait)(pthread_cond_t*, pthread_mutex_t*);
+typedef int (*CondTimedWait)(pthread_cond_t*, pthread_mutex_t*, const timespec*);
+typedef int (*Join)(pthread_t, void**);
+typedef int (*SemWait)(sem_t*);
+typedef int (*SemTimedWait)(sem_t*, const timespec*);
+typedef long (*Syscall)(long, ...);
+
+static std::atomic<MutexLock>     next_mutex_lock(nullptr);
+static std::atomic<RwLock>        next_rwlock_rdlock(nullptr);
+static std::atomic<RwLock>        next_rwlock_wrlock(nullptr);
+static std::atomic<CondWait>      next_cond_wait(nullptr);
+static std::atomic<CondTimedWait> next_cond_timedwait(nullptr);
+static std::atomic<Join>          next_join(nullptr);
+static std::atomic<SemWait>       next_sem_wait(nullptr);
+static std::atomic<SemTimedWait>  next_sem_timedwait(nullptr);
+static std::atomic<Syscall>       next_syscall(nullptr);
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) __THROWNL
+{
+    check(RtViolationKind::Lock, "pthread_mutex_lock");
+    return next(next_mutex_lock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* lock) __THROWNL
+{
+    check(RtViolationKind::Lock, "pthread_rwlock_rdlock");
+    return next(next_rwlock_rdlock, "pthread_rwlock_rdlock")(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* lock) __THROWNL
+{
+    check(RtViolationKind::Lock, "pthread_rwlock_wrlock");
+    return next(next_rwlock_wrlock, "pthread_rwlock_wrlock")(lock);
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+    check(RtViolationKind::Wait, "pthread_cond_wait");
+    return next(next_cond_wait, "pthread_cond_wait")(cond, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const timespec* abstime)
+{
+    check(RtViolationKind::Wait, "pthread_cond_timedwait");
+    return next(next_cond_timedwait, "pthread_cond_timedwait")(cond, mutex, abstime);
+}
+
+int pthread_join(pthread_t thread, void** result)
+{
+    check(RtViolationKind::Wait, "pthread_join");
+    return next(next_join, "pthread_join")(thread, result);
+}
+
+int sem_wait(sem_t* sem)
+{
+    check(RtViolationKind::Wait, "sem_wait");
+    return next(next_sem_wait, "sem_wait")(sem);
+}
+
+int sem_timedwait(sem_t* sem, const timespec* abstime)
+{
+    check(RtViolationKind::Wait, "sem_timedwait");
+    return next(next_sem_timedwait, "sem_timedwait")(sem, abstime);
+}
+
+// Rust's standard library and libstdc++'s atomic waits park threads with raw futex calls.
+long syscall(long number, ...) __THROW
+{
+    va_list args;
+    va_start(args, number);
+    long a[6];
+    for (int i = 0; i < 6; ++i)
+    {
+        a[i] = va_arg(args, long);
+    }
+    va_end(args);
+
+    if (number == SYS_futex)
+    {
+        const int op = static_cast<int>(a[1]) & FUTEX_CMD_MASK;
+        if (op == FUTEX_WAIT || op == FUTEX_WAIT_BITSET || op == FUTEX_LOCK_PI)
+        {
+            check(RtViolationKind::Wait, "futex");
+        }
+    }
+    return next(next_syscall, "syscall")(number, a[0], a[1], a[2], a[3], a[4], a[5]);
+}
+
+// -------- Blocking system calls --------
+
+typedef ssize_t (*Read)(int, void*, size_t);
+typedef ssize_t (*Write)(int, const void*, size_t);
+typedef ssize_t (*Recv)(int, void*, size_t, int);
+typedef ssize_t (*Send)(int, const void*, size_t, int);
+typedef int (*Poll)(pollfd*, nfds_t, int);
+typedef int (*Select)(int, fd_set*, fd_set*, fd_set*, timeval*);
+typedef int (*Nanosleep)(const timespec*, timespec*);
+typedef int (*ClockNanosleep)(clockid_t, int, const timespec*, timespec*);
+typedef int (*Usleep)(useconds_t);
+typedef unsigned int (*Sleep)(unsigned int);
+
+static std::atomic<Read>           next_read(nullptr);
+static std::atomic<Write>          next_write(nullptr);
+static std::atomic<Recv>           next_recv(nullptr);
+static std::atomic<Send>           next_send(nullptr);
+static std::atomic<Poll>           next_poll(nullptr);
+static std::atomic<Select>         next_select(nullptr);
+static std::atomic<Nanosleep>      next_nanosleep(nullptr);
+static std::atomic<ClockNanosleep> next_clock_nanosleep(nullptr);
+static std::atomic<Usleep>         next_usleep(nullptr);
+static std::atomic<Sleep>          next_sleep(nullptr);
+
+ssize_t read(int fd, void* buffer, size_t size)
+{
+    check(RtViolationKind::BlockingCall, "read");
+    return next(next_read, "read")(fd, buffer, size);
+}
+
+ssize_t write(int fd, const void* buffer, size_t size)
+{
+    check(RtViolationKind::BlockingCall, "write");
+    return next(next_write, "write")(fd, buffer, size);
+}
+
+ssize_t recv(int fd, void* buffer, size_t size, int flags)
+{
+    check(RtViolationKind::BlockingCall, "recv");
+    return next(next_recv, "recv")(fd, buffer, size, flags);
+}
+
+ssize_t send(int fd, const void* buffer, size_t size, int flags)
+{
+    check(RtViolationKind::BlockingCall, "send");
+    return next(next_send, "send")(fd, buffer, size, flags);
+}
+
+int poll(pollfd* fds, nfds_t num_fds, int timeout)
+{
+    check(RtViolationKind::BlockingCall, "poll");
+    return next(next_poll, "poll")(fds, num_fds, timeout);
+}
+
+int select(int num_fds, fd_set* read_fds, fd_set* write_fds, fd_set* except_fds,
+           timeval* timeout)
+{
+    check(RtViolationKind::BlockingCall, "select");
+    return next(next_select, "select")(num_fds, read_fds, write_fds, except_fds, timeout);
+}
+
+int nanosleep(const timespec* duration, timespec* remaining)
+{
+    check(RtViolationKind::BlockingCall, "nanosleep");
+    return next(next_nanosleep, "nanosleep")(duration, remaining);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const timespec* time, timespec* remaining)
+{
+    check(RtViolationKind::BlockingCall, "clock_nanosleep");
+    return next(next_clock_nanosleep, "clock_nanosleep")(clock, flags, time, remaining);
+}
+
+int usleep(useconds_t microseconds)
+{
+    check(RtViolationKind::BlockingCall, "usleep");
+    return next(next_usleep, "usleep")(microseconds);
+}
+
+unsigned int sleep(unsigned int seconds)
+{
+    check(RtViolationKind::BlockingCall, "sleep");
+    return next(next_sleep, "sleep")(seconds);
+}
+
+} // extern "C"
+
+#endif
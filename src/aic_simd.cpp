@@ -0,0 +1,144 @@
+#include "aic_cpu.hpp"
+
+#include <atomic>
+
+#if AIC_SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace aic
+{
+
+namespace
+{
+
+#if AIC_SIMD_X86
+SimdLevel detect_simd_level()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || max_leaf < 7)
+    {
+        return SimdLevel::Sse2;
+    }
+
+    // The OS must save the YMM (and for AVX-512 the opmask and ZMM) register state.
+    unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6)
+    {
+        return SimdLevel::Sse2;
+    }
+
+    __cpuidex(info, 7, 0);
+    bool avx2    = (info[1] & (1 << 5)) != 0;
+    bool avx512f = (info[1] & (1 << 16)) != 0;
+    if (avx512f && (xcr0 & 0xe6) == 0xe6)
+    {
+        return SimdLevel::Avx512;
+    }
+    return avx2 ? SimdLevel::Avx2 : SimdLevel::Sse2;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return SimdLevel::Avx2;
+    }
+    return SimdLevel::Sse2;
+#endif
+}
+#elif AIC_SIMD_NEON
+SimdLevel detect_simd_level()
+{
+    return SimdLevel::Neon;
+}
+#else
+SimdLevel detect_simd_level()
+{
+    return SimdLevel::Scalar;
+}
+#endif
+
+SimdLevel supported_level()
+{
+    static const SimdLevel level = detect_simd_level();
+    return level;
+}
+
+std::atomic<int>& level_storage()
+{
+    static std::atomic<int> level(static_cast<int>(supported_level()));
+    return level;
+}
+
+bool is_available(SimdLevel level)
+{
+    if (level == SimdLevel::Scalar)
+    {
+        return true;
+    }
+    if (supported_level() == SimdLevel::Neon)
+    {
+        return level == SimdLevel::Neon;
+    }
+    return level != SimdLevel::Neon &&
+           static_cast<int>(level) <= static_cast<int>(supported_level());
+}
+
+} // namespace
+
+namespace detail
+{
+
+SimdLevel active_simd_level()
+{
+    return static_cast<SimdLevel>(level_storage().load(std::memory_order_relaxed));
+}
+
+} // namespace detail
+
+SimdLevel get_supported_simd_level()
+{
+    return supported_level();
+}
+
+SimdLevel get_simd_level()
+{
+    return detail::active_simd_level();
+}
+
+SimdLevel set_simd_level(SimdLevel level)
+{
+    SimdLevel active = is_available(level) ? level : supported_level();
+    level_storage().store(static_cast<int>(active), std::memory_order_relaxed);
+    return active;
+}
+
+const char* get_simd_level_name(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar:
+        return "scalar";
+    case SimdLevel::Sse2:
+        return "sse2";
+    case SimdLevel::Avx2:
+        return "avx2";
+    case SimdLevel::Avx512:
+        return "avx512";
+    case SimdLevel::Neon:
+        return "neon";
+    }
+    return "unknown";
+}
+
+} // namespace aic
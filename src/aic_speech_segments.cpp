@@ -0,0 +1,71 @@
+#include "aic_speech_segments.hpp"
+
+#include <algorithm>
+
+namespace aic
+{
+
+SpeechSegmenter::SpeechSegmenter(size_t output_delay)
+    : delay_(output_delay)
+    , processed_(0)
+    , in_speech_(false)
+{}
+
+void SpeechSegmenter::record(bool speech_detected, size_t num_frames)
+{
+    const uint64_t first = get_num_classified_frames();
+    processed_ += num_frames;
+    const uint64_t end = get_num_classified_frames();
+    if (end == first)
+    {
+        // The call only brought out the silence the processor starts with.
+        return;
+    }
+
+    if (speech_detected && in_speech_)
+    {
+        segments_.back().end_frame = end;
+    }
+    else if (speech_detected)
+    {
+        SpeechSegment segment = {first, end};
+        segments_.push_back(segment);
+    }
+    in_speech_ = speech_detected;
+}
+
+void SpeechSegmenter::reset(size_t output_delay)
+{
+    delay_     = output_delay;
+    processed_ = 0;
+    in_speech_ = false;
+    segments_.clear();
+}
+
+std::vector<SpeechSegment> pad_speech_segments(const std::vector<SpeechSegment>& segments,
+                                               uint64_t padding_frames, uint64_t total_frames)
+{
+    std::vector<SpeechSegment> padded;
+    for (const SpeechSegment& segment : segments)
+    {
+        const uint64_t first =
+            segment.first_frame > padding_frames ? segment.first_frame - padding_frames : 0;
+        const uint64_t end = std::min(total_frames, segment.end_frame + padding_frames);
+        if (first >= end)
+        {
+            continue;
+        }
+        if (!padded.empty() && first <= padded.back().end_frame)
+        {
+            padded.back().end_frame = std::max(padded.back().end_frame, end);
+        }
+        else
+        {
+            SpeechSegment widened = {first, end};
+            padded.push_back(widened);
+        }
+    }
+    return padded;
+}
+
+} // namespace aic
@@ -0,0 +1,186 @@
+#include "aic_stream_adapter.hpp"
+
+#include "aic_audio_view.hpp"
+
+#include <algorithm>
+
+namespace aic
+{
+
+StreamAdapter::StreamAdapter()
+    : processor_(nullptr)
+    , context_()
+    , num_channels_(0)
+    , block_frames_(0)
+    , max_num_frames_(0)
+    , capacity_(0)
+    , latency_(0)
+    , write_pos_(0)
+    , process_pos_(0)
+    , read_pos_(0)
+{}
+
+StreamAdapter::StreamAdapter(Processor& processor, ProcessorContext&& context,
+                             size_t max_num_frames)
+    : processor_(&processor)
+    , context_(std::move(context))
+    , num_channels_(processor.get_config().num_channels)
+    , block_frames_(processor.get_config().num_frames)
+    , max_num_frames_(max_num_frames)
+    , capacity_(0)
+    , latency_(block_frames_ - 1)
+    , write_pos_(0)
+    , process_pos_(0)
+    , read_pos_(0)
+{
+    // The ring holds at most `latency_ + max_num_frames` frames at once. Rounding up to whole
+    // blocks keeps every processing block contiguous, so it never wraps around the ring end.
+    size_t num_blocks = (latency_ + max_num_frames_ + block_frames_ - 1) / block_frames_;
+    capacity_         = num_blocks * block_frames_;
+    ring_.assign(capacity_ * num_channels_, 0.0f);
+    reset();
+}
+
+Result<StreamAdapter> StreamAdapter::create(Processor& processor, size_t max_num_frames)
+{
+    if (!processor.is_initialized())
+    {
+        return Result<StreamAdapter>(StreamAdapter(), ErrorCode::ProcessorNotInitialized);
+    }
+    if (max_num_frames == 0)
+    {
+        return Result<StreamAdapter>(StreamAdapter(), ErrorCode::ParameterOutOfRange);
+    }
+
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        return Result<StreamAdapter>(StreamAdapter(), context_result.error);
+    }
+
+    return Result<StreamAdapter>(StreamAdapter(processor, context_result.take(), max_num_frames),
+                                 ErrorCode::Success);
+}
+
+ErrorCode StreamAdapter::process_planar(float* const* audio, uint16_t num_channels,
+                                        size_t num_frames)
+{
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (num_channels != num_channels_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+    return process(detail::PlanarView{audio}, num_frames);
+}
+
+ErrorCode StreamAdapter::process_interleaved(float* audio, uint16_t num_channels,
+                                             size_t num_frames)
+{
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (num_channels != num_channels_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+    return process(detail::InterleavedView{audio, num_channels}, num_frames);
+}
+
+ErrorCode StreamAdapter::process_sequential(float* audio, uint16_t num_channels,
+                                            size_t num_frames)
+{
+    if (!audio)
+    {
+        return ErrorCode::NullPointer;
+    }
+    if (num_channels != num_channels_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+    return process(detail::SequentialView{audio, num_frames}, num_frames);
+}
+
+template <typename View> ErrorCode StreamAdapter::process(const View& view, size_t num_frames)
+{
+    if (!processor_)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+    if (num_frames > max_num_frames_)
+    {
+        return ErrorCode::AudioConfigMismatch;
+    }
+
+    const size_t stride = view.stride();
+
+    // 1. Append the host frames to the ring, one run per block they touch.
+    for (size_t done = 0; done < num_frames;)
+    {
+        size_t pos    = static_cast<size_t>(write_pos_ % capacity_);
+        size_t offset = pos % block_frames_;
+        size_t run    = std::min(num_frames - done, block_frames_ - offset);
+        float* block  = ring_.data() + (pos - offset) * num_channels_;
+        for (uint16_t ch = 0; ch < num_channels_; ++ch)
+        {
+            detail::gather(block + ch * block_frames_ + offset, view.at(ch, done), stride, run);
+        }
+        write_pos_ += run;
+        done += run;
+    }
+
+    // 2. Enhance every complete block in place. Keep going after an error so the read side
+    //    stays aligned with the write side; report the first failure.
+    ErrorCode result = ErrorCode::Success;
+    while (write_pos_ - process_pos_ >= block_frames_)
+    {
+        size_t    pos = static_cast<size_t>(process_pos_ % capacity_);
+        ErrorCode rc  = processor_->process_sequential(ring_.data() + pos * num_channels_,
+                                                       num_channels_, block_frames_);
+        if (rc != ErrorCode::Success && result == ErrorCode::Success)
+        {
+            result = rc;
+        }
+        process_pos_ += block_frames_;
+    }
+
+    // 3. Hand back the oldest processed frames. The priming latency guarantees they exist.
+    for (size_t done = 0; done < num_frames;)
+    {
+        size_t       pos    = static_cast<size_t>(read_pos_ % capacity_);
+        size_t       offset = pos % block_frames_;
+        size_t       run    = std::min(num_frames - done, block_frames_ - offset);
+        const float* block  = ring_.data() + (pos - offset) * num_channels_;
+        for (uint16_t ch = 0; ch < num_channels_; ++ch)
+        {
+            detail::scatter(view.at(ch, done), stride, block + ch * block_frames_ + offset, run);
+        }
+        read_pos_ += run;
+        done += run;
+    }
+
+    return result;
+}
+
+ErrorCode StreamAdapter::reset()
+{
+    if (!processor_)
+    {
+        return ErrorCode::ProcessorNotInitialized;
+    }
+
+    std::fill(ring_.begin(), ring_.end(), 0.0f);
+
+    // Input starts on a block boundary; the read position trails it by `latency_` frames of
+    // silence that count as already processed output.
+    write_pos_   = capacity_;
+    process_pos_ = capacity_;
+    read_pos_    = capacity_ - latency_;
+
+    return context_.reset();
+}
+
+} // namespace aic
@@ -0,0 +1,338 @@
+#include "aic_trace.hpp"
+
+#include "aic.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifndef AIC_SDK_TRACE_BUFFER_EVENTS
+#define AIC_SDK_TRACE_BUFFER_EVENTS 16384
+#endif
+
+namespace aic
+{
+
+namespace
+{
+
+const uint64_t kBufferEvents = AIC_SDK_TRACE_BUFFER_EVENTS;
+
+// One span slot, guarded by a sequence lock so the writer never waits: `sequence` is odd while
+// the slot is being written and 2 * (event index + 1) once it holds that event. A reader that
+// sees the same even value before and after copying the fields got a consistent span.
+struct Slot
+{
+    std::atomic<uint64_t>    sequence;
+    std::atomic<uint32_t>    tid;
+    std::atomic<const char*> name;
+    std::atomic<uint64_t>    start_ns;
+    std::atomic<uint64_t>    end_ns;
+};
+
+// A thread that has written into a ring, from event index `first_index` on.
+struct Owner
+{
+    uint32_t    tid;
+    uint64_t    first_index;
+    std::string name;
+};
+
+// Span ring of one thread. Only the owning thread writes; write_chrome_trace reads. Once the
+// owner exits the ring is handed to the next new thread, or freed after it has been written.
+struct ThreadBuffer
+{
+    std::vector<Owner>      owners; // guarded by the registry mutex; the last one is current
+    std::atomic<bool>       exited;
+    std::atomic<uint64_t>   written;
+    std::unique_ptr<Slot[]> slots;
+
+    explicit ThreadBuffer(uint32_t tid)
+        : exited(false)
+        , written(0)
+        , slots(new Slot[kBufferEvents])
+    {
+        Owner owner = {tid, 0, std::string()};
+        owners.push_back(owner);
+        for (uint64_t i = 0; i < kBufferEvents; ++i)
+        {
+            slots[i].sequence.store(0, std::memory_order_relaxed);
+            slots[i].tid.store(0, std::memory_order_relaxed);
+            slots[i].name.store(nullptr, std::memory_order_relaxed);
+            slots[i].start_ns.store(0, std::memory_order_relaxed);
+            slots[i].end_ns.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+struct Registry
+{
+    std::mutex                                 mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t                                   next_tid = 1;
+};
+
+Registry& get_registry()
+{
+    // Leaked on purpose: threads may record spans during static destruction.
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local uint32_t      t_tid    = 0;
+thread_local bool          t_exited = false;
+
+// Releases the calling thread's ring when its thread_local objects are destroyed.
+struct ThreadExit
+{
+    ~ThreadExit()
+    {
+        if (t_buffer)
+        {
+            t_buffer->exited.store(true, std::memory_order_release);
+        }
+        t_buffer = nullptr;
+        t_exited = true;
+    }
+};
+
+// Returns the calling thread's ring, or nullptr while the thread is exiting.
+ThreadBuffer* get_thread_buffer()
+{
+    if (!t_buffer && !t_exited)
+    {
+        thread_local ThreadExit     guard;
+        Registry&                   registry = get_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        t_tid = registry.next_tid++;
+        for (size_t i = 0; i < registry.buffers.size() && !t_buffer; ++i)
+        {
+            ThreadBuffer& buffer = *registry.buffers[i];
+            if (!buffer.exited.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+            // Earlier owners keep their spans until they are overwritten; forget the ones
+            // that have none left.
+            const uint64_t      written = buffer.written.load(std::memory_order_relaxed);
+            const uint64_t      begin   = written > kBufferEvents ? written - kBufferEvents : 0;
+            std::vector<Owner>& owners  = buffer.owners;
+            for (size_t o = owners.size(); o-- > 0;)
+            {
+                const uint64_t end = o + 1 < owners.size() ? owners[o + 1].first_index : written;
+                if (end <= begin || end == owners[o].first_index)
+                {
+                    owners.erase(owners.begin() + static_cast<std::ptrdiff_t>(o));
+                }
+            }
+            Owner owner = {t_tid, written, std::string()};
+            owners.push_back(owner);
+            buffer.exited.store(false, std::memory_order_relaxed);
+            t_buffer = &buffer;
+        }
+        if (!t_buffer)
+        {
+            registry.buffers.push_back(std::make_shared<ThreadBuffer>(t_tid));
+            t_buffer = registry.buffers.back().get();
+        }
+    }
+    return t_buffer;
+}
+
+void write_json_string(std::ostream& out, const std::string& value)
+{
+    out << '"';
+    for (size_t i = 0; i < value.size(); ++i)
+    {
+        const unsigned char c = static_cast<unsigned char>(value[i]);
+        if (c == '"' || c == '\\')
+        {
+            out << '\\' << value[i];
+        }
+        else if (c < 0x20)
+        {
+            out << ' ';
+        }
+        else
+        {
+            out << value[i];
+        }
+    }
+    out << '"';
+}
+
+// Chrome traces use microseconds; keeps nanosecond precision as three decimals.
+void write_micros(std::ostream& out, uint64_t ns)
+{
+    const char digits[] = {static_cast<char>('0' + ns % 1000 / 100),
+                           static_cast<char>('0' + ns % 100 / 10),
+                           static_cast<char>('0' + ns % 10), '\0'};
+    out << ns / 1000 << '.' << digits;
+}
+
+} // namespace
+
+namespace detail
+{
+
+uint64_t trace_now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+void trace_record(const char* name, uint64_t start_ns, uint64_t end_ns)
+{
+    ThreadBuffer* buffer = get_thread_buffer();
+    if (!buffer)
+    {
+        return;
+    }
+    const uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    Slot&          slot  = buffer->slots[index % kBufferEvents];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.tid.store(t_tid, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.end_ns.store(end_ns, std::memory_order_relaxed);
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+void set_trace_thread_name(const std::string& name)
+{
+    if (!is_tracing_enabled())
+    {
+        return;
+    }
+    ThreadBuffer* buffer = get_thread_buffer();
+    if (!buffer)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(get_registry().mutex);
+    buffer->owners.back().name = name;
+}
+
+ErrorCode write_chrome_trace(const std::string& path)
+{
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        return ErrorCode::FileSystemError;
+    }
+
+#if defined(_WIN32)
+    const int pid = _getpid();
+#else
+    const int pid = static_cast<int>(getpid());
+#endif
+
+    // Rings whose owner had exited are freed below if nothing was recorded into them since.
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::vector<Owner>>            owners;
+    std::vector<uint64_t>                      exited_written;
+    Registry&                                  registry = get_registry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffers = registry.buffers;
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            owners.push_back(buffers[i]->owners);
+            exited_written.push_back(buffers[i]->exited.load(std::memory_order_acquire)
+                                         ? buffers[i]->written.load(std::memory_order_relaxed)
+                                         : UINT64_MAX);
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t b = 0; b < buffers.size(); ++b)
+    {
+        const ThreadBuffer& buffer = *buffers[b];
+
+        for (size_t o = 0; o < owners[b].size(); ++o)
+        {
+            if (owners[b][o].name.empty())
+            {
+                continue;
+            }
+            out << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":"
+                << pid << ",\"tid\":" << owners[b][o].tid << ",\"args\":{\"name\":";
+            write_json_string(out, owners[b][o].name);
+            out << "}}";
+            first = false;
+        }
+
+        const uint64_t written = buffer.written.load(std::memory_order_acquire);
+        const uint64_t begin   = written > kBufferEvents ? written - kBufferEvents : 0;
+        for (uint64_t index = begin; index < written; ++index)
+        {
+            const Slot&    slot     = buffer.slots[index % kBufferEvents];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const uint32_t tid      = slot.tid.load(std::memory_order_relaxed);
+            const char*    name     = slot.name.load(std::memory_order_relaxed);
+            const uint64_t start_ns = slot.start_ns.load(std::memory_order_relaxed);
+            const uint64_t end_ns   = slot.end_ns.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence != 2 * (index + 1) ||
+                slot.sequence.load(std::memory_order_relaxed) != sequence || !name)
+            {
+                // Overwritten by the owning thread while reading
+                continue;
+            }
+
+            out << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"cat\":\"aic\",\"name\":";
+            write_json_string(out, name);
+            out << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":";
+            write_micros(out, start_ns);
+            out << ",\"dur\":";
+            write_micros(out, end_ns - start_ns);
+            out << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+
+    out.flush();
+    if (!out)
+    {
+        return ErrorCode::FileSystemError;
+    }
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (size_t b = 0; b < buffers.size(); ++b)
+    {
+        const ThreadBuffer& buffer = *buffers[b];
+        if (buffer.exited.load(std::memory_order_acquire) &&
+            buffer.written.load(std::memory_order_relaxed) == exited_written[b])
+        {
+            std::vector<std::shared_ptr<ThreadBuffer>>::iterator it =
+                std::find(registry.buffers.begin(), registry.buffers.end(), buffers[b]);
+            if (it != registry.buffers.end())
+            {
+                registry.buffers.erase(it);
+            }
+        }
+    }
+    return ErrorCode::Success;
+}
+
+} // namespace aic
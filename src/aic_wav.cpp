@@ -0,0 +1,508 @@
+#include "aic_wav.hpp"
+
+#include "aic_wav_header.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace aic
+{
+
+namespace
+{
+
+// Larger stdio buffers turn the many small header reads and the sample blocks into few
+// system calls.
+const size_t kIoBufferBytes = size_t(1) << 20;
+
+const uint16_t kFormatPcm        = 0x0001;
+const uint16_t kFormatFloat      = 0x0003;
+const uint16_t kFormatExtensible = 0xFFFE;
+
+// Size of the ds64 chunk body this writer reserves: RIFF size, data size, sample count and an
+// empty table.
+const uint32_t kDs64Bytes = 28;
+
+uint16_t get_u16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get_u32(const uint8_t* p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t get_u64(const uint8_t* p)
+{
+    return static_cast<uint64_t>(get_u32(p)) | (static_cast<uint64_t>(get_u32(p + 4)) << 32);
+}
+
+void put_u16(std::vector<uint8_t>& out, uint16_t value)
+{
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put_u32(std::vector<uint8_t>& out, uint32_t value)
+{
+    put_u16(out, static_cast<uint16_t>(value));
+    put_u16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t value)
+{
+    put_u32(out, static_cast<uint32_t>(value));
+    put_u32(out, static_cast<uint32_t>(value >> 32));
+}
+
+void put_id(std::vector<uint8_t>& out, const char* id)
+{
+    out.insert(out.end(), id, id + 4);
+}
+
+bool read_exact(std::FILE* file, uint8_t* data, size_t size)
+{
+    return std::fread(data, 1, size, file) == size;
+}
+
+bool skip(std::FILE* file, uint64_t size)
+{
+    while (size > 0)
+    {
+        const long step = static_cast<long>(std::min<uint64_t>(size, uint64_t(1) << 30));
+        if (std::fseek(file, step, SEEK_CUR) != 0)
+        {
+            return false;
+        }
+        size -= static_cast<uint64_t>(step);
+    }
+    return true;
+}
+
+bool write_at(std::FILE* file, long offset, const std::vector<uint8_t>& bytes)
+{
+    return std::fseek(file, offset, SEEK_SET) == 0 &&
+           std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+}
+
+// Maps a format tag and bit depth to a SampleFormat. Returns false for other encodings.
+bool to_sample_format(uint16_t tag, uint16_t bits, SampleFormat& format)
+{
+    if (tag == kFormatPcm && bits == 16)
+    {
+        format = SampleFormat::Int16;
+    }
+    else if (tag == kFormatPcm && bits == 24)
+    {
+        format = SampleFormat::Int24;
+    }
+    else if (tag == kFormatPcm && bits == 32)
+    {
+        format = SampleFormat::Int32;
+    }
+    else if (tag == kFormatFloat && bits == 32)
+    {
+        format = SampleFormat::Float32;
+    }
+    else if (tag == kFormatFloat && bits == 64)
+    {
+        format = SampleFormat::Float64;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace detail
+{
+
+ErrorCode read_wav_header(std::FILE* file, WavFormat& format, uint64_t& num_frames)
+{
+    uint8_t header[12];
+    if (!read_exact(file, header, sizeof(header)) || std::memcmp(header + 8, "WAVE", 4))
+    {
+        return ErrorCode::FileSystemError;
+    }
+    const bool rf64 = !std::memcmp(header, "RF64", 4) || !std::memcmp(header, "BW64", 4);
+    if (!rf64 && std::memcmp(header, "RIFF", 4))
+    {
+        return ErrorCode::FileSystemError;
+    }
+
+    bool     have_format = false;
+    size_t   block_align = 0;
+    uint64_t ds64_data   = 0;
+    for (;;)
+    {
+        uint8_t chunk[8];
+        if (!read_exact(file, chunk, sizeof(chunk)))
+        {
+            // End of file before the data chunk
+            return ErrorCode::FileSystemError;
+        }
+        const uint32_t size = get_u32(chunk + 4);
+
+        if (!std::memcmp(chunk, "ds64", 4) && size >= 24)
+        {
+            uint8_t body[24];
+            if (!read_exact(file, body, sizeof(body)) || !skip(file, size - 24 + (size & 1)))
+            {
+                return ErrorCode::FileSystemError;
+            }
+            ds64_data = get_u64(body + 8);
+        }
+        else if (!std::memcmp(chunk, "fmt ", 4) && size >= 16)
+        {
+            uint8_t      body[40] = {};
+            const size_t length   = std::min<size_t>(size, sizeof(body));
+            if (!read_exact(file, body, length) || !skip(file, size - length + (size & 1)))
+            {
+                return ErrorCode::FileSystemError;
+            }
+            uint16_t       tag      = get_u16(body);
+            const uint16_t channels = get_u16(body + 2);
+            const uint32_t rate     = get_u32(body + 4);
+            const uint16_t align    = get_u16(body + 12);
+            const uint16_t bits     = get_u16(body + 14);
+            if (tag == kFormatExtensible && size >= 40)
+            {
+                // The sub-format GUID starts with the actual format tag.
+                tag = get_u16(body + 24);
+            }
+
+            SampleFormat sample_format;
+            if (!to_sample_format(tag, bits, sample_format) || channels == 0 || rate == 0 ||
+                align != channels * get_sample_size(sample_format))
+            {
+                return ErrorCode::AudioConfigUnsupported;
+            }
+            format.sample_rate   = rate;
+            format.num_channels  = channels;
+            format.sample_format = sample_format;
+            block_align          = align;
+            have_format          = true;
+        }
+        else if (!std::memcmp(chunk, "data", 4))
+        {
+            if (!have_format)
+            {
+                return ErrorCode::FileSystemError;
+            }
+            if (rf64 && size == 0xFFFFFFFFu)
+            {
+                num_frames = ds64_data / block_align;
+            }
+            else if (!rf64 && (size == 0 || size == 0xFFFFFFFFu))
+            {
+                num_frames = UINT64_MAX;
+            }
+            else
+            {
+                num_frames = size / block_align;
+            }
+            return ErrorCode::Success;
+        }
+        else if (!skip(file, static_cast<uint64_t>(size) + (size & 1)))
+        {
+            return ErrorCode::FileSystemError;
+        }
+    }
+}
+
+std::vector<uint8_t> make_wav_header(const WavFormat& format, uint64_t num_frames)
+{
+    const size_t   sample_size = get_sample_size(format.sample_format);
+    const uint16_t bits        = static_cast<uint16_t>(sample_size * 8);
+    const bool     is_float    = format.sample_format == SampleFormat::Float32 ||
+                          format.sample_format == SampleFormat::Float64;
+    const uint16_t tag         = is_float ? kFormatFloat : kFormatPcm;
+    const bool     extensible  = format.num_channels > 2 || (!is_float && bits != 16);
+    const uint16_t align       = static_cast<uint16_t>(sample_size * format.num_channels);
+    const uint32_t fmt_size    = extensible ? 40 : 16;
+
+    const uint64_t data_bytes  = num_frames * align;
+    const uint64_t riff_bytes  = 4 + (8 + kDs64Bytes) + (8 + fmt_size) + 8 + data_bytes +
+                                (data_bytes & 1);
+    const bool     rf64        = riff_bytes > 0xFFFFFFFFu;
+
+    std::vector<uint8_t> header;
+    put_id(header, rf64 ? "RF64" : "RIFF");
+    put_u32(header, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(riff_bytes));
+    put_id(header, "WAVE");
+    // Files that fit plain RIFF carry an empty JUNK chunk of the size of ds64, so a writer can
+    // switch to RF64 in place
+    put_id(header, rf64 ? "ds64" : "JUNK");
+    put_u32(header, kDs64Bytes);
+    if (rf64)
+    {
+        put_u64(header, riff_bytes);
+        put_u64(header, data_bytes);
+        put_u64(header, num_frames);
+        put_u32(header, 0);
+    }
+    else
+    {
+        header.insert(header.end(), kDs64Bytes, 0);
+    }
+    put_id(header, "fmt ");
+    put_u32(header, fmt_size);
+    put_u16(header, extensible ? kFormatExtensible : tag);
+    put_u16(header, format.num_channels);
+    put_u32(header, format.sample_rate);
+    put_u32(header, format.sample_rate * align);
+    put_u16(header, align);
+    put_u16(header, bits);
+    if (extensible)
+    {
+        static const uint8_t kGuidTail[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80,
+                                              0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+        const uint32_t       mask = format.num_channels == 1   ? 0x4
+                                    : format.num_channels == 2 ? 0x3
+                                                               : 0;
+        put_u16(header, 22);
+        put_u16(header, bits);
+        put_u32(header, mask);
+        put_u16(header, tag);
+        header.insert(header.end(), kGuidTail, kGuidTail + sizeof(kGuidTail));
+    }
+    put_id(header, "data");
+    put_u32(header, rf64 ? 0xFFFFFFFFu : static_cast<uint32_t>(data_bytes));
+    return header;
+}
+
+} // namespace detail
+
+// ---------------------------
+// WavReader
+// ---------------------------
+
+WavReader::WavReader()
+    : file_(nullptr)
+    , format_()
+    , num_frames_(0)
+    , frames_left_(0)
+    , block_align_(0)
+    , data_offset_(0)
+{}
+
+WavReader::~WavReader()
+{
+    if (file_)
+    {
+        std::fclose(file_);
+    }
+}
+
+WavReader::WavReader(WavReader&& other) noexcept
+    : file_(other.file_)
+    , format_(other.format_)
+    , num_frames_(other.num_frames_)
+    , frames_left_(other.frames_left_)
+    , block_align_(other.block_align_)
+    , data_offset_(other.data_offset_)
+    , bytes_(std::move(other.bytes_))
+{
+    other.file_ = nullptr;
+}
+
+WavReader& WavReader::operator=(WavReader&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (file_)
+        {
+            std::fclose(file_);
+        }
+        file_        = other.file_;
+        format_      = other.format_;
+        num_frames_  = other.num_frames_;
+        frames_left_ = other.frames_left_;
+        block_align_ = other.block_align_;
+        data_offset_ = other.data_offset_;
+        bytes_       = std::move(other.bytes_);
+        other.file_  = nullptr;
+    }
+    return *this;
+}
+
+Result<WavReader> WavReader::create(const std::string& path)
+{
+    WavReader reader;
+    reader.file_ = std::fopen(path.c_str(), "rb");
+    if (!reader.file_)
+    {
+        return Result<WavReader>(WavReader(), ErrorCode::FileSystemError);
+    }
+    std::setvbuf(reader.file_, nullptr, _IOFBF, kIoBufferBytes);
+
+    ErrorCode err = detail::read_wav_header(reader.file_, reader.format_, reader.num_frames_);
+    if (err != ErrorCode::Success)
+    {
+        return Result<WavReader>(WavReader(), err);
+    }
+    const WavFormat& format = reader.format_;
+    reader.block_align_     = format.num_channels * get_sample_size(format.sample_format);
+    reader.frames_left_     = reader.num_frames_;
+    reader.data_offset_     = std::ftell(reader.file_);
+    return Result<WavReader>(std::move(reader), ErrorCode::Success);
+}
+
+Result<size_t> WavReader::read_interleaved(float* audio, size_t num_frames)
+{
+    const size_t frames = static_cast<size_t>(std::min<uint64_t>(num_frames, frames_left_));
+    if (!file_ || frames == 0)
+    {
+        return Result<size_t>(0, ErrorCode::Success);
+    }
+
+    bytes_.resize(frames * block_align_);
+    const size_t read = std::fread(bytes_.data(), 1, bytes_.size(), file_);
+    if (read < bytes_.size() && std::ferror(file_))
+    {
+        return Result<size_t>(0, ErrorCode::FileSystemError);
+    }
+
+    const size_t frames_read = read / block_align_;
+    convert_to_float(bytes_.data(), format_.sample_format, audio,
+                     frames_read * format_.num_channels);
+    // A short read of a file with a known length means it was truncated; stop there.
+    frames_left_ = read < bytes_.size() ? 0
+                   : frames_left_ == UINT64_MAX ? UINT64_MAX
+                                                : frames_left_ - frames_read;
+    return Result<size_t>(frames_read, ErrorCode::Success);
+}
+
+ErrorCode WavReader::seek(uint64_t frame)
+{
+    if (!file_)
+    {
+        return ErrorCode::FileSystemError;
+    }
+    if (num_frames_ != UINT64_MAX && frame > num_frames_)
+    {
+        return ErrorCode::ParameterOutOfRange;
+    }
+    // Relative steps from the data chunk, as a long cannot hold every offset on all platforms
+    if (std::fseek(file_, data_offset_, SEEK_SET) != 0 || !skip(file_, frame * block_align_))
+    {
+        return ErrorCode::FileSystemError;
+    }
+    frames_left_ = num_frames_ == UINT64_MAX ? UINT64_MAX : num_frames_ - frame;
+    return ErrorCode::Success;
+}
+
+// ---------------------------
+// WavWriter
+// ---------------------------
+
+WavWriter::WavWriter()
+    : file_(nullptr)
+    , format_()
+    , frames_written_(0)
+    , block_align_(0)
+    , error_(ErrorCode::Success)
+{}
+
+WavWriter::~WavWriter()
+{
+    finish();
+}
+
+WavWriter::WavWriter(WavWriter&& other) noexcept
+    : file_(other.file_)
+    , format_(other.format_)
+    , frames_written_(other.frames_written_)
+    , block_align_(other.block_align_)
+    , error_(other.error_)
+    , bytes_(std::move(other.bytes_))
+{
+    other.file_ = nullptr;
+}
+
+WavWriter& WavWriter::operator=(WavWriter&& other) noexcept
+{
+    if (this != &other)
+    {
+        finish();
+        file_           = other.file_;
+        format_         = other.format_;
+        frames_written_ = other.frames_written_;
+        block_align_    = other.block_align_;
+        error_          = other.error_;
+        bytes_          = std::move(other.bytes_);
+        other.file_     = nullptr;
+    }
+    return *this;
+}
+
+Result<WavWriter> WavWriter::create(const std::string& path, const WavFormat& format)
+{
+    if (format.sample_rate == 0 || format.num_channels == 0)
+    {
+        return Result<WavWriter>(WavWriter(), ErrorCode::ParameterOutOfRange);
+    }
+
+    const std::vector<uint8_t> header = detail::make_wav_header(format, 0);
+
+    WavWriter writer;
+    writer.file_ = std::fopen(path.c_str(), "wb");
+    if (!writer.file_)
+    {
+        return Result<WavWriter>(WavWriter(), ErrorCode::FileSystemError);
+    }
+    std::setvbuf(writer.file_, nullptr, _IOFBF, kIoBufferBytes);
+    writer.format_      = format;
+    writer.block_align_ = format.num_channels * get_sample_size(format.sample_format);
+    if (std::fwrite(header.data(), 1, header.size(), writer.file_) != header.size())
+    {
+        return Result<WavWriter>(WavWriter(), ErrorCode::FileSystemError);
+    }
+    return Result<WavWriter>(std::move(writer), ErrorCode::Success);
+}
+
+ErrorCode WavWriter::write_interleaved(const float* audio, size_t num_frames)
+{
+    if (!file_ || error_ != ErrorCode::Success)
+    {
+        return error_ != ErrorCode::Success ? error_ : ErrorCode::FileSystemError;
+    }
+
+    bytes_.resize(num_frames * block_align_);
+    convert_from_float(audio, bytes_.data(), format_.sample_format,
+                       num_frames * format_.num_channels);
+    if (std::fwrite(bytes_.data(), 1, bytes_.size(), file_) != bytes_.size())
+    {
+        error_ = ErrorCode::FileSystemError;
+        return error_;
+    }
+    frames_written_ += num_frames;
+    return ErrorCode::Success;
+}
+
+ErrorCode WavWriter::finish()
+{
+    if (!file_)
+    {
+        return error_;
+    }
+
+    bool ok = error_ == ErrorCode::Success;
+    if (ok && (frames_written_ * block_align_) & 1)
+    {
+        ok = std::fputc(0, file_) != EOF;
+    }
+    ok = ok && write_at(file_, 0, detail::make_wav_header(format_, frames_written_));
+
+    ok     = std::fclose(file_) == 0 && ok;
+    file_  = nullptr;
+    error_ = ok ? ErrorCode::Success : ErrorCode::FileSystemError;
+    return error_;
+}
+
+} // namespace aic
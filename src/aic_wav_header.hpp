@@ -0,0 +1,27 @@
+#pragma once
+
+#include "aic_wav.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace aic
+{
+namespace detail
+{
+
+// Parses a WAV header from the start of `file` and leaves the file positioned at the first
+// sample. `num_frames` is UINT64_MAX for plain RIFF files whose data size was never filled in.
+//
+// Errors: FileSystemError for files that are not WAV or end early, AudioConfigUnsupported for
+// sample encodings other than 16/24/32-bit integer and 32/64-bit float.
+ErrorCode read_wav_header(std::FILE* file, WavFormat& format, uint64_t& num_frames);
+
+// Builds the header for `num_frames` frames of `format`: RIFF with a JUNK chunk reserving room
+// for ds64, or RF64 once the file exceeds 4 GiB. Both variants have the same size, so a header
+// can be rewritten in place when the final length is known.
+std::vector<uint8_t> make_wav_header(const WavFormat& format, uint64_t num_frames);
+
+} // namespace detail
+} // namespace aic
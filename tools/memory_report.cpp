@@ -0,0 +1,429 @@
+// Memory footprint report: how much RAM a model and each stream built on it cost, and how many
+// streams fit into a memory budget.
+//
+// For every configuration (sample rate x frame count x channel count) the tool calls
+// aic::measure_footprint, which loads the model and creates --streams processors, contexts and
+// VAD contexts, sampling the process memory between phases. On POSIX systems every
+// configuration runs in a forked process so memory freed by an earlier one cannot be reused and
+// hide growth. The parent never loads the model: "opt" entries are resolved in a throwaway child
+// as well, so no measured child inherits model pages or SDK threads from its parent.
+//
+// The model is loaded once per process and shared by all its processors; a stream is one
+// processor with its ProcessorContext and VadContext. "streams/budget" is
+// (budget - model) / stream, using anonymous memory, which is what a container memory limit
+// counts towards.
+//
+// Lists are comma separated. --rates accepts "opt" for the model's optimal sample rate and
+// --frames accepts "opt" for the model's optimal frame count at each rate.
+//
+// Usage: aic-memory-report <model_path> [--rates LIST] [--frames LIST] [--channels LIST]
+//                          [--streams N] [--budget GIB] [--format table|json]
+//
+// The license key is read from the AIC_SDK_LICENSE environment variable.
+
+#include "aic.hpp"
+#include "aic_memory.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+struct Options
+{
+    std::string model_path;
+    std::string rates      = "opt";
+    std::string frames     = "opt";
+    std::string channels   = "1,2";
+    size_t      streams    = 8;
+    double      budget_gib = 1.0;
+    std::string format     = "table";
+};
+
+// Plain data, so forked children can send it through a pipe as-is.
+struct Measurement
+{
+    int                  error;
+    aic::FootprintReport report;
+};
+
+std::vector<std::string> split(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream        stream(list);
+    std::string              item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+Measurement measure(const Options& options, const std::string& license,
+                    const aic::ProcessorConfig& config)
+{
+    auto        result = aic::measure_footprint(options.model_path, license, config,
+                                                options.streams);
+    Measurement measurement;
+    measurement.error  = static_cast<int>(result.error);
+    measurement.report = result.value;
+    return measurement;
+}
+
+#if !defined(_WIN32)
+bool write_all(int fd, const std::string& bytes)
+{
+    size_t sent = 0;
+    while (sent < bytes.size())
+    {
+        ssize_t n = write(fd, bytes.data() + sent, bytes.size() - sent);
+        if (n <= 0)
+        {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::string read_all(int fd)
+{
+    std::string bytes;
+    char        buffer[4096];
+    ssize_t     n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        bytes.append(buffer, static_cast<size_t>(n));
+    }
+    return bytes;
+}
+#endif
+
+// Runs `body` in a forked child and returns the bytes it produced through a pipe. Returns false
+// if the child could not be started or exited abnormally. Runs `body` in-process on Windows.
+template <typename Body> bool run_in_child(Body body, std::string& output)
+{
+#if defined(_WIN32)
+    output = body();
+    return true;
+#else
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return false;
+    }
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(fds[0]);
+        const bool sent = write_all(fds[1], body());
+        _exit(sent ? 0 : 1);
+    }
+    close(fds[1]);
+    int status = 0;
+    if (child > 0)
+    {
+        output = read_all(fds[0]);
+        waitpid(child, &status, 0);
+    }
+    close(fds[0]);
+    return child > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#endif
+}
+
+// Measures one configuration in a forked child.
+Measurement measure_in_child(const Options& options, const std::string& license,
+                             const aic::ProcessorConfig& config)
+{
+    Measurement measurement = {};
+    measurement.error       = static_cast<int>(aic::ErrorCode::InternalError);
+
+    std::string output;
+    const bool  ok = run_in_child(
+        [&]() -> std::string
+        {
+            Measurement result = measure(options, license, config);
+            return std::string(reinterpret_cast<const char*>(&result), sizeof(result));
+        },
+        output);
+    if (ok && output.size() == sizeof(measurement))
+    {
+        std::memcpy(&measurement, output.data(), sizeof(measurement));
+    }
+    return measurement;
+}
+
+// Loads the model to expand the lists into configurations, resolving "opt" entries.
+int resolve_configs(const Options& options, std::vector<aic::ProcessorConfig>& configs)
+{
+    auto model_result = aic::Model::create_from_file(options.model_path);
+    if (!model_result.ok())
+    {
+        return static_cast<int>(model_result.error);
+    }
+    aic::Model model = model_result.take();
+
+    for (const std::string& rate_item : split(options.rates))
+    {
+        const uint32_t sample_rate =
+            rate_item == "opt"
+                ? model.get_optimal_sample_rate()
+                : static_cast<uint32_t>(std::strtoul(rate_item.c_str(), nullptr, 10));
+        const size_t optimal = model.get_optimal_num_frames(sample_rate);
+
+        for (const std::string& frames_item : split(options.frames))
+        {
+            const size_t num_frames =
+                frames_item == "opt" ? optimal : std::strtoull(frames_item.c_str(), nullptr, 10);
+            for (const std::string& channel_item : split(options.channels))
+            {
+                const uint16_t num_channels =
+                    static_cast<uint16_t>(std::atoi(channel_item.c_str()));
+                configs.push_back(aic::ProcessorConfig(sample_rate, num_frames, num_channels));
+            }
+        }
+    }
+    return static_cast<int>(aic::ErrorCode::Success);
+}
+
+// Resolves the configurations in a throwaway child, so the parent stays free of the model's
+// pages and of any threads the SDK starts, and every measured child forks from a clean process.
+int resolve_configs_in_child(const Options& options, std::vector<aic::ProcessorConfig>& configs)
+{
+    std::string output;
+    const bool  ok = run_in_child(
+        [&]() -> std::string
+        {
+            std::vector<aic::ProcessorConfig> resolved;
+
+            const int   error = resolve_configs(options, resolved);
+            std::string bytes(reinterpret_cast<const char*>(&error), sizeof(error));
+            bytes.append(reinterpret_cast<const char*>(resolved.data()),
+                         resolved.size() * sizeof(aic::ProcessorConfig));
+            return bytes;
+        },
+        output);
+    if (!ok || output.size() < sizeof(int) ||
+        (output.size() - sizeof(int)) % sizeof(aic::ProcessorConfig) != 0)
+    {
+        return static_cast<int>(aic::ErrorCode::InternalError);
+    }
+
+    int error;
+    std::memcpy(&error, output.data(), sizeof(error));
+    const size_t count = (output.size() - sizeof(int)) / sizeof(aic::ProcessorConfig);
+    for (size_t i = 0; i < count; ++i)
+    {
+        aic::ProcessorConfig config(0, 0);
+        std::memcpy(&config, output.data() + sizeof(int) + i * sizeof(config), sizeof(config));
+        configs.push_back(config);
+    }
+    return error;
+}
+
+int64_t stream_anonymous_bytes(const aic::FootprintReport& report)
+{
+    return report.processor.anonymous_bytes + report.context.anonymous_bytes +
+           report.vad_context.anonymous_bytes;
+}
+
+int64_t stream_resident_bytes(const aic::FootprintReport& report)
+{
+    return report.processor.resident_bytes + report.context.resident_bytes +
+           report.vad_context.resident_bytes;
+}
+
+int64_t streams_per_budget(const aic::FootprintReport& report, double budget_gib)
+{
+    const double budget = budget_gib * 1024.0 * 1024.0 * 1024.0;
+    const double free   = budget - static_cast<double>(report.model.anonymous_bytes);
+    const double stream = static_cast<double>(std::max<int64_t>(stream_anonymous_bytes(report), 1));
+    return free > 0.0 ? static_cast<int64_t>(free / stream) : 0;
+}
+
+double kib(int64_t bytes)
+{
+    return static_cast<double>(bytes) / 1024.0;
+}
+
+void print_table(const std::vector<aic::FootprintReport>& reports, const Options& options)
+{
+    std::ostringstream budget;
+    budget << "streams/" << options.budget_gib << "GiB";
+
+    std::cout << "Per-component memory in KiB (rss / anon), averaged over " << options.streams
+              << " streams\n";
+    std::cout << std::left << std::setw(22) << "config" << std::right << std::setw(20) << "model"
+              << std::setw(18) << "processor" << std::setw(16) << "context" << std::setw(16)
+              << "vad_context" << std::setw(18) << "stream" << std::setw(16) << budget.str()
+              << "\n";
+    for (const aic::FootprintReport& r : reports)
+    {
+        std::ostringstream config;
+        config << r.sample_rate << "Hz " << r.num_channels << "ch " << r.num_frames << "fr";
+
+        std::ostringstream cells[5];
+        const aic::MemoryUsage* usages[] = {&r.model, &r.processor, &r.context, &r.vad_context};
+        for (int i = 0; i < 4; ++i)
+        {
+            cells[i] << std::fixed << std::setprecision(0) << kib(usages[i]->resident_bytes)
+                     << " / " << kib(usages[i]->anonymous_bytes);
+        }
+        cells[4] << std::fixed << std::setprecision(0) << kib(stream_resident_bytes(r)) << " / "
+                 << kib(stream_anonymous_bytes(r));
+
+        std::cout << std::left << std::setw(22) << config.str() << std::right << std::setw(20)
+                  << cells[0].str() << std::setw(18) << cells[1].str() << std::setw(16)
+                  << cells[2].str() << std::setw(16) << cells[3].str() << std::setw(18)
+                  << cells[4].str() << std::setw(16) << streams_per_budget(r, options.budget_gib)
+                  << "\n";
+    }
+}
+
+void print_usage_json(const char* name, const aic::MemoryUsage& usage, bool last)
+{
+    std::cout << "\"" << name << "\": {\"resident_bytes\": " << usage.resident_bytes
+              << ", \"proportional_bytes\": " << usage.proportional_bytes
+              << ", \"anonymous_bytes\": " << usage.anonymous_bytes << "}" << (last ? "" : ", ");
+}
+
+void print_json(const std::vector<aic::FootprintReport>& reports, const Options& options)
+{
+    std::cout << "{\n"
+              << "  \"sdk_version\": \"" << aic::get_sdk_version() << "\",\n"
+              << "  \"streams\": " << options.streams << ",\n"
+              << "  \"budget_gib\": " << options.budget_gib << ",\n"
+              << "  \"results\": [\n";
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        const aic::FootprintReport& r = reports[i];
+        std::cout << "    {\"sample_rate\": " << r.sample_rate
+                  << ", \"num_channels\": " << r.num_channels
+                  << ", \"num_frames\": " << r.num_frames << ", ";
+        print_usage_json("model", r.model, false);
+        print_usage_json("processor", r.processor, false);
+        print_usage_json("context", r.context, false);
+        print_usage_json("vad_context", r.vad_context, false);
+        std::cout << "\"stream_anonymous_bytes\": " << stream_anonymous_bytes(r)
+                  << ", \"streams_per_budget\": " << streams_per_budget(r, options.budget_gib)
+                  << "}" << (i + 1 < reports.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-memory-report <model_path> [--rates LIST] [--frames LIST] "
+                 "[--channels LIST]\n"
+                 "                         [--streams N] [--budget GIB] "
+                 "[--format table|json]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--rates" && i + 1 < argc)
+        {
+            options.rates = argv[++i];
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.frames = argv[++i];
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.channels = argv[++i];
+        }
+        else if (arg == "--streams" && i + 1 < argc)
+        {
+            options.streams = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--budget" && i + 1 < argc)
+        {
+            options.budget_gib = std::atof(argv[++i]);
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            options.format = argv[++i];
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (options.model_path.empty() || options.streams == 0 || options.budget_gib <= 0.0 ||
+        (options.format != "table" && options.format != "json"))
+    {
+        return usage();
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    std::vector<aic::ProcessorConfig> configs;
+    const int                         error = resolve_configs_in_child(options, configs);
+    if (error != static_cast<int>(aic::ErrorCode::Success))
+    {
+        std::cerr << "Model loading failed with error code: " << error << "\n";
+        return 1;
+    }
+
+    const std::string                 key = license;
+    std::vector<aic::FootprintReport> reports;
+    for (const aic::ProcessorConfig& config : configs)
+    {
+        Measurement measurement = measure_in_child(options, key, config);
+        if (measurement.error != static_cast<int>(aic::ErrorCode::Success))
+        {
+            std::cerr << "Skipping " << config.sample_rate << " Hz, " << config.num_channels
+                      << " ch, " << config.num_frames << " frames: measurement failed with "
+                      << "error code: " << measurement.error << "\n";
+            continue;
+        }
+        reports.push_back(measurement.report);
+    }
+    if (reports.empty())
+    {
+        return 1;
+    }
+
+    if (options.format == "json")
+    {
+        print_json(reports, options);
+    }
+    else
+    {
+        print_table(reports, options);
+    }
+    return 0;
+}
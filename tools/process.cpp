@@ -0,0 +1,1579 @@
+// Offline enhancement of WAV files.
+//
+// Streams the input through a Processor at the model's optimal frame count for the file's
+// sample rate, without ever holding the whole file in memory. Audio is read and written in large
+// blocks (--buffer-frames, rounded up to a multiple of the frame count) through the WAV reader
+// and writer, so file I/O stays a small fraction of the processing time.
+//
+// The output is sample-aligned with the input and has the same length: the first
+// ProcessorContext::get_output_delay frames of output are dropped, and at the end just enough
+// blocks of silence bring the last input frames out of the model.
+//
+// Inputs may be RIFF, RF64 or BW64 files with 16-, 24- or 32-bit integer or 32- or 64-bit float
+// samples. The output keeps the input's sample format unless --sample-format says otherwise,
+// and switches to RF64 when it grows beyond 4 GiB. An output path that names the input file is
+// refused, since creating the output would truncate the input.
+//
+// With --jobs other than 1 the recording is split into chunks of --chunk-seconds that are
+// enhanced concurrently by aic::process_chunked, each on its own processor after a warm-up over
+// --overlap-seconds of preceding input, and joined with a --crossfade-ms crossfade. --jobs 0
+// uses every core. Inputs whose header leaves the length open are processed on one thread.
+//
+// With --batch the input is a directory (every *.wav file in it) or a manifest file listing one
+// input path per line, and the output is a directory that receives files of the same names.
+// A manifest that lists two inputs with the same file name, or an output directory that would
+// overwrite an input (such as the input directory itself), is rejected before any processing.
+// --jobs worker threads each keep one initialized processor and only re-initialize it when a
+// file's sample rate or channel count differs from the previous one. Files are sorted by size,
+// longest first, and dealt out to per-worker deques; a worker takes the longest file of its own
+// deque and, once that is empty, steals the shortest file of another worker, so no core idles
+// while long files are still queued. The report lists files per second, the aggregate real-time
+// factor and the utilization of every worker.
+//
+// With --vad a VadContext follows the processor through the same pass, and its prediction after
+// every process call is turned into speech segments of the input, corrected for the output
+// delay and widened by --vad-padding-ms on both sides. "trim" writes only the enhanced speech
+// segments, so silence is not billed downstream; "csv" and "json" write the segment list (frame
+// offsets, seconds, and offsets in the trimmed audio) to the output path instead of audio.
+// --vad-sensitivity and --vad-hold-ms set the VAD's parameters.
+//
+// With --pipe the input is raw interleaved little-endian PCM of the given format, --rate and
+// --channels on stdin, and the enhanced audio is written to stdout in the same format, delay
+// trimmed, so the tool fits between ffmpeg or sox commands without temporary files. A reader
+// thread fills --buffer-frames blocks from stdin and converts them to float, the main thread
+// enhances them, and a writer thread converts them back and writes them to stdout, so both
+// directions of I/O overlap the processing. The report goes to stderr.
+//
+// Usage: aic-process <model_path> <input.wav> <output.wav> [--enhancement LEVEL]
+//                    [--sample-format same|int16|int24|int32|float32] [--buffer-frames N]
+//                    [--jobs N] [--chunk-seconds S] [--overlap-seconds S] [--crossfade-ms MS]
+//                    [--vad trim|csv|json] [--vad-padding-ms MS] [--vad-sensitivity S]
+//                    [--vad-hold-ms MS]
+//        aic-process <model_path> --batch <input_dir|manifest> <output_dir> [--jobs N]
+//                    [--enhancement LEVEL] [--sample-format FORMAT] [--buffer-frames N]
+//        aic-process <model_path> --pipe s16le|s24le|s32le|f32le --rate HZ --channels N
+//                    [--enhancement LEVEL] [--buffer-frames N]
+//
+// The license key is read from the AIC_SDK_LICENSE environment variable.
+
+#include "aic.hpp"
+#include "aic_chunked.hpp"
+#include "aic_speech_segments.hpp"
+#include "aic_wav.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <direct.h>
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+namespace
+{
+
+struct Options
+{
+    std::string model_path;
+    std::string input_path;
+    std::string output_path;
+    float       enhancement     = -1.0f;
+    std::string sample_format   = "same";
+    size_t      buffer_frames   = 65536;
+    size_t      jobs            = 1;
+    double      chunk_seconds   = 60.0;
+    double      overlap_seconds = 1.0;
+    double      crossfade_ms    = 10.0;
+    bool        batch           = false;
+    std::string pipe;
+    uint32_t    rate     = 0;
+    uint16_t    channels = 0;
+    std::string vad;
+    double      vad_padding_ms  = 200.0;
+    float       vad_sensitivity = -1.0f;
+    double      vad_hold_ms     = -1.0;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool parse_sample_format(const std::string& name, aic::SampleFormat& format)
+{
+    if (name == "int16")
+    {
+        format = aic::SampleFormat::Int16;
+    }
+    else if (name == "int24")
+    {
+        format = aic::SampleFormat::Int24;
+    }
+    else if (name == "int32")
+    {
+        format = aic::SampleFormat::Int32;
+    }
+    else if (name == "float32")
+    {
+        format = aic::SampleFormat::Float32;
+    }
+    else
+    {
+        return name == "same";
+    }
+    return true;
+}
+
+// Speech detection alongside the enhancement (--vad). The VAD context follows the processor's
+// output, so segmentation needs no second pass over the file.
+struct SpeechTrack
+{
+    aic::VadContext      vad;
+    aic::SpeechSegmenter segmenter;
+    bool                 trim;
+    uint64_t             padding;
+    std::vector<float>   preroll;
+    uint64_t             hangover;
+    size_t               cursor;
+
+    SpeechTrack(aic::VadContext&& vad, size_t delay, bool trim, uint64_t padding)
+        : vad(std::move(vad))
+        , segmenter(delay)
+        , trim(trim)
+        , padding(padding)
+        , hangover(0)
+        , cursor(0)
+    {}
+};
+
+// Writes `count` enhanced frames that line up with input frames from `first` on: all of them,
+// or with --vad trim only the speech segments widened by the padding. The last `padding` frames
+// of silence are held back until it is clear whether speech follows them.
+aic::ErrorCode emit(aic::WavWriter* writer, SpeechTrack* speech, const float* audio,
+                    uint64_t first, size_t count, uint16_t channels)
+{
+    if (!writer)
+    {
+        return aic::ErrorCode::Success;
+    }
+    if (!speech || !speech->trim)
+    {
+        return writer->write_interleaved(audio, count);
+    }
+
+    const std::vector<aic::SpeechSegment>& segments = speech->segmenter.get_segments();
+    aic::ErrorCode                         err      = aic::ErrorCode::Success;
+    for (size_t done = 0; done < count && err == aic::ErrorCode::Success;)
+    {
+        const uint64_t frame = first + done;
+        while (speech->cursor < segments.size() && segments[speech->cursor].end_frame <= frame)
+        {
+            ++speech->cursor;
+        }
+        const bool     has_next  = speech->cursor < segments.size();
+        const bool     is_speech = has_next && segments[speech->cursor].first_frame <= frame;
+        const uint64_t run_end   = !has_next   ? UINT64_MAX
+                                   : is_speech ? segments[speech->cursor].end_frame
+                                               : segments[speech->cursor].first_frame;
+        const size_t   frames    = static_cast<size_t>(std::min<uint64_t>(count - done,
+                                                                          run_end - frame));
+        const float*   run       = audio + done * channels;
+        if (is_speech)
+        {
+            err = writer->write_interleaved(speech->preroll.data(),
+                                            speech->preroll.size() / channels);
+            speech->preroll.clear();
+            if (err == aic::ErrorCode::Success)
+            {
+                err = writer->write_interleaved(run, frames);
+            }
+            speech->hangover = speech->padding;
+        }
+        else
+        {
+            const size_t kept = static_cast<size_t>(std::min<uint64_t>(speech->hangover, frames));
+            err               = writer->write_interleaved(run, kept);
+            speech->hangover -= kept;
+            speech->preroll.insert(speech->preroll.end(), run + kept * channels,
+                                   run + frames * channels);
+            const size_t limit = static_cast<size_t>(speech->padding) * channels;
+            if (speech->preroll.size() > limit)
+            {
+                speech->preroll.erase(speech->preroll.begin(),
+                                      speech->preroll.end() - static_cast<std::ptrdiff_t>(limit));
+            }
+        }
+        done += frames;
+    }
+    return err;
+}
+
+// Brings the last input frames out of the processor after the final block and resets the
+// context. The zero padding of that block has already pushed part of the output delay out, so
+// instead of Processor::drain_interleaved, which pushes the whole delay, this pushes only as many
+// blocks of silence as the `missing` output frames need. `audio` needs room for that many
+// blocks; `flushed` receives the number of frames processed into it.
+aic::ErrorCode flush_tail(aic::Processor& processor, const aic::ProcessorContext& context,
+                          SpeechTrack* speech, float* audio, uint16_t channels, size_t num_frames,
+                          uint64_t missing, size_t& flushed)
+{
+    const size_t blocks = static_cast<size_t>((missing + num_frames - 1) / num_frames);
+    flushed             = blocks * num_frames;
+    std::fill(audio, audio + flushed * channels, 0.0f);
+    for (size_t offset = 0; offset < flushed; offset += num_frames)
+    {
+        aic::ErrorCode err =
+            processor.process_interleaved(audio + offset * channels, channels, num_frames);
+        if (err != aic::ErrorCode::Success)
+        {
+            return err;
+        }
+        if (speech)
+        {
+            speech->segmenter.record(speech->vad.is_speech_detected(), num_frames);
+        }
+    }
+    return context.reset();
+}
+
+// Streams the file through one processor, dropping the first `delay` output frames and
+// flushing the tail once the input ends. `writer` may be null when only `speech` is wanted.
+aic::ErrorCode run_streaming(aic::WavReader& reader, aic::WavWriter* writer, SpeechTrack* speech,
+                             aic::Processor& processor, const aic::ProcessorContext& context,
+                             size_t num_frames, size_t buffer_frames, uint64_t& total_in,
+                             double& process_s)
+{
+    const uint16_t channels     = reader.get_format().num_channels;
+    const size_t   chunk_frames = (buffer_frames + num_frames - 1) / num_frames * num_frames;
+    const size_t   delay        = context.get_output_delay();
+    const size_t   delay_frames = (delay + num_frames - 1) / num_frames * num_frames;
+
+    std::vector<float> buffer(std::max(chunk_frames, delay_frames) * channels);
+
+    // Output frame i (after dropping the first `delay`) corresponds to input frame i. The last
+    // block is padded with zeros to the frame count; whatever the delay still holds back after
+    // it comes out of flush_tail.
+    uint64_t written = 0;
+    uint64_t to_skip = delay;
+    total_in         = 0;
+    for (;;)
+    {
+        size_t filled = 0;
+        while (filled < chunk_frames)
+        {
+            auto read = reader.read_interleaved(buffer.data() + filled * channels,
+                                                chunk_frames - filled);
+            if (!read.ok())
+            {
+                return read.error;
+            }
+            if (read.value == 0)
+            {
+                break;
+            }
+            filled += read.value;
+        }
+        if (filled == 0)
+        {
+            break;
+        }
+        total_in += filled;
+        const size_t padded = (filled + num_frames - 1) / num_frames * num_frames;
+        std::fill(buffer.begin() + filled * channels, buffer.begin() + padded * channels, 0.0f);
+
+        const Clock::time_point process_start = Clock::now();
+        for (size_t offset = 0; offset < padded; offset += num_frames)
+        {
+            aic::ErrorCode err = processor.process_interleaved(
+                buffer.data() + offset * channels, channels, num_frames);
+            if (err != aic::ErrorCode::Success)
+            {
+                return err;
+            }
+            if (speech)
+            {
+                speech->segmenter.record(speech->vad.is_speech_detected(), num_frames);
+            }
+        }
+        process_s += seconds_since(process_start);
+
+        const size_t skipped = static_cast<size_t>(std::min<uint64_t>(to_skip, padded));
+        const size_t count   = static_cast<size_t>(
+            std::min<uint64_t>(padded - skipped, total_in - written));
+        to_skip -= skipped;
+        aic::ErrorCode err =
+            emit(writer, speech, buffer.data() + skipped * channels, written, count, channels);
+        if (err != aic::ErrorCode::Success)
+        {
+            return err;
+        }
+        written += count;
+    }
+
+    // Output frames still missing: what is left to skip plus the input not written yet.
+    const uint64_t          missing     = total_in > written ? to_skip + total_in - written : 0;
+    size_t                  flushed     = 0;
+    const Clock::time_point flush_start = Clock::now();
+    aic::ErrorCode          err         = flush_tail(processor, context, speech, buffer.data(),
+                                                     channels, num_frames, missing, flushed);
+    process_s += seconds_since(flush_start);
+    if (err != aic::ErrorCode::Success)
+    {
+        return err;
+    }
+    const size_t skipped = static_cast<size_t>(std::min<uint64_t>(to_skip, flushed));
+    const size_t count   = static_cast<size_t>(
+        std::min<uint64_t>(flushed - skipped, total_in - written));
+    return emit(writer, speech, buffer.data() + skipped * channels, written, count, channels);
+}
+
+// Writes the speech segments as CSV or JSON, with the position of every segment in the trimmed
+// audio so timestamps found there can be mapped back to the recording.
+bool write_segments(const std::string& path, const std::string& format,
+                    const std::vector<aic::SpeechSegment>& segments, uint32_t sample_rate,
+                    uint64_t total_frames, double padding_ms)
+{
+    std::ofstream out(path.c_str());
+    if (!out)
+    {
+        return false;
+    }
+    const double rate    = sample_rate;
+    uint64_t     trimmed = 0;
+    out << std::fixed << std::setprecision(3);
+    if (format == "csv")
+    {
+        out << "first_frame,end_frame,start_s,end_s,trimmed_first_frame\n";
+        for (const aic::SpeechSegment& segment : segments)
+        {
+            out << segment.first_frame << "," << segment.end_frame << ","
+                << segment.first_frame / rate << "," << segment.end_frame / rate << ","
+                << trimmed << "\n";
+            trimmed += segment.end_frame - segment.first_frame;
+        }
+    }
+    else
+    {
+        out << "{\n"
+            << "  \"sdk_version\": \"" << aic::get_sdk_version() << "\",\n"
+            << "  \"sample_rate\": " << sample_rate << ",\n"
+            << "  \"total_frames\": " << total_frames << ",\n"
+            << "  \"padding_ms\": " << padding_ms << ",\n"
+            << "  \"segments\": [\n";
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            const aic::SpeechSegment& segment = segments[i];
+            out << "    {\"first_frame\": " << segment.first_frame
+                << ", \"end_frame\": " << segment.end_frame
+                << ", \"start_s\": " << segment.first_frame / rate
+                << ", \"end_s\": " << segment.end_frame / rate
+                << ", \"trimmed_first_frame\": " << trimmed << "}"
+                << (i + 1 < segments.size() ? ",\n" : "\n");
+            trimmed += segment.end_frame - segment.first_frame;
+        }
+        out << "  ]\n}\n";
+    }
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+// Enhances the file in concurrently processed chunks. The reader must know the file's length.
+aic::ErrorCode run_chunked(const Options& options, const aic::Model& model,
+                           const std::string& license, aic::WavReader& reader,
+                           aic::WavWriter& writer, size_t num_frames)
+{
+    const aic::WavFormat& format    = reader.get_format();
+    const double          rate      = format.sample_rate;
+    const size_t          crossfade = static_cast<size_t>(options.crossfade_ms * rate / 1000.0);
+
+    aic::ChunkedConfig config(format.sample_rate, format.num_channels, reader.get_num_frames());
+    config.num_frames       = num_frames;
+    config.chunk_frames     = static_cast<size_t>(std::max(1.0, options.chunk_seconds * rate));
+    config.overlap_frames   = static_cast<size_t>(options.overlap_seconds * rate);
+    config.crossfade_frames = std::min(config.chunk_frames, crossfade);
+    config.num_threads      = options.jobs;
+
+    auto source = [&reader](uint64_t first_frame, float* audio, size_t frames)
+    {
+        const size_t   channels = reader.get_format().num_channels;
+        aic::ErrorCode err      = reader.seek(first_frame);
+        size_t         done     = 0;
+        while (err == aic::ErrorCode::Success && done < frames)
+        {
+            auto read = reader.read_interleaved(audio + done * channels, frames - done);
+            err       = read.ok() && read.value == 0 ? aic::ErrorCode::FileSystemError : read.error;
+            done += read.value;
+        }
+        return err;
+    };
+    auto sink = [&writer](const float* audio, size_t frames)
+    { return writer.write_interleaved(audio, frames); };
+    auto setup = [&options](const aic::ProcessorContext& context)
+    {
+        return options.enhancement >= 0.0f
+                   ? context.set_parameter(aic::ProcessorParameter::EnhancementLevel,
+                                           options.enhancement)
+                   : aic::ErrorCode::Success;
+    };
+    return aic::process_chunked(model, license, config, source, sink, setup);
+}
+
+// ---------------------------
+// Batch mode
+// ---------------------------
+
+struct BatchFile
+{
+    std::string input_path;
+    std::string output_path;
+    uint64_t    size;
+};
+
+struct WorkerStats
+{
+    size_t files             = 0;
+    size_t failures          = 0;
+    size_t steals            = 0;
+    size_t reinitializations = 0;
+    double busy_s            = 0.0;
+    double audio_s           = 0.0;
+};
+
+// One deque per worker. The owner takes from the front, where the longest files are; thieves
+// take from the back, so the small files left at the end fill the gaps between workers.
+struct WorkQueues
+{
+    std::vector<std::deque<size_t>>          deques;
+    std::vector<std::unique_ptr<std::mutex>> mutexes;
+
+    explicit WorkQueues(size_t num_workers) : deques(num_workers)
+    {
+        for (size_t i = 0; i < num_workers; ++i)
+        {
+            mutexes.push_back(std::unique_ptr<std::mutex>(new std::mutex()));
+        }
+    }
+
+    bool pop(size_t worker, size_t& item, bool& stolen)
+    {
+        {
+            std::lock_guard<std::mutex> lock(*mutexes[worker]);
+            if (!deques[worker].empty())
+            {
+                item = deques[worker].front();
+                deques[worker].pop_front();
+                stolen = false;
+                return true;
+            }
+        }
+        for (size_t i = 1; i < deques.size(); ++i)
+        {
+            const size_t                victim = (worker + i) % deques.size();
+            std::lock_guard<std::mutex> lock(*mutexes[victim]);
+            if (!deques[victim].empty())
+            {
+                item = deques[victim].back();
+                deques[victim].pop_back();
+                stolen = true;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+std::string file_name(const std::string& path)
+{
+    const size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool has_wav_extension(const std::string& name)
+{
+    if (name.size() < 4)
+    {
+        return false;
+    }
+    std::string extension = name.substr(name.size() - 4);
+    for (char& c : extension)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return extension == ".wav";
+}
+
+bool is_directory(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR;
+}
+
+uint64_t file_size(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+}
+
+// True if both paths name the same existing file. Creating the output truncates it, so an output
+// that is its own input would destroy the input while it is still being read.
+bool same_file(const std::string& a, const std::string& b)
+{
+#if defined(_WIN32)
+    // st_ino is always 0 on Windows; compare the full paths instead.
+    char full_a[_MAX_PATH];
+    char full_b[_MAX_PATH];
+    return _fullpath(full_a, a.c_str(), _MAX_PATH) && _fullpath(full_b, b.c_str(), _MAX_PATH) &&
+           _stricmp(full_a, full_b) == 0;
+#else
+    struct stat info_a;
+    struct stat info_b;
+    return stat(a.c_str(), &info_a) == 0 && stat(b.c_str(), &info_b) == 0 &&
+           info_a.st_dev == info_b.st_dev && info_a.st_ino == info_b.st_ino;
+#endif
+}
+
+bool make_directory(const std::string& path)
+{
+#if defined(_WIN32)
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+    return is_directory(path);
+}
+
+// Collects the *.wav files of a directory, or the paths listed in a manifest (one per line,
+// blank lines and lines starting with '#' are skipped).
+bool list_inputs(const std::string& input, std::vector<std::string>& paths)
+{
+    if (is_directory(input))
+    {
+#if defined(_WIN32)
+        WIN32_FIND_DATAA entry;
+        HANDLE           find = FindFirstFileA((input + "\\*").c_str(), &entry);
+        if (find == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        do
+        {
+            if (!(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) &&
+                has_wav_extension(entry.cFileName))
+            {
+                paths.push_back(input + "\\" + entry.cFileName);
+            }
+        } while (FindNextFileA(find, &entry));
+        FindClose(find);
+#else
+        DIR* dir = opendir(input.c_str());
+        if (!dir)
+        {
+            return false;
+        }
+        while (dirent* entry = readdir(dir))
+        {
+            const std::string path = input + "/" + entry->d_name;
+            if (has_wav_extension(entry->d_name) && !is_directory(path))
+            {
+                paths.push_back(path);
+            }
+        }
+        closedir(dir);
+#endif
+        std::sort(paths.begin(), paths.end());
+        return true;
+    }
+
+    std::ifstream manifest(input.c_str());
+    if (!manifest)
+    {
+        return false;
+    }
+    std::string line;
+    while (std::getline(manifest, line))
+    {
+        if (!line.empty() && line[line.size() - 1] == '\r')
+        {
+            line.erase(line.size() - 1);
+        }
+        if (!line.empty() && line[0] != '#')
+        {
+            paths.push_back(line);
+        }
+    }
+    return true;
+}
+
+// Keeps one processor per worker and re-initializes it only when the audio format changes.
+struct BatchWorker
+{
+    aic::Processor                         processor;
+    std::unique_ptr<aic::ProcessorContext> context;
+    uint32_t                               sample_rate;
+    uint16_t                               num_channels;
+    size_t                                 num_frames;
+
+    explicit BatchWorker(aic::Processor&& p)
+        : processor(std::move(p))
+        , sample_rate(0)
+        , num_channels(0)
+        , num_frames(0)
+    {}
+
+    aic::ErrorCode prepare(const aic::Model& model, const aic::WavFormat& format,
+                           const Options& options, WorkerStats& stats)
+    {
+        if (context && format.sample_rate == sample_rate && format.num_channels == num_channels)
+        {
+            return context->reset();
+        }
+
+        context.reset();
+        num_frames         = model.get_optimal_num_frames(format.sample_rate);
+        aic::ErrorCode err = processor.initialize(format.sample_rate, format.num_channels,
+                                                  num_frames, false);
+        if (err != aic::ErrorCode::Success)
+        {
+            return err;
+        }
+        auto context_result = processor.create_context();
+        if (!context_result.ok())
+        {
+            return context_result.error;
+        }
+        context.reset(new aic::ProcessorContext(context_result.take()));
+        if (options.enhancement >= 0.0f)
+        {
+            err = context->set_parameter(aic::ProcessorParameter::EnhancementLevel,
+                                         options.enhancement);
+            if (err != aic::ErrorCode::Success)
+            {
+                context.reset();
+                return err;
+            }
+        }
+        sample_rate  = format.sample_rate;
+        num_channels = format.num_channels;
+        ++stats.reinitializations;
+        return aic::ErrorCode::Success;
+    }
+};
+
+aic::ErrorCode process_file(BatchWorker& worker, const aic::Model& model, const Options& options,
+                            aic::SampleFormat output_format, const BatchFile& file,
+                            WorkerStats& stats)
+{
+    auto reader_result = aic::WavReader::create(file.input_path);
+    if (!reader_result.ok())
+    {
+        return reader_result.error;
+    }
+    aic::WavReader reader = reader_result.take();
+    aic::ErrorCode err    = worker.prepare(model, reader.get_format(), options, stats);
+    if (err != aic::ErrorCode::Success)
+    {
+        return err;
+    }
+
+    aic::WavFormat output = reader.get_format();
+    if (options.sample_format != "same")
+    {
+        output.sample_format = output_format;
+    }
+    auto writer_result = aic::WavWriter::create(file.output_path, output);
+    if (!writer_result.ok())
+    {
+        return writer_result.error;
+    }
+    aic::WavWriter writer    = writer_result.take();
+    uint64_t       total_in  = 0;
+    double         process_s = 0.0;
+    err = run_streaming(reader, &writer, nullptr, worker.processor, *worker.context,
+                        worker.num_frames, options.buffer_frames, total_in, process_s);
+    if (err == aic::ErrorCode::Success)
+    {
+        err = writer.finish();
+    }
+    if (err == aic::ErrorCode::Success)
+    {
+        stats.audio_s += static_cast<double>(writer.get_num_frames()) / output.sample_rate;
+    }
+    return err;
+}
+
+int run_batch(const Options& options, const aic::Model& model, const std::string& license,
+              aic::SampleFormat output_format)
+{
+    std::vector<std::string> paths;
+    if (!list_inputs(options.input_path, paths))
+    {
+        std::cerr << "Cannot read " << options.input_path << "\n";
+        return 1;
+    }
+
+    // Two workers writing the same output file would corrupt it.
+    std::map<std::string, std::string> outputs;
+    for (const std::string& path : paths)
+    {
+        const std::string& first = outputs[file_name(path)];
+        if (!first.empty())
+        {
+            std::cerr << path << " and " << first << " would both be written to "
+                      << options.output_path << "/" << file_name(path) << "\n";
+            return 1;
+        }
+        outputs[file_name(path)] = path;
+    }
+    if (!make_directory(options.output_path))
+    {
+        std::cerr << "Cannot create " << options.output_path << "\n";
+        return 1;
+    }
+
+    std::vector<BatchFile> files;
+    for (const std::string& path : paths)
+    {
+        BatchFile file = {path, options.output_path + "/" + file_name(path), file_size(path)};
+        if (same_file(file.input_path, file.output_path))
+        {
+            std::cerr << path << " would be overwritten by its own output; choose another "
+                      << "output directory\n";
+            return 1;
+        }
+        files.push_back(file);
+    }
+    std::stable_sort(files.begin(), files.end(),
+                     [](const BatchFile& a, const BatchFile& b) { return a.size > b.size; });
+
+    size_t num_workers = options.jobs;
+    if (num_workers == 0)
+    {
+        num_workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_workers = std::max<size_t>(1, std::min(num_workers, files.size()));
+
+    // Dealing the sorted files round-robin gives every worker a similar mix of lengths.
+    WorkQueues queues(num_workers);
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        queues.deques[i % num_workers].push_back(i);
+    }
+
+    std::vector<WorkerStats> stats(num_workers);
+    std::mutex               output_mutex;
+    std::vector<std::thread> workers;
+
+    const Clock::time_point start = Clock::now();
+    for (size_t w = 0; w < num_workers; ++w)
+    {
+        workers.push_back(std::thread(
+            [&, w]()
+            {
+                WorkerStats& worker_stats     = stats[w];
+                auto         processor_result = aic::Processor::create(model, license);
+                if (!processor_result.ok())
+                {
+                    std::lock_guard<std::mutex> lock(output_mutex);
+                    std::cerr << "Processor creation failed with error code: "
+                              << static_cast<int>(processor_result.error) << "\n";
+                    return;
+                }
+                BatchWorker worker(processor_result.take());
+
+                size_t item;
+                bool   stolen;
+                while (queues.pop(w, item, stolen))
+                {
+                    const Clock::time_point file_start = Clock::now();
+                    const aic::ErrorCode    err        = process_file(
+                        worker, model, options, output_format, files[item], worker_stats);
+                    worker_stats.busy_s += seconds_since(file_start);
+                    ++worker_stats.files;
+                    worker_stats.steals += stolen ? 1 : 0;
+                    if (err != aic::ErrorCode::Success)
+                    {
+                        ++worker_stats.failures;
+                        std::lock_guard<std::mutex> lock(output_mutex);
+                        std::cerr << files[item].input_path
+                                  << ": processing failed with error code: "
+                                  << static_cast<int>(err) << "\n";
+                    }
+                }
+            }));
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    const double wall_s = seconds_since(start);
+
+    WorkerStats total;
+    for (const WorkerStats& s : stats)
+    {
+        total.files += s.files;
+        total.failures += s.failures;
+        total.audio_s += s.audio_s;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "files:         " << files.size() << " (" << total.failures << " failed, "
+              << total.audio_s << " s of audio)\n";
+    std::cout << "wall time:     " << wall_s << " s, " << std::setprecision(1)
+              << static_cast<double>(total.files) / std::max(wall_s, 1e-9) << " files/s\n";
+    if (total.audio_s > 0.0)
+    {
+        std::cout << std::setprecision(4) << "rtf:           " << wall_s / total.audio_s
+                  << " (" << std::setprecision(1) << total.audio_s / std::max(wall_s, 1e-9)
+                  << "x real time)\n";
+    }
+    std::cout << "\n"
+              << std::right << std::setw(8) << "worker" << std::setw(8) << "files"
+              << std::setw(8) << "steals" << std::setw(8) << "inits" << std::setw(12)
+              << "audio_s" << std::setw(10) << "busy_s" << std::setw(13) << "utilization"
+              << "\n";
+    for (size_t w = 0; w < stats.size(); ++w)
+    {
+        const WorkerStats& s = stats[w];
+        std::cout << std::setw(8) << w << std::setw(8) << s.files << std::setw(8) << s.steals
+                  << std::setw(8) << s.reinitializations << std::setprecision(1)
+                  << std::setw(12) << s.audio_s << std::setprecision(3) << std::setw(10)
+                  << s.busy_s << std::setprecision(1) << std::setw(12)
+                  << 100.0 * s.busy_s / std::max(wall_s, 1e-9) << "%\n";
+    }
+    return total.failures == 0 && total.files == files.size() ? 0 : 1;
+}
+
+// ---------------------------
+// Pipe mode
+// ---------------------------
+
+bool parse_pipe_format(const std::string& name, aic::SampleFormat& format)
+{
+    if (name == "s16le")
+    {
+        format = aic::SampleFormat::Int16;
+    }
+    else if (name == "s24le")
+    {
+        format = aic::SampleFormat::Int24;
+    }
+    else if (name == "s32le")
+    {
+        format = aic::SampleFormat::Int32;
+    }
+    else if (name == "f32le")
+    {
+        format = aic::SampleFormat::Float32;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// One block of the pipe, as raw PCM and as float. After processing, `first` and `frames` select
+// the output frames of `audio`.
+struct PipeBlock
+{
+    std::vector<uint8_t> pcm;
+    std::vector<float>   audio;
+    size_t               first  = 0;
+    size_t               frames = 0;
+    bool                 last   = false;
+};
+
+// Blocking hand-over of blocks from one pipe stage to the next.
+class PipeQueue
+{
+  private:
+    std::mutex              mutex_;
+    std::condition_variable changed_;
+    std::deque<PipeBlock*>  blocks_;
+    bool                    closed_ = false;
+
+  public:
+    void push(PipeBlock* block)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blocks_.push_back(block);
+        changed_.notify_one();
+    }
+
+    // Returns the next block, or nullptr once the queue is closed and empty.
+    PipeBlock* pop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return closed_ || !blocks_.empty(); });
+        if (blocks_.empty())
+        {
+            return nullptr;
+        }
+        PipeBlock* block = blocks_.front();
+        blocks_.pop_front();
+        return block;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        changed_.notify_all();
+    }
+};
+
+// Blocks circulate from `idle` through the reader to `filled`, through the processing thread
+// to `processed`, and through the writer back to `idle`.
+struct PipeState
+{
+    PipeQueue         idle;
+    PipeQueue         filled;
+    PipeQueue         processed;
+    aic::SampleFormat format;
+    uint16_t          channels;
+    size_t            chunk_frames;
+    std::atomic<bool> failed;
+    std::mutex        mutex;
+    std::string       error;
+
+    PipeState(aic::SampleFormat format, uint16_t channels, size_t chunk_frames)
+        : format(format)
+        , channels(channels)
+        , chunk_frames(chunk_frames)
+        , failed(false)
+    {}
+
+    size_t frame_bytes() const
+    {
+        return aic::get_sample_size(format) * channels;
+    }
+
+    // Records the first error and stops every stage.
+    void fail(const std::string& message)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failed)
+            {
+                error  = message;
+                failed = true;
+            }
+        }
+        idle.close();
+        filled.close();
+        processed.close();
+    }
+};
+
+void read_pipe(PipeState& state)
+{
+    const size_t chunk_bytes = state.chunk_frames * state.frame_bytes();
+    for (;;)
+    {
+        PipeBlock* block = state.idle.pop();
+        if (!block || state.failed)
+        {
+            return;
+        }
+        const size_t bytes = std::fread(block->pcm.data(), 1, chunk_bytes, stdin);
+        if (std::ferror(stdin))
+        {
+            state.fail("Reading stdin failed");
+            return;
+        }
+        // A trailing partial frame is ignored.
+        block->frames = bytes / state.frame_bytes();
+        block->last   = bytes < chunk_bytes;
+        aic::convert_to_float(block->pcm.data(), state.format, block->audio.data(),
+                              block->frames * state.channels);
+        state.filled.push(block);
+        if (block->last)
+        {
+            state.filled.close();
+            return;
+        }
+    }
+}
+
+void write_pipe(PipeState& state)
+{
+    for (;;)
+    {
+        PipeBlock* block = state.processed.pop();
+        if (!block || state.failed)
+        {
+            return;
+        }
+        const size_t samples = block->frames * state.channels;
+        const size_t bytes   = block->frames * state.frame_bytes();
+        aic::convert_from_float(block->audio.data() + block->first * state.channels,
+                                block->pcm.data(), state.format, samples);
+        if (std::fwrite(block->pcm.data(), 1, bytes, stdout) != bytes)
+        {
+            state.fail("Writing stdout failed");
+            return;
+        }
+        const bool last = block->last;
+        state.idle.push(block);
+        if (last)
+        {
+            if (std::fflush(stdout) != 0)
+            {
+                state.fail("Writing stdout failed");
+            }
+            return;
+        }
+    }
+}
+
+// Processing stage: enhances each block in frames of `num_frames`, trims the output delay and
+// flushes the processor after the last block. Counts the input frames in `total_in`.
+aic::ErrorCode process_pipe(PipeState& state, aic::Processor& processor,
+                            const aic::ProcessorContext& context, size_t num_frames,
+                            uint64_t& total_in, double& process_s)
+{
+    const uint16_t channels = state.channels;
+    uint64_t       to_skip  = context.get_output_delay();
+    uint64_t       written  = 0;
+    for (;;)
+    {
+        PipeBlock* block = state.filled.pop();
+        if (!block || state.failed)
+        {
+            return aic::ErrorCode::Success;
+        }
+        total_in += block->frames;
+        const size_t padded = (block->frames + num_frames - 1) / num_frames * num_frames;
+        std::fill(block->audio.begin() + block->frames * channels,
+                  block->audio.begin() + padded * channels, 0.0f);
+
+        const Clock::time_point process_start = Clock::now();
+        for (size_t offset = 0; offset < padded; offset += num_frames)
+        {
+            aic::ErrorCode err = processor.process_interleaved(
+                block->audio.data() + offset * channels, channels, num_frames);
+            if (err != aic::ErrorCode::Success)
+            {
+                return err;
+            }
+        }
+
+        // The flushed tail follows the block's own output, which always leaves room for it.
+        size_t         end    = padded;
+        const uint64_t output = written + padded - std::min<uint64_t>(to_skip, padded);
+        if (block->last && output < total_in)
+        {
+            const uint64_t missing = to_skip - std::min<uint64_t>(to_skip, padded) +
+                                     total_in - output;
+            size_t         flushed = 0;
+            aic::ErrorCode err     = flush_tail(processor, context, nullptr,
+                                                block->audio.data() + padded * channels,
+                                                channels, num_frames, missing, flushed);
+            if (err != aic::ErrorCode::Success)
+            {
+                return err;
+            }
+            end += flushed;
+        }
+        process_s += seconds_since(process_start);
+
+        const size_t skipped = static_cast<size_t>(std::min<uint64_t>(to_skip, end));
+        block->first         = skipped;
+        block->frames        = static_cast<size_t>(
+            std::min<uint64_t>(end - skipped, total_in - written));
+        to_skip -= skipped;
+        written += block->frames;
+
+        const bool last = block->last;
+        state.processed.push(block);
+        if (last)
+        {
+            state.processed.close();
+            return aic::ErrorCode::Success;
+        }
+    }
+}
+
+int run_pipe(const Options& options, const aic::Model& model, const std::string& license,
+             aic::SampleFormat format)
+{
+#if defined(_WIN32)
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    auto processor_result = aic::Processor::create(model, license);
+    if (!processor_result.ok())
+    {
+        std::cerr << "Processor creation failed with error code: "
+                  << static_cast<int>(processor_result.error) << "\n";
+        return 1;
+    }
+    aic::Processor processor  = processor_result.take();
+    const size_t   num_frames = model.get_optimal_num_frames(options.rate);
+
+    aic::ErrorCode err = processor.initialize(options.rate, options.channels, num_frames, false);
+    if (err != aic::ErrorCode::Success)
+    {
+        std::cerr << "Processor initialization failed with error code: "
+                  << static_cast<int>(err) << "\n";
+        return 1;
+    }
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        std::cerr << "Context creation failed with error code: "
+                  << static_cast<int>(context_result.error) << "\n";
+        return 1;
+    }
+    aic::ProcessorContext context = context_result.take();
+    if (options.enhancement >= 0.0f)
+    {
+        err = context.set_parameter(aic::ProcessorParameter::EnhancementLevel,
+                                    options.enhancement);
+        if (err != aic::ErrorCode::Success)
+        {
+            std::cerr << "Setting the enhancement level failed with error code: "
+                      << static_cast<int>(err) << "\n";
+            return 1;
+        }
+    }
+    const size_t delay = context.get_output_delay();
+
+    // Three blocks keep every stage busy; the fourth lets the reader run one block ahead. Each
+    // block has room for the flushed tail, whole blocks covering the delay, after the last one.
+    const size_t chunk_frames =
+        (options.buffer_frames + num_frames - 1) / num_frames * num_frames;
+    const size_t tail_frames = (delay + num_frames - 1) / num_frames * num_frames;
+    PipeState              state(format, options.channels, chunk_frames);
+    std::vector<PipeBlock> blocks(4);
+    for (PipeBlock& block : blocks)
+    {
+        block.pcm.resize((chunk_frames + tail_frames) * state.frame_bytes());
+        block.audio.resize((chunk_frames + tail_frames) * options.channels);
+        state.idle.push(&block);
+    }
+
+    uint64_t                total_in  = 0;
+    double                  process_s = 0.0;
+    const Clock::time_point start     = Clock::now();
+    std::thread             reader(read_pipe, std::ref(state));
+    std::thread             writer(write_pipe, std::ref(state));
+    err = process_pipe(state, processor, context, num_frames, total_in, process_s);
+    if (err != aic::ErrorCode::Success)
+    {
+        state.fail("Processing failed with error code: " + std::to_string(static_cast<int>(err)));
+    }
+    reader.join();
+    writer.join();
+    if (state.failed)
+    {
+        std::cerr << state.error << "\n";
+        return 1;
+    }
+
+    // stdout carries the audio, so the report goes to stderr.
+    const double wall_s  = seconds_since(start);
+    const double audio_s = static_cast<double>(total_in) / options.rate;
+    std::cerr << std::fixed << std::setprecision(3);
+    std::cerr << "frames:        " << total_in << " (" << audio_s << " s at " << options.rate
+              << " Hz, " << options.channels << " ch)\n";
+    std::cerr << "block:         " << num_frames << " frames, " << delay
+              << " frames of delay trimmed\n";
+    std::cerr << "wall time:     " << wall_s << " s (" << process_s << " s processing)\n";
+    if (audio_s > 0.0)
+    {
+        std::cerr << std::setprecision(4) << "rtf:           " << wall_s / audio_s << " ("
+                  << std::setprecision(1) << audio_s / std::max(wall_s, 1e-9)
+                  << "x real time)\n";
+    }
+    return 0;
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-process <model_path> <input.wav> <output.wav> "
+                 "[--enhancement LEVEL]\n"
+                 "                   [--sample-format same|int16|int24|int32|float32] "
+                 "[--buffer-frames N]\n"
+                 "                   [--jobs N] [--chunk-seconds S] [--overlap-seconds S] "
+                 "[--crossfade-ms MS]\n"
+                 "                   [--vad trim|csv|json] [--vad-padding-ms MS] "
+                 "[--vad-sensitivity S] [--vad-hold-ms MS]\n"
+                 "       aic-process <model_path> --batch <input_dir|manifest> <output_dir> "
+                 "[--jobs N]\n"
+                 "                   [--enhancement LEVEL] [--sample-format FORMAT] "
+                 "[--buffer-frames N]\n"
+                 "       aic-process <model_path> --pipe s16le|s24le|s32le|f32le --rate HZ "
+                 "--channels N\n"
+                 "                   [--enhancement LEVEL] [--buffer-frames N]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--enhancement" && i + 1 < argc)
+        {
+            options.enhancement = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if (arg == "--sample-format" && i + 1 < argc)
+        {
+            options.sample_format = argv[++i];
+        }
+        else if (arg == "--buffer-frames" && i + 1 < argc)
+        {
+            options.buffer_frames = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--jobs" && i + 1 < argc)
+        {
+            options.jobs = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--chunk-seconds" && i + 1 < argc)
+        {
+            options.chunk_seconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--overlap-seconds" && i + 1 < argc)
+        {
+            options.overlap_seconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--crossfade-ms" && i + 1 < argc)
+        {
+            options.crossfade_ms = std::atof(argv[++i]);
+        }
+        else if (arg == "--batch")
+        {
+            options.batch = true;
+        }
+        else if (arg == "--pipe" && i + 1 < argc)
+        {
+            options.pipe = argv[++i];
+        }
+        else if (arg == "--rate" && i + 1 < argc)
+        {
+            options.rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.channels = static_cast<uint16_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--vad" && i + 1 < argc)
+        {
+            options.vad = argv[++i];
+        }
+        else if (arg == "--vad-padding-ms" && i + 1 < argc)
+        {
+            options.vad_padding_ms = std::atof(argv[++i]);
+        }
+        else if (arg == "--vad-sensitivity" && i + 1 < argc)
+        {
+            options.vad_sensitivity = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if (arg == "--vad-hold-ms" && i + 1 < argc)
+        {
+            options.vad_hold_ms = std::atof(argv[++i]);
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else if (arg[0] != '-' && options.input_path.empty())
+        {
+            options.input_path = arg;
+        }
+        else if (arg[0] != '-' && options.output_path.empty())
+        {
+            options.output_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    aic::SampleFormat output_format = aic::SampleFormat::Float32;
+    aic::SampleFormat pipe_format   = aic::SampleFormat::Float32;
+    if (options.buffer_frames == 0 || options.chunk_seconds <= 0.0 ||
+        options.overlap_seconds < 0.0 || options.crossfade_ms < 0.0 ||
+        !parse_sample_format(options.sample_format, output_format))
+    {
+        return usage();
+    }
+    if (options.pipe.empty() && options.output_path.empty())
+    {
+        return usage();
+    }
+    if (!options.vad.empty() &&
+        ((options.vad != "trim" && options.vad != "csv" && options.vad != "json") ||
+         options.batch || !options.pipe.empty() || options.vad_padding_ms < 0.0))
+    {
+        return usage();
+    }
+    if (!options.pipe.empty() &&
+        (!options.input_path.empty() || options.batch || options.rate == 0 ||
+         options.channels == 0 || !parse_pipe_format(options.pipe, pipe_format)))
+    {
+        return usage();
+    }
+    if (!options.batch && options.pipe.empty() &&
+        same_file(options.input_path, options.output_path))
+    {
+        std::cerr << options.output_path << " is the input file; choose another output path\n";
+        return 1;
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    auto model_result = aic::Model::create_from_file(options.model_path);
+    if (!model_result.ok())
+    {
+        std::cerr << "Model loading failed with error code: "
+                  << static_cast<int>(model_result.error) << "\n";
+        return 1;
+    }
+    aic::Model model = model_result.take();
+
+    if (options.batch)
+    {
+        return run_batch(options, model, license, output_format);
+    }
+    if (!options.pipe.empty())
+    {
+        return run_pipe(options, model, license, pipe_format);
+    }
+
+    auto reader_result = aic::WavReader::create(options.input_path);
+    if (!reader_result.ok())
+    {
+        std::cerr << "Opening " << options.input_path
+                  << " failed with error code: " << static_cast<int>(reader_result.error) << "\n";
+        return 1;
+    }
+    aic::WavReader       reader = reader_result.take();
+    const aic::WavFormat input  = reader.get_format();
+
+    auto processor_result = aic::Processor::create(model, license);
+    if (!processor_result.ok())
+    {
+        std::cerr << "Processor creation failed with error code: "
+                  << static_cast<int>(processor_result.error) << "\n";
+        return 1;
+    }
+    aic::Processor processor  = processor_result.take();
+    const size_t   num_frames = model.get_optimal_num_frames(input.sample_rate);
+
+    aic::ErrorCode err =
+        processor.initialize(input.sample_rate, input.num_channels, num_frames, false);
+    if (err != aic::ErrorCode::Success)
+    {
+        std::cerr << "Processor initialization failed with error code: "
+                  << static_cast<int>(err) << "\n";
+        return 1;
+    }
+
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        std::cerr << "Context creation failed with error code: "
+                  << static_cast<int>(context_result.error) << "\n";
+        return 1;
+    }
+    aic::ProcessorContext context = context_result.take();
+    if (options.enhancement >= 0.0f)
+    {
+        err = context.set_parameter(aic::ProcessorParameter::EnhancementLevel,
+                                    options.enhancement);
+        if (err != aic::ErrorCode::Success)
+        {
+            std::cerr << "Setting the enhancement level failed with error code: "
+                      << static_cast<int>(err) << "\n";
+            return 1;
+        }
+    }
+    const uint64_t delay = context.get_output_delay();
+
+    std::unique_ptr<SpeechTrack> speech;
+    if (!options.vad.empty())
+    {
+        auto vad_result = processor.create_vad_context();
+        if (!vad_result.ok())
+        {
+            std::cerr << "VAD context creation failed with error code: "
+                      << static_cast<int>(vad_result.error) << "\n";
+            return 1;
+        }
+        aic::VadContext vad = vad_result.take();
+        if (options.vad_sensitivity >= 0.0f)
+        {
+            err = vad.set_parameter(aic::VadParameter::Sensitivity, options.vad_sensitivity);
+        }
+        if (err == aic::ErrorCode::Success && options.vad_hold_ms >= 0.0)
+        {
+            err = vad.set_parameter(aic::VadParameter::SpeechHoldDuration,
+                                    static_cast<float>(options.vad_hold_ms / 1000.0));
+        }
+        if (err != aic::ErrorCode::Success)
+        {
+            std::cerr << "Setting a VAD parameter failed with error code: "
+                      << static_cast<int>(err) << "\n";
+            return 1;
+        }
+        const uint64_t padding =
+            static_cast<uint64_t>(options.vad_padding_ms * input.sample_rate / 1000.0);
+        speech.reset(new SpeechTrack(std::move(vad), delay, options.vad == "trim", padding));
+    }
+
+    // With --vad csv or --vad json the output file is the segment list, written at the end.
+    std::unique_ptr<aic::WavWriter> writer;
+    if (options.vad.empty() || options.vad == "trim")
+    {
+        aic::WavFormat output = input;
+        if (options.sample_format != "same")
+        {
+            output.sample_format = output_format;
+        }
+        auto writer_result = aic::WavWriter::create(options.output_path, output);
+        if (!writer_result.ok())
+        {
+            std::cerr << "Creating " << options.output_path << " failed with error code: "
+                      << static_cast<int>(writer_result.error) << "\n";
+            return 1;
+        }
+        writer.reset(new aic::WavWriter(writer_result.take()));
+    }
+
+    bool chunked = options.jobs != 1;
+    if (chunked && speech)
+    {
+        std::cerr << "--vad follows one processor, processing on one thread\n";
+        chunked = false;
+    }
+    if (chunked && reader.get_num_frames() == UINT64_MAX)
+    {
+        std::cerr << "The input's length is unknown, processing on one thread\n";
+        chunked = false;
+    }
+
+    uint64_t                total_in  = 0;
+    double                  process_s = 0.0;
+    const Clock::time_point start     = Clock::now();
+    if (chunked)
+    {
+        err      = run_chunked(options, model, license, reader, *writer, num_frames);
+        total_in = writer->get_num_frames();
+    }
+    else
+    {
+        err = run_streaming(reader, writer.get(), speech.get(), processor, context, num_frames,
+                            options.buffer_frames, total_in, process_s);
+    }
+    if (err != aic::ErrorCode::Success)
+    {
+        std::cerr << "Processing failed with error code: " << static_cast<int>(err) << "\n";
+        return 1;
+    }
+    if (writer)
+    {
+        err = writer->finish();
+    }
+    if (err != aic::ErrorCode::Success)
+    {
+        std::cerr << "Writing failed with error code: " << static_cast<int>(err) << "\n";
+        return 1;
+    }
+
+    std::vector<aic::SpeechSegment> segments;
+    uint64_t                        speech_frames = 0;
+    if (speech)
+    {
+        segments = aic::pad_speech_segments(speech->segmenter.get_segments(), speech->padding,
+                                            total_in);
+        for (const aic::SpeechSegment& segment : segments)
+        {
+            speech_frames += segment.end_frame - segment.first_frame;
+        }
+        if (!writer && !write_segments(options.output_path, options.vad, segments,
+                                       input.sample_rate, total_in, options.vad_padding_ms))
+        {
+            std::cerr << "Writing " << options.output_path << " failed\n";
+            return 1;
+        }
+    }
+    const double wall_s  = seconds_since(start);
+    const double audio_s = static_cast<double>(total_in) / input.sample_rate;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "frames:        " << total_in << " (" << audio_s << " s at "
+              << input.sample_rate << " Hz, " << input.num_channels << " ch)\n";
+    std::cout << "block:         " << num_frames << " frames, " << delay
+              << " frames of delay trimmed\n";
+    if (speech)
+    {
+        std::cout << "speech:        " << segments.size() << " segments, "
+                  << static_cast<double>(speech_frames) / input.sample_rate << " s ("
+                  << std::setprecision(1)
+                  << 100.0 * static_cast<double>(speech_frames) / std::max<uint64_t>(total_in, 1)
+                  << "%) with " << options.vad_padding_ms << " ms padding\n"
+                  << std::setprecision(3);
+    }
+    if (chunked)
+    {
+        std::cout << "chunks:        " << options.chunk_seconds << " s with "
+                  << options.overlap_seconds << " s warm-up, " << options.crossfade_ms
+                  << " ms crossfade\n";
+        std::cout << "wall time:     " << wall_s << " s\n";
+    }
+    else
+    {
+        std::cout << "wall time:     " << wall_s << " s (" << process_s << " s processing)\n";
+    }
+    if (audio_s > 0.0)
+    {
+        std::cout << std::setprecision(4) << "rtf:           " << wall_s / audio_s << " ("
+                  << std::setprecision(1) << audio_s / std::max(wall_s, 1e-9)
+                  << "x real time)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,410 @@
+// Real-time safety check of the wrapper's hot paths.
+//
+// Builds one instance of every real-time stage on a model (Processor with its contexts,
+// StreamAdapter, DryWetMixer, ResamplingStage, PolyphaseResampler, PcmFrontEnd,
+// InstrumentedProcessor, AudioRing, LatencyHistogram and the PCM kernels), then calls each
+// hot-path function repeatedly inside an AIC_RT_CHECK_SCOPE. Every allocation, lock, wait or
+// blocking system call made during those calls is reported with a backtrace, and the tool
+// exits with status 1 if there was any, so it can gate CI jobs.
+//
+// Each function is called --warmup times outside a checked scope first, so state that is
+// allocated lazily on first use is not reported; pass --warmup 0 to check first calls too.
+//
+// Requires a build with -DAIC_SDK_ENABLE_RT_CHECKS=ON; interposition works on Linux/glibc.
+//
+// Usage: aic-rt-check <model_path> [--iterations N] [--warmup N] [--channels N]
+//                     [--host-rate HZ] [--max-reports N]
+//
+// The license key is read from the AIC_SDK_LICENSE environment variable.
+
+#include "aic.hpp"
+#include "aic_audio_ring.hpp"
+#include "aic_latency.hpp"
+#include "aic_mixer.hpp"
+#include "aic_pcm.hpp"
+#include "aic_resampler.hpp"
+#include "aic_rt_check.hpp"
+#include "aic_stream_adapter.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Options
+{
+    std::string model_path;
+    int         iterations  = 100;
+    int         warmup      = 1;
+    uint16_t    channels    = 2;
+    uint32_t    host_rate   = 44100;
+    uint64_t    max_reports = 1;
+};
+
+struct Case
+{
+    std::string           name;
+    std::function<void()> run;
+    uint64_t              violations;
+};
+
+Case*    current_case = nullptr;
+uint64_t max_reports  = 1;
+
+void on_violation(const aic::RtViolation& violation)
+{
+    if (!current_case)
+    {
+        return;
+    }
+    if (current_case->violations++ < max_reports)
+    {
+        std::cerr << "\n" << current_case->name << ":\n";
+        aic::print_rt_violation(violation);
+    }
+}
+
+// Planar scratch audio with interleaved and sequential views of the same size.
+struct Buffers
+{
+    std::vector<float>  planar;
+    std::vector<float*> channels;
+    std::vector<float>  interleaved;
+
+    Buffers(uint16_t num_channels, size_t num_frames)
+        : planar(num_channels * num_frames)
+        , channels(num_channels)
+        , interleaved(num_channels * num_frames)
+    {
+        for (uint16_t ch = 0; ch < num_channels; ++ch)
+        {
+            channels[ch] = planar.data() + ch * num_frames;
+        }
+    }
+};
+
+int fail(const char* what, aic::ErrorCode error)
+{
+    std::cerr << what << " failed with error code: " << static_cast<int>(error) << "\n";
+    return 1;
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-rt-check <model_path> [--iterations N] [--warmup N] "
+                 "[--channels N]\n"
+                 "                    [--host-rate HZ] [--max-reports N]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc)
+        {
+            options.iterations = std::atoi(argv[++i]);
+        }
+        else if (arg == "--warmup" && i + 1 < argc)
+        {
+            options.warmup = std::atoi(argv[++i]);
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.channels = static_cast<uint16_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--host-rate" && i + 1 < argc)
+        {
+            options.host_rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--max-reports" && i + 1 < argc)
+        {
+            options.max_reports = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (options.model_path.empty() || options.iterations <= 0 || options.warmup < 0 ||
+        options.channels == 0 || options.host_rate == 0)
+    {
+        return usage();
+    }
+    if (!aic::is_rt_check_enabled())
+    {
+        std::cerr << "Built without AIC_SDK_ENABLE_RT_CHECKS; nothing would be checked\n";
+        return 1;
+    }
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    // -------- Setup, outside any checked scope --------
+
+    auto model_result = aic::Model::create_from_file(options.model_path);
+    if (!model_result.ok())
+    {
+        return fail("Model loading", model_result.error);
+    }
+    aic::Model model = model_result.take();
+
+    const uint32_t sample_rate  = model.get_optimal_sample_rate();
+    const size_t   num_frames   = model.get_optimal_num_frames(sample_rate);
+    const uint16_t num_channels = options.channels;
+    const size_t   host_frames  = static_cast<size_t>(static_cast<uint64_t>(num_frames) *
+                                                      options.host_rate / sample_rate);
+    const size_t   odd_frames   = num_frames / 3 + 1;
+
+    auto processor_result = aic::Processor::create(model, license);
+    if (!processor_result.ok())
+    {
+        return fail("Processor creation", processor_result.error);
+    }
+    aic::Processor processor = processor_result.take();
+    aic::ErrorCode rc = processor.initialize(sample_rate, num_channels, num_frames, false);
+    if (rc != aic::ErrorCode::Success)
+    {
+        return fail("Processor initialization", rc);
+    }
+
+    auto context_result = processor.create_context();
+    if (!context_result.ok())
+    {
+        return fail("Context creation", context_result.error);
+    }
+    aic::ProcessorContext context = context_result.take();
+
+    auto vad_result = processor.create_vad_context();
+    if (!vad_result.ok())
+    {
+        return fail("VAD context creation", vad_result.error);
+    }
+    aic::VadContext vad = vad_result.take();
+
+    auto adapter_result = aic::StreamAdapter::create(processor, num_frames * 4);
+    if (!adapter_result.ok())
+    {
+        return fail("StreamAdapter creation", adapter_result.error);
+    }
+    aic::StreamAdapter adapter = adapter_result.take();
+
+    auto mixer_result = aic::DryWetMixer::create(processor, 0.5f);
+    if (!mixer_result.ok())
+    {
+        return fail("DryWetMixer creation", mixer_result.error);
+    }
+    aic::DryWetMixer mixer = mixer_result.take();
+
+    auto stage_result = aic::ResamplingStage::create(processor, options.host_rate, host_frames);
+    if (!stage_result.ok())
+    {
+        return fail("ResamplingStage creation", stage_result.error);
+    }
+    aic::ResamplingStage stage = stage_result.take();
+
+    auto resampler_result = aic::PolyphaseResampler::create(sample_rate, options.host_rate,
+                                                            num_channels, num_frames);
+    if (!resampler_result.ok())
+    {
+        return fail("PolyphaseResampler creation", resampler_result.error);
+    }
+    aic::PolyphaseResampler resampler = resampler_result.take();
+
+    auto pcm_result = aic::PcmFrontEnd::create(processor);
+    if (!pcm_result.ok())
+    {
+        return fail("PcmFrontEnd creation", pcm_result.error);
+    }
+    aic::PcmFrontEnd pcm = pcm_result.take();
+
+    auto ring_result = aic::AudioRing::create(num_channels, num_frames * 4);
+    if (!ring_result.ok())
+    {
+        return fail("AudioRing creation", ring_result.error);
+    }
+    aic::AudioRing ring = ring_result.take();
+
+    aic::InstrumentedProcessor instrumented(processor);
+    aic::LatencyHistogram      histogram;
+
+    const size_t max_frames = std::max(num_frames * 4, host_frames);
+    Buffers      audio(num_channels, max_frames);
+    Buffers      resampled(num_channels, resampler.get_max_output_frames(num_frames));
+    std::vector<unsigned char> pcm_bytes(max_frames * num_channels * 8);
+    float*                     planar      = audio.planar.data();
+    float* const*              channels    = audio.channels.data();
+    float*                     interleaved = audio.interleaved.data();
+
+    const aic::SampleFormat formats[] = {aic::SampleFormat::Int16, aic::SampleFormat::Int24,
+                                         aic::SampleFormat::Int32, aic::SampleFormat::Float32,
+                                         aic::SampleFormat::Float64};
+
+    // -------- Hot-path functions --------
+
+    std::vector<Case> cases;
+    auto add = [&cases](const char* name, std::function<void()> run)
+    {
+        Case entry;
+        entry.name       = name;
+        entry.run        = run;
+        entry.violations = 0;
+        cases.push_back(entry);
+    };
+
+    add("Processor::process_planar",
+        [&] { processor.process_planar(channels, num_channels, num_frames); });
+    add("Processor::process_interleaved",
+        [&] { processor.process_interleaved(interleaved, num_channels, num_frames); });
+    add("Processor::process_sequential",
+        [&] { processor.process_sequential(planar, num_channels, num_frames); });
+    add("ProcessorContext::reset", [&] { context.reset(); });
+    add("ProcessorContext::set_parameter",
+        [&] { context.set_parameter(aic::ProcessorParameter::EnhancementLevel, 0.8f); });
+    add("ProcessorContext::get_parameter",
+        [&] { context.get_parameter(aic::ProcessorParameter::EnhancementLevel); });
+    add("ProcessorContext::get_output_delay", [&] { context.get_output_delay(); });
+    add("VadContext::is_speech_detected", [&] { vad.is_speech_detected(); });
+    add("VadContext::set_parameter",
+        [&] { vad.set_parameter(aic::VadParameter::Sensitivity, 6.0f); });
+    add("VadContext::get_parameter", [&] { vad.get_parameter(aic::VadParameter::Sensitivity); });
+
+    add("StreamAdapter::process_planar",
+        [&] { adapter.process_planar(channels, num_channels, odd_frames); });
+    add("StreamAdapter::process_interleaved",
+        [&] { adapter.process_interleaved(interleaved, num_channels, odd_frames); });
+    add("StreamAdapter::process_sequential",
+        [&] { adapter.process_sequential(planar, num_channels, odd_frames); });
+    add("StreamAdapter::reset", [&] { adapter.reset(); });
+
+    add("DryWetMixer::process_planar",
+        [&] { mixer.process_planar(channels, num_channels, num_frames); });
+    add("DryWetMixer::process_interleaved",
+        [&] { mixer.process_interleaved(interleaved, num_channels, num_frames); });
+    add("DryWetMixer::process_sequential",
+        [&] { mixer.process_sequential(planar, num_channels, num_frames); });
+    add("DryWetMixer::set_mix", [&] { mixer.set_mix(0.7f); });
+    add("DryWetMixer::reset", [&] { mixer.reset(); });
+
+    add("ResamplingStage::process_planar",
+        [&] { stage.process_planar(channels, num_channels, host_frames); });
+    add("ResamplingStage::process_interleaved",
+        [&] { stage.process_interleaved(interleaved, num_channels, host_frames); });
+    add("ResamplingStage::process_sequential",
+        [&] { stage.process_sequential(planar, num_channels, host_frames); });
+    add("ResamplingStage::reset", [&] { stage.reset(); });
+    add("ResamplingStage::get_output_delay", [&] { stage.get_output_delay(); });
+
+    add("PolyphaseResampler::process",
+        [&] { resampler.process(channels, 1, num_frames, resampled.channels.data()); });
+    add("PolyphaseResampler::reset", [&] { resampler.reset(); });
+
+    add("PcmFrontEnd::process_interleaved",
+        [&]
+        {
+            for (aic::SampleFormat format : formats)
+            {
+                pcm.process_interleaved(pcm_bytes.data(), format, num_channels, num_frames);
+            }
+        });
+    add("convert_to_float/convert_from_float",
+        [&]
+        {
+            for (aic::SampleFormat format : formats)
+            {
+                aic::convert_to_float(pcm_bytes.data(), format, interleaved,
+                                      num_frames * num_channels);
+                aic::convert_from_float(interleaved, pcm_bytes.data(), format,
+                                        num_frames * num_channels);
+            }
+        });
+    add("deinterleave_to_float/interleave_from_float",
+        [&]
+        {
+            for (aic::SampleFormat format : formats)
+            {
+                aic::deinterleave_to_float(pcm_bytes.data(), format, channels, num_channels,
+                                           num_frames);
+                aic::interleave_from_float(channels, pcm_bytes.data(), format, num_channels,
+                                           num_frames);
+            }
+        });
+
+    add("InstrumentedProcessor::process_planar",
+        [&] { instrumented.process_planar(channels, num_channels, num_frames); });
+    add("InstrumentedProcessor::process_interleaved",
+        [&] { instrumented.process_interleaved(interleaved, num_channels, num_frames); });
+    add("InstrumentedProcessor::process_sequential",
+        [&] { instrumented.process_sequential(planar, num_channels, num_frames); });
+    add("InstrumentedProcessor::set_deadline_fraction",
+        [&] { instrumented.set_deadline_fraction(0.5f); });
+    add("LatencyHistogram::record", [&] { histogram.record(123456); });
+
+    add("AudioRing::write_interleaved/read_interleaved",
+        [&]
+        {
+            ring.write_interleaved(interleaved, num_frames);
+            ring.read_interleaved(interleaved, num_frames);
+        });
+    add("AudioRing::write_planar/read_planar",
+        [&]
+        {
+            ring.write_planar(channels, num_frames);
+            ring.read_planar(channels, num_frames);
+        });
+
+    // -------- Checked runs --------
+
+    max_reports = options.max_reports;
+    aic::set_rt_violation_handler(on_violation);
+
+    uint64_t total = 0;
+    for (Case& entry : cases)
+    {
+        for (int i = 0; i < options.warmup; ++i)
+        {
+            entry.run();
+        }
+        current_case = &entry;
+        for (int i = 0; i < options.iterations; ++i)
+        {
+            AIC_RT_CHECK_SCOPE();
+            entry.run();
+        }
+        current_case = nullptr;
+        total += entry.violations;
+    }
+    aic::set_rt_violation_handler(nullptr);
+
+    std::cout << "\n" << std::left << std::setw(50) << "function" << std::right << std::setw(10)
+              << "calls" << std::setw(12) << "violations" << "\n";
+    for (const Case& entry : cases)
+    {
+        std::cout << std::left << std::setw(50) << entry.name << std::right << std::setw(10)
+                  << options.iterations << std::setw(12) << entry.violations << "\n";
+    }
+    std::cout << "\n"
+              << (total == 0 ? "All hot-path functions are real-time safe"
+                             : "Real-time safety violations found")
+              << " (" << cases.size() << " functions, " << total << " violations)\n";
+    return total == 0 ? 0 : 1;
+}
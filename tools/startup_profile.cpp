@@ -0,0 +1,566 @@
+// Startup-cost profiler: where the time goes between starting a process and the first enhanced
+// block.
+//
+// Every run executes the startup sequence of a fresh stream and measures each phase:
+//
+//   model_load          Model::create_from_file (or create_from_mapped_file with --mapped)
+//   processor_create    Processor::create, including license validation
+//   initialize          Processor::initialize
+//   create_context      Processor::create_context
+//   create_vad_context  Processor::create_vad_context
+//   first_process       first process_interleaved call (cold)
+//   second_process      second call, for comparison with steady state
+//
+// For each phase the tool reports the wall-time distribution over all runs, and the median
+// minor/major page faults and resident-memory growth. Cold runs evict the model file from the
+// page cache first (Linux, posix_fadvise); warm runs follow a run that left it cached.
+// --fresh-process forks a new process for every run so one-time process initialization inside
+// the SDK is part of every sample, like in a freshly started pod.
+//
+// Usage: aic-startup-profile <model_path> [--runs N] [--mapped] [--fresh-process]
+//                            [--rate HZ] [--frames N] [--channels N] [--format table|json]
+//
+// The license key is read from the AIC_SDK_LICENSE environment variable.
+
+#include "aic.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+#endif
+
+namespace
+{
+
+enum Phase
+{
+    ModelLoad,
+    ProcessorCreate,
+    Initialize,
+    CreateContext,
+    CreateVadContext,
+    FirstProcess,
+    SecondProcess,
+    NumPhases
+};
+
+const char* kPhaseNames[NumPhases] = {"model_load",     "processor_create",   "initialize",
+                                      "create_context", "create_vad_context", "first_process",
+                                      "second_process"};
+
+struct Options
+{
+    std::string model_path;
+    int         runs          = 10;
+    bool        mapped        = false;
+    bool        fresh_process = false;
+    uint32_t    sample_rate   = 0;
+    size_t      num_frames    = 0;
+    uint16_t    num_channels  = 1;
+    std::string format        = "table";
+};
+
+// Process counters sampled before and after every phase.
+struct Usage
+{
+    uint64_t ns;
+    int64_t  minor_faults;
+    int64_t  major_faults;
+    int64_t  rss_bytes;
+};
+
+struct PhaseSample
+{
+    double  ms;
+    int64_t minor_faults;
+    int64_t major_faults;
+    int64_t rss_delta;
+};
+
+// Plain data, so forked children can send it through a pipe as-is.
+struct Run
+{
+    int         error;
+    PhaseSample phases[NumPhases];
+};
+
+Usage sample_usage()
+{
+    Usage usage = {};
+    usage.ns    = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        // Windows does not split soft and hard faults.
+        usage.minor_faults = counters.PageFaultCount;
+        usage.rss_bytes    = static_cast<int64_t>(counters.WorkingSetSize);
+    }
+#else
+    rusage self = {};
+    getrusage(RUSAGE_SELF, &self);
+    usage.minor_faults = self.ru_minflt;
+    usage.major_faults = self.ru_majflt;
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info  = {};
+    mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) == KERN_SUCCESS)
+    {
+        usage.rss_bytes = static_cast<int64_t>(info.resident_size);
+    }
+#else
+    std::ifstream statm("/proc/self/statm");
+    int64_t       size = 0, resident = 0;
+    if (statm >> size >> resident)
+    {
+        usage.rss_bytes = resident * sysconf(_SC_PAGESIZE);
+    }
+#endif
+#endif
+    return usage;
+}
+
+PhaseSample delta(const Usage& before, const Usage& after)
+{
+    PhaseSample sample;
+    sample.ms           = static_cast<double>(after.ns - before.ns) / 1e6;
+    sample.minor_faults = after.minor_faults - before.minor_faults;
+    sample.major_faults = after.major_faults - before.major_faults;
+    sample.rss_delta    = after.rss_bytes - before.rss_bytes;
+    return sample;
+}
+
+// Drops the model file from the page cache. Only pages no other process maps are dropped.
+bool evict_from_page_cache(const std::string& path)
+{
+#if defined(__linux__)
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return evicted;
+#else
+    (void) path;
+    return false;
+#endif
+}
+
+// Runs the startup sequence once. Objects are destroyed at the end, outside the measured phases.
+Run run_once(const Options& options, const std::string& license)
+{
+    Run run = {};
+
+    Usage before       = sample_usage();
+    auto  model_result = options.mapped
+                             ? aic::Model::create_from_mapped_file(options.model_path, false)
+                             : aic::Model::create_from_file(options.model_path);
+    Usage after           = sample_usage();
+    run.phases[ModelLoad] = delta(before, after);
+    if (!model_result.ok())
+    {
+        run.error = static_cast<int>(model_result.error);
+        return run;
+    }
+    aic::Model model = model_result.take();
+
+    const uint32_t sample_rate =
+        options.sample_rate ? options.sample_rate : model.get_optimal_sample_rate();
+    const size_t num_frames =
+        options.num_frames ? options.num_frames : model.get_optimal_num_frames(sample_rate);
+
+    before                      = sample_usage();
+    auto processor_result       = aic::Processor::create(model, license);
+    after                       = sample_usage();
+    run.phases[ProcessorCreate] = delta(before, after);
+    if (!processor_result.ok())
+    {
+        run.error = static_cast<int>(processor_result.error);
+        return run;
+    }
+    aic::Processor processor = processor_result.take();
+
+    before = sample_usage();
+    aic::ErrorCode rc =
+        processor.initialize(sample_rate, options.num_channels, num_frames, false);
+    after                  = sample_usage();
+    run.phases[Initialize] = delta(before, after);
+    if (rc != aic::ErrorCode::Success)
+    {
+        run.error = static_cast<int>(rc);
+        return run;
+    }
+
+    before                    = sample_usage();
+    auto context_result       = processor.create_context();
+    after                     = sample_usage();
+    run.phases[CreateContext] = delta(before, after);
+
+    before                       = sample_usage();
+    auto vad_result              = processor.create_vad_context();
+    after                        = sample_usage();
+    run.phases[CreateVadContext] = delta(before, after);
+    if (!context_result.ok() || !vad_result.ok())
+    {
+        run.error = static_cast<int>(!context_result.ok() ? context_result.error
+                                                          : vad_result.error);
+        return run;
+    }
+
+    std::vector<float> audio(num_frames * options.num_channels, 0.0f);
+    const Phase        process_phases[] = {FirstProcess, SecondProcess};
+    for (Phase phase : process_phases)
+    {
+        before = sample_usage();
+        rc     = processor.process_interleaved(audio.data(), options.num_channels, num_frames);
+        after  = sample_usage();
+        run.phases[phase] = delta(before, after);
+        if (rc != aic::ErrorCode::Success)
+        {
+            run.error = static_cast<int>(rc);
+            return run;
+        }
+    }
+    return run;
+}
+
+// Runs the startup sequence in a forked child and collects its samples through a pipe.
+Run run_in_child(const Options& options, const std::string& license)
+{
+    Run run   = {};
+    run.error = static_cast<int>(aic::ErrorCode::InternalError);
+#if defined(_WIN32)
+    (void) options;
+    (void) license;
+#else
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return run;
+    }
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(fds[0]);
+        Run         result = run_once(options, license);
+        const char* data   = reinterpret_cast<const char*>(&result);
+        size_t      sent   = 0;
+        while (sent < sizeof(result))
+        {
+            ssize_t n = write(fds[1], data + sent, sizeof(result) - sent);
+            if (n <= 0)
+            {
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    if (child > 0)
+    {
+        Run    result;
+        char*  data     = reinterpret_cast<char*>(&result);
+        size_t received = 0;
+        while (received < sizeof(result))
+        {
+            ssize_t n = read(fds[0], data + received, sizeof(result) - received);
+            if (n <= 0)
+            {
+                break;
+            }
+            received += static_cast<size_t>(n);
+        }
+        waitpid(child, nullptr, 0);
+        if (received == sizeof(result))
+        {
+            run = result;
+        }
+    }
+    close(fds[0]);
+#endif
+    return run;
+}
+
+template <typename T> T median(std::vector<T> values)
+{
+    std::sort(values.begin(), values.end());
+    return values.empty() ? T() : values[values.size() / 2];
+}
+
+double percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+struct PhaseSummary
+{
+    double  mean_ms;
+    double  min_ms;
+    double  p50_ms;
+    double  p90_ms;
+    double  max_ms;
+    int64_t minor_faults;
+    int64_t major_faults;
+    int64_t rss_delta;
+};
+
+// Summaries for every phase, plus the time to ready (all phases up to the first process call)
+// at index NumPhases.
+std::vector<PhaseSummary> summarize(const std::vector<Run>& runs)
+{
+    std::vector<PhaseSummary> summaries;
+    for (int phase = 0; phase <= NumPhases; ++phase)
+    {
+        std::vector<double>  ms;
+        std::vector<int64_t> minor, major, rss;
+        for (const Run& run : runs)
+        {
+            PhaseSample sample = {};
+            if (phase < NumPhases)
+            {
+                sample = run.phases[phase];
+            }
+            else
+            {
+                for (int p = 0; p <= FirstProcess; ++p)
+                {
+                    sample.ms += run.phases[p].ms;
+                    sample.minor_faults += run.phases[p].minor_faults;
+                    sample.major_faults += run.phases[p].major_faults;
+                    sample.rss_delta += run.phases[p].rss_delta;
+                }
+            }
+            ms.push_back(sample.ms);
+            minor.push_back(sample.minor_faults);
+            major.push_back(sample.major_faults);
+            rss.push_back(sample.rss_delta);
+        }
+
+        PhaseSummary summary = {};
+        for (double value : ms)
+        {
+            summary.mean_ms += value / static_cast<double>(ms.size());
+        }
+        summary.min_ms       = percentile(ms, 0.0);
+        summary.p50_ms       = percentile(ms, 0.5);
+        summary.p90_ms       = percentile(ms, 0.9);
+        summary.max_ms       = percentile(ms, 1.0);
+        summary.minor_faults = median(minor);
+        summary.major_faults = median(major);
+        summary.rss_delta    = median(rss);
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+void print_table(const char* mode, const std::vector<PhaseSummary>& summaries, size_t runs)
+{
+    std::cout << "\n" << mode << " (" << runs << " runs)\n";
+    std::cout << std::left << std::setw(20) << "phase" << std::right << std::setw(10)
+              << "mean ms" << std::setw(10) << "min ms" << std::setw(10) << "p50 ms"
+              << std::setw(10) << "p90 ms" << std::setw(10) << "max ms" << std::setw(11)
+              << "minflt" << std::setw(9) << "majflt" << std::setw(12) << "rss KiB"
+              << "\n";
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+        const PhaseSummary& s = summaries[i];
+        std::cout << std::left << std::setw(20)
+                  << (i < NumPhases ? kPhaseNames[i] : "time_to_ready") << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(10) << s.mean_ms
+                  << std::setw(10) << s.min_ms << std::setw(10) << s.p50_ms << std::setw(10)
+                  << s.p90_ms << std::setw(10) << s.max_ms << std::setw(11) << s.minor_faults
+                  << std::setw(9) << s.major_faults << std::setw(12) << s.rss_delta / 1024
+                  << "\n";
+    }
+}
+
+void print_json(const char* mode, const std::vector<PhaseSummary>& summaries, size_t runs,
+                bool last)
+{
+    std::cout << "    \"" << mode << "\": {\"runs\": " << runs << ", \"phases\": {\n";
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+        const PhaseSummary& s = summaries[i];
+        std::cout << "      \"" << (i < NumPhases ? kPhaseNames[i] : "time_to_ready")
+                  << "\": {" << std::fixed << std::setprecision(3) << "\"mean_ms\": " << s.mean_ms
+                  << ", \"min_ms\": " << s.min_ms << ", \"p50_ms\": " << s.p50_ms
+                  << ", \"p90_ms\": " << s.p90_ms << ", \"max_ms\": " << s.max_ms
+                  << ", \"minor_faults\": " << s.minor_faults
+                  << ", \"major_faults\": " << s.major_faults
+                  << ", \"rss_delta_bytes\": " << s.rss_delta << "}"
+                  << (i + 1 < summaries.size() ? ",\n" : "\n");
+    }
+    std::cout << "    }}" << (last ? "\n" : ",\n");
+}
+
+int usage()
+{
+    std::cerr << "Usage: aic-startup-profile <model_path> [--runs N] [--mapped] "
+                 "[--fresh-process]\n"
+                 "                           [--rate HZ] [--frames N] [--channels N] "
+                 "[--format table|json]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc)
+        {
+            options.runs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--mapped")
+        {
+            options.mapped = true;
+        }
+        else if (arg == "--fresh-process")
+        {
+            options.fresh_process = true;
+        }
+        else if (arg == "--rate" && i + 1 < argc)
+        {
+            options.sample_rate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            options.num_frames = static_cast<size_t>(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--channels" && i + 1 < argc)
+        {
+            options.num_channels = static_cast<uint16_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            options.format = argv[++i];
+        }
+        else if (arg[0] != '-' && options.model_path.empty())
+        {
+            options.model_path = arg;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if (options.model_path.empty() || options.runs <= 0 || options.num_channels == 0 ||
+        (options.format != "table" && options.format != "json"))
+    {
+        return usage();
+    }
+#if defined(_WIN32)
+    if (options.fresh_process)
+    {
+        std::cerr << "--fresh-process is not supported on Windows\n";
+        return 1;
+    }
+#endif
+
+    const char* license = std::getenv("AIC_SDK_LICENSE");
+    if (!license)
+    {
+        std::cerr << "Set the AIC_SDK_LICENSE environment variable\n";
+        return 1;
+    }
+
+    // Cold runs need eviction; without it every run after the first is warm.
+    const bool        can_evict = evict_from_page_cache(options.model_path);
+    std::vector<Run>  cold_runs;
+    std::vector<Run>  warm_runs;
+    const std::string key = license;
+
+    for (int i = 0; i < options.runs; ++i)
+    {
+        if (can_evict)
+        {
+            evict_from_page_cache(options.model_path);
+            Run run = options.fresh_process ? run_in_child(options, key) : run_once(options, key);
+            if (run.error != 0)
+            {
+                std::cerr << "Cold run failed with error code: " << run.error << "\n";
+                return 1;
+            }
+            cold_runs.push_back(run);
+        }
+
+        Run run = options.fresh_process ? run_in_child(options, key) : run_once(options, key);
+        if (run.error != 0)
+        {
+            std::cerr << "Warm run failed with error code: " << run.error << "\n";
+            return 1;
+        }
+        warm_runs.push_back(run);
+    }
+
+    if (options.format == "json")
+    {
+        std::cout << "{\n  \"sdk_version\": \"" << aic::get_sdk_version()
+                  << "\",\n  \"fresh_process\": " << (options.fresh_process ? "true" : "false")
+                  << ",\n  \"modes\": {\n";
+        if (!cold_runs.empty())
+        {
+            print_json("cold", summarize(cold_runs), cold_runs.size(), false);
+        }
+        print_json("warm", summarize(warm_runs), warm_runs.size(), true);
+        std::cout << "  }\n}\n";
+        return 0;
+    }
+
+    std::cout << "SDK " << aic::get_sdk_version() << ", "
+              << (options.fresh_process ? "new process per run" : "all runs in one process")
+              << ", model " << (options.mapped ? "memory-mapped" : "read from file") << "\n";
+    if (!can_evict)
+    {
+        std::cout << "Cold-cache runs skipped: cannot evict the model file from the page cache "
+                     "on this platform\n";
+    }
+    else
+    {
+        print_table("cold page cache", summarize(cold_runs), cold_runs.size());
+    }
+    print_table("warm page cache", summarize(warm_runs), warm_runs.size());
+    std::cout << "\ntime_to_ready sums all phases up to and including first_process. Page faults "
+                 "and RSS growth are medians.\n";
+    return 0;
+}